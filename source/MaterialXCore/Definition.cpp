@@ -33,43 +33,17 @@ const string Implementation::LANGUAGE_ATTRIBUTE = "language";
 
 InterfaceElementPtr NodeDef::getImplementation(const string& target, const string& language) const
 {
-    vector<InterfaceElementPtr> interfaces = getDocument()->getMatchingImplementations(getQualifiedName(getName()));
-    vector<InterfaceElementPtr> secondary = getDocument()->getMatchingImplementations(getName());
-    interfaces.insert(interfaces.end(), secondary.begin(), secondary.end());
-
-    // Search for the first implementation which matches a given language string.
-    // If no language is specified then return the first implementation found.
-    bool matchLanguage = !language.empty();
-    for (InterfaceElementPtr interface : interfaces)
+    // Check for a memoized result of this lookup.
+    ConstDocumentPtr doc = getDocument();
+    InterfaceElementPtr result;
+    if (doc->findCachedImplementation(*this, target, language, result))
     {
-        ImplementationPtr implement = interface->asA<Implementation>();
-        if (!implement||
-            !targetStringsMatch(interface->getTarget(), target) ||
-            !isVersionCompatible(interface))
-        {
-            continue;
-        }
-        if (!matchLanguage || 
-            implement->getLanguage() == language)
-        {
-            return interface;
-        }
-    }
-
-    // Search for a node graph match if no implementation match was found.
-    // There is no language check as node graphs are considered to be language independent.
-    for (InterfaceElementPtr interface : interfaces)
-    {
-        if (interface->isA<Implementation>() || 
-            !targetStringsMatch(interface->getTarget(), target) ||
-            !isVersionCompatible(interface))
-        {
-            continue;
-        }
-        return interface;
+        return result;
     }
 
-    return InterfaceElementPtr();
+    result = findImplementation(target, language);
+    doc->cacheImplementation(*this, target, language, result);
+    return result;
 }
 
 vector<ShaderRefPtr> NodeDef::getInstantiatingShaderRefs() const
@@ -121,6 +95,47 @@ ConstNodeDefPtr NodeDef::getDeclaration(const string&) const
     return getSelf()->asA<NodeDef>();
 }
 
+InterfaceElementPtr NodeDef::findImplementation(const string& target, const string& language) const
+{
+    vector<InterfaceElementPtr> interfaces = getDocument()->getMatchingImplementations(getQualifiedName(getName()));
+    vector<InterfaceElementPtr> secondary = getDocument()->getMatchingImplementations(getName());
+    interfaces.insert(interfaces.end(), secondary.begin(), secondary.end());
+
+    // Search for the first implementation which matches a given language string.
+    // If no language is specified then return the first implementation found.
+    bool matchLanguage = !language.empty();
+    for (InterfaceElementPtr interface : interfaces)
+    {
+        ImplementationPtr implement = interface->asA<Implementation>();
+        if (!implement||
+            !targetStringsMatch(interface->getTarget(), target) ||
+            !isVersionCompatible(interface))
+        {
+            continue;
+        }
+        if (!matchLanguage || 
+            implement->getLanguage() == language)
+        {
+            return interface;
+        }
+    }
+
+    // Search for a node graph match if no implementation match was found.
+    // There is no language check as node graphs are considered to be language independent.
+    for (InterfaceElementPtr interface : interfaces)
+    {
+        if (interface->isA<Implementation>() || 
+            !targetStringsMatch(interface->getTarget(), target) ||
+            !isVersionCompatible(interface))
+        {
+            continue;
+        }
+        return interface;
+    }
+
+    return InterfaceElementPtr();
+}
+
 //
 // Implementation methods
 //
@@ -123,6 +123,8 @@ class NodeDef : public InterfaceElement
     /// @return An implementation for this nodedef, or an empty shared pointer
     ///    if none was found.  Note that a node implementation may be either
     ///    an Implementation element or a NodeGraph element.
+    /// @details Results are memoized per target and language in the cache of
+    ///    the owning document, and are discarded whenever the document changes.
     InterfaceElementPtr getImplementation(const string& target = EMPTY_STRING, 
                                           const string& language = EMPTY_STRING) const;
 
@@ -156,6 +158,11 @@ class NodeDef : public InterfaceElement
 
     /// @}
 
+  protected:
+    // Search the document for the first implementation matching the given
+    // target and language, bypassing the document's lookup cache.
+    InterfaceElementPtr findImplementation(const string& target, const string& language) const;
+
   public:
     static const string CATEGORY;
     static const string NODE_ATTRIBUTE;
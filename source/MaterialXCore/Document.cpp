@@ -7,7 +7,10 @@
 
 #include <MaterialXCore/Util.h>
 
+#include <cstdint>
 #include <mutex>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace MaterialX
 {
@@ -31,6 +34,447 @@ template<class T> shared_ptr<T> updateChildSubclass(ElementPtr parent, ElementPt
     return newChild;
 }
 
+// Upgrade steps are identified by the minor version from which they upgrade
+// an element.  Each step edits only the given element and its direct
+// children, so that a range of steps may be applied in a single traversal
+// of the document.
+const int FIRST_IN_PLACE_VERSION = 26;
+
+bool hasChildOfCategory(const ElementPtr& elem, const string& category)
+{
+    for (const ElementPtr& child : elem->getChildren())
+    {
+        if (child->getCategory() == category)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool requiresInPlaceUpgrade(const ElementPtr& child)
+{
+    const string& category = child->getCategory();
+    if (category == "opgraph" || category == "shader")
+    {
+        return true;
+    }
+    ParameterPtr param = child->asA<Parameter>();
+    return param && param->getType() == "opgraphnode";
+}
+
+const SubstringReplacer& getFilenameTokenReplacer()
+{
+    static const SubstringReplacer replacer = []()
+    {
+        SubstringReplacer tokens;
+        tokens.setSubstitution("%UDIM", UDIM_TOKEN);
+        tokens.setSubstitution("%UVTILE", UV_TILE_TOKEN);
+        return tokens;
+    }();
+    return replacer;
+}
+
+// Upgrade the value string of the given element from v1.35 to v1.36.
+void upgradeValueString(const ValueElementPtr& valueElem)
+{
+    const string& type = valueElem->getType();
+    const string& value = valueElem->getValueString();
+    if (type == GEOMNAME_TYPE_STRING && value == "*")
+    {
+        valueElem->setValueString(UNIVERSAL_GEOM_NAME);
+    }
+    else if (type == FILENAME_TYPE_STRING && value.find('%') != string::npos)
+    {
+        string newValue = getFilenameTokenReplacer().replace(value);
+        if (newValue != value)
+        {
+            valueElem->setValueString(newValue);
+        }
+    }
+}
+
+// Apply the in-place upgrade from v1.26 to v1.34 to the children of the
+// given element.  Connected parameters are typed by their upstream nodes,
+// so all earlier upgrade steps must have been applied to the document.
+void upgradeChildrenInPlace(const ElementPtr& elem)
+{
+    bool requiresUpgrade = false;
+    for (const ElementPtr& child : elem->getChildren())
+    {
+        if (requiresInPlaceUpgrade(child))
+        {
+            requiresUpgrade = true;
+            break;
+        }
+    }
+    if (!requiresUpgrade)
+    {
+        return;
+    }
+
+    vector<ElementPtr> origChildren = elem->getChildren();
+    for (ElementPtr child : origChildren)
+    {
+        if (child->getCategory() == "opgraph")
+        {
+            updateChildSubclass<NodeGraph>(elem, child);
+        }
+        else if (child->getCategory() == "shader")
+        {
+            NodeDefPtr nodeDef = updateChildSubclass<NodeDef>(elem, child);
+            if (nodeDef->hasAttribute("shadertype"))
+            {
+                nodeDef->setType(SURFACE_SHADER_TYPE_STRING);
+                nodeDef->removeAttribute("shadertype");
+            }
+            if (nodeDef->hasAttribute("shaderprogram"))
+            {
+                nodeDef->setNodeString(nodeDef->getAttribute("shaderprogram"));
+                nodeDef->removeAttribute("shaderprogram");
+            }
+        }
+        else if (child->isA<Parameter>())
+        {
+            ParameterPtr param = child->asA<Parameter>();
+            if (param->getType() == "opgraphnode")
+            {
+                if (elem->isA<Node>())
+                {
+                    InputPtr input = updateChildSubclass<Input>(elem, param);
+                    input->setNodeName(input->getAttribute("value"));
+                    input->removeAttribute("value");
+
+                    // Resolve the connection by name rather than through the
+                    // connection index of the graph, which may be shared
+                    // with concurrent upgrades of sibling subtrees.
+                    ConstGraphElementPtr graph = input->getAncestorOfType<GraphElement>();
+                    NodePtr connectedNode = graph ? graph->getNode(input->getNodeName()) : nullptr;
+                    if (connectedNode)
+                    {
+                        input->setType(connectedNode->getType());
+                    }
+                    else
+                    {
+                        input->setType(getTypeString<Color3>());
+                    }
+                }
+                else if (elem->isA<Output>())
+                {
+                    if (child->getName() == "in")
+                    {
+                        elem->setAttribute("nodename", child->getAttribute("value"));
+                    }
+                    elem->removeChild(child->getName());
+                }
+            }
+        }
+    }
+}
+
+// Apply the upgrade steps from the given start version up to, but not
+// including, the given end version to a single element.  Material overrides
+// reference upgraded nodedefs elsewhere in the document, so their upgrade
+// from v1.35 is deferred to upgradeMaterialOverrides.
+void upgradeElement(const ElementPtr& elem, int startVersion, int endVersion)
+{
+    auto hasStep = [startVersion, endVersion](int version)
+    {
+        return startVersion <= version && version < endVersion;
+    };
+
+    TypedElementPtr typedElem = elem->asA<TypedElement>();
+    ValueElementPtr valueElem = typedElem ? typedElem->asA<ValueElement>() : nullptr;
+
+    // Upgrade from v1.22 to v1.23
+    if (hasStep(22) && typedElem && typedElem->getType() == "vector")
+    {
+        typedElem->setType(getTypeString<Vector3>());
+    }
+
+    // Upgrade from v1.23 to v1.24
+    if (hasStep(23))
+    {
+        if (elem->getCategory() == "shader" && elem->hasAttribute("shadername"))
+        {
+            elem->setAttribute(NodeDef::NODE_ATTRIBUTE, elem->getAttribute("shadername"));
+            elem->removeAttribute("shadername");
+        }
+        if (hasChildOfCategory(elem, "assign"))
+        {
+            vector<ElementPtr> origChildren = elem->getChildren();
+            for (ElementPtr child : origChildren)
+            {
+                if (child->getCategory() == "assign")
+                {
+                    updateChildSubclass<MaterialAssign>(elem, child);
+                }
+            }
+        }
+    }
+
+    // Upgrade from v1.24 to v1.25
+    if (hasStep(24) && elem->isA<Input>() && elem->hasAttribute("graphname"))
+    {
+        elem->setAttribute("opgraph", elem->getAttribute("graphname"));
+        elem->removeAttribute("graphname");
+    }
+
+    // Upgrade from v1.25 to v1.26
+    if (hasStep(25) && elem->getCategory() == "constant")
+    {
+        ElementPtr param = elem->getChild("color");
+        if (param)
+        {
+            param->setName("value");
+        }
+    }
+
+    // Upgrade from v1.26 to v1.34
+    if (hasStep(FIRST_IN_PLACE_VERSION))
+    {
+        upgradeChildrenInPlace(elem);
+    }
+
+    // Upgrade from v1.34 to v1.35
+    if (hasStep(34))
+    {
+        if (typedElem && typedElem->getType() == "matrix")
+        {
+            typedElem->setType(getTypeString<Matrix44>());
+        }
+        if (valueElem && valueElem->hasAttribute("default"))
+        {
+            valueElem->setValueString(elem->getAttribute("default"));
+            valueElem->removeAttribute("default");
+        }
+        MaterialAssignPtr matAssign = elem->asA<MaterialAssign>();
+        if (matAssign)
+        {
+            matAssign->setMaterial(matAssign->getName());
+        }
+    }
+
+    // Upgrade from v1.35 to v1.36
+    if (hasStep(35))
+    {
+        if (valueElem)
+        {
+            upgradeValueString(valueElem);
+        }
+
+        bool isMaterial = elem->isA<Material>();
+        bool isLook = !isMaterial && elem->isA<Look>();
+        if ((isMaterial && hasChildOfCategory(elem, "materialinherit")) ||
+            (isLook && hasChildOfCategory(elem, "lookinherit")))
+        {
+            vector<ElementPtr> origChildren = elem->getChildren();
+            for (ElementPtr child : origChildren)
+            {
+                if (isMaterial && child->getCategory() == "materialinherit")
+                {
+                    elem->setInheritString(child->getAttribute("material"));
+                    elem->removeChild(child->getName());
+                }
+                else if (isLook && child->getCategory() == "lookinherit")
+                {
+                    elem->setInheritString(child->getAttribute("look"));
+                    elem->removeChild(child->getName());
+                }
+            }
+        }
+    }
+}
+
+// Convert the override elements of the given material from v1.35 to bind
+// elements on its shader references.
+void upgradeMaterialOverrides(const MaterialPtr& material)
+{
+    if (!hasChildOfCategory(material, "override"))
+    {
+        return;
+    }
+
+    vector<ElementPtr> origChildren = material->getChildren();
+    for (ElementPtr child : origChildren)
+    {
+        if (child->getCategory() != "override")
+        {
+            continue;
+        }
+        for (ShaderRefPtr shaderRef : material->getShaderRefs())
+        {
+            NodeDefPtr nodeDef = shaderRef->getNodeDef();
+            if (nodeDef)
+            {
+                for (ValueElementPtr activeValue : nodeDef->getActiveValueElements())
+                {
+                    if (activeValue->getAttribute("publicname") == child->getName() &&
+                        !shaderRef->getChild(child->getName()))
+                    {
+                        ValueElementPtr bind;
+                        if (activeValue->isA<Parameter>())
+                        {
+                            bind = shaderRef->addBindParam(activeValue->getName(), activeValue->getType());
+                        }
+                        else if (activeValue->isA<Input>())
+                        {
+                            bind = shaderRef->addBindInput(activeValue->getName(), activeValue->getType());
+                        }
+                        if (bind)
+                        {
+                            bind->setValueString(child->getAttribute("value"));
+                            upgradeValueString(bind);
+                        }
+                    }
+                }
+            }
+        }
+        material->removeChild(child->getName());
+    }
+}
+
+// A key for memoized implementation lookups.
+struct ImplementationKey
+{
+    const NodeDef* nodeDef;
+    string target;
+    string language;
+
+    bool operator==(const ImplementationKey& rhs) const
+    {
+        return nodeDef == rhs.nodeDef &&
+               target == rhs.target &&
+               language == rhs.language;
+    }
+};
+
+struct ImplementationKeyHash
+{
+    size_t operator()(const ImplementationKey& key) const
+    {
+        std::hash<string> hasher;
+        size_t hash = std::hash<const NodeDef*>()(key.nodeDef);
+        hash ^= hasher(key.target) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        hash ^= hasher(key.language) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        return hash;
+    }
+};
+
+// A key for cached string resolvers.  Elements are keyed by address, and
+// each entry holds weak references to its elements, so that an entry is
+// not returned for a new element allocated at the address of a freed one.
+struct StringResolverKey
+{
+    const Element* scope;
+    string geom;
+    const Element* material;
+    string target;
+    string type;
+
+    bool operator==(const StringResolverKey& rhs) const
+    {
+        return scope == rhs.scope &&
+               geom == rhs.geom &&
+               material == rhs.material &&
+               target == rhs.target &&
+               type == rhs.type;
+    }
+};
+
+struct StringResolverKeyHash
+{
+    size_t operator()(const StringResolverKey& key) const
+    {
+        std::hash<string> hasher;
+        size_t hash = std::hash<const Element*>()(key.scope);
+        hash ^= hasher(key.geom) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        hash ^= std::hash<const Element*>()(key.material) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        hash ^= hasher(key.target) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        hash ^= hasher(key.type) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        return hash;
+    }
+};
+
+// A cached string resolver, with the elements for which it was created.
+struct StringResolverEntry
+{
+    std::weak_ptr<const Element> scope;
+    std::weak_ptr<const Element> material;
+    ConstStringResolverPtr resolver;
+
+    // Return true if the entry was created for the given elements.
+    bool matches(const Element& scopeElem, const ConstMaterialPtr& materialElem) const
+    {
+        return scope.lock().get() == &scopeElem &&
+               material.lock() == materialElem;
+    }
+};
+
+// The active geometry paths of a geominfo element.
+using GeomInfoPaths = vector<std::pair<vector<GeomPath>, GeomInfoPtr>>;
+
+vector<GeomPath> createGeomPaths(const string& geom)
+{
+    vector<GeomPath> paths;
+    for (const string& name : splitString(geom, ARRAY_VALID_SEPARATORS))
+    {
+        paths.push_back(GeomPath(name));
+    }
+    return paths;
+}
+
+// The validation result for a single top-level element.
+struct ValidationResult
+{
+    ValidationResult() :
+        valid(true)
+    {
+    }
+
+    bool valid;
+    string message;
+};
+
+// Return true if edits to the given attribute may affect the validity of
+// elements other than the one being edited.
+bool isReferenceAttribute(const string& attrib)
+{
+    static const std::unordered_set<string> REFERENCE_ATTRIBUTES =
+    {
+        Element::NAME_ATTRIBUTE,
+        Element::INHERIT_ATTRIBUTE,
+        Element::NAMESPACE_ATTRIBUTE,
+        Element::TARGET_ATTRIBUTE,
+        Element::VERSION_ATTRIBUTE,
+        Element::DEFAULT_VERSION_ATTRIBUTE,
+        TypedElement::TYPE_ATTRIBUTE,
+        ValueElement::INTERFACE_NAME_ATTRIBUTE,
+        PortElement::NODE_NAME_ATTRIBUTE,
+        PortElement::OUTPUT_ATTRIBUTE,
+        InterfaceElement::NODE_DEF_ATTRIBUTE,
+        Input::DEFAULT_GEOM_PROP_ATTRIBUTE,
+        NodeDef::NODE_ATTRIBUTE,
+        TypeDef::SEMANTIC_ATTRIBUTE,
+        BindInput::NODE_GRAPH_ATTRIBUTE,
+        GeomElement::COLLECTION_ATTRIBUTE,
+        Collection::INCLUDE_COLLECTION_ATTRIBUTE
+    };
+    return REFERENCE_ATTRIBUTES.count(attrib) != 0;
+}
+
+// Return the number of bytes held by the given hashed container with string
+// keys, including the heap storage of its keys.
+template<class T> size_t getKeyedHeapBytes(const T& container)
+{
+    size_t bytes = getHashedHeapBytes(container);
+    for (const auto& pair : container)
+    {
+        bytes += getHeapBytes(pair.first);
+    }
+    return bytes;
+}
+
 } // anonymous namespace
 
 //
@@ -50,11 +494,30 @@ class Document::Cache
 {
   public:
     Cache() :
-        valid(false)
+        valid(false),
+        resolversValid(false)
     {
     }
     ~Cache() { }
 
+    void invalidate()
+    {
+        valid = false;
+        resolversValid = false;
+    }
+
+    // Discard stale resolver entries.  The resolver mutex must be held.
+    void refreshResolvers()
+    {
+        if (!resolversValid)
+        {
+            resolverMap.clear();
+            geomTokenMap.clear();
+            geomInfoPaths.reset();
+            resolversValid = true;
+        }
+    }
+
     void refresh()
     {
         // Thread synchronization for multiple concurrent readers of a single document.
@@ -66,9 +529,12 @@ class Document::Cache
             portElementMap.clear();
             nodeDefMap.clear();
             implementationMap.clear();
+            implementationLookupMap.clear();
 
             // Traverse the document to build a new cache.
-            for (ElementPtr elem : doc.lock()->traverseTree())
+            DocumentPtr document = doc.lock();
+            TreeWalker walker;
+            for (Element* elem = walker.begin(document.get()); elem; elem = walker.next())
             {
                 const string& nodeName = elem->getAttribute(PortElement::NODE_NAME_ATTRIBUTE);
                 const string& nodeString = elem->getAttribute(NodeDef::NODE_ATTRIBUTE);
@@ -76,32 +542,31 @@ class Document::Cache
 
                 if (!nodeName.empty())
                 {
-                    PortElementPtr portElem = elem->asA<PortElement>();
+                    PortElement* portElem = dynamic_cast<PortElement*>(elem);
                     if (portElem)
                     {
                         portElementMap.insert(std::pair<string, PortElementPtr>(
                             portElem->getQualifiedName(nodeName),
-                            portElem));
+                            elem->getSelf()->asA<PortElement>()));
                     }
                 }
                 if (!nodeString.empty())
                 {
-                    NodeDefPtr nodeDef = elem->asA<NodeDef>();
+                    NodeDef* nodeDef = dynamic_cast<NodeDef*>(elem);
                     if (nodeDef)
                     {
                         nodeDefMap.insert(std::pair<string, NodeDefPtr>(
                             nodeDef->getQualifiedName(nodeString),
-                            nodeDef));
+                            elem->getSelf()->asA<NodeDef>()));
                     }
                 }
                 if (!nodeDefString.empty())
                 {
-                    InterfaceElementPtr interface = elem->asA<InterfaceElement>();
-                    if (interface && (interface->isA<Implementation>() || interface->isA<NodeGraph>()))
+                    if (dynamic_cast<Implementation*>(elem) || dynamic_cast<NodeGraph*>(elem))
                     {
                         implementationMap.insert(std::pair<string, InterfaceElementPtr>(
-                            interface->getQualifiedName(nodeDefString),
-                            interface));
+                            elem->getQualifiedName(nodeDefString),
+                            elem->getSelf()->asA<InterfaceElement>()));
                     }
                 }
             }
@@ -110,6 +575,39 @@ class Document::Cache
         }
     }
 
+    // Return the number of bytes held by the cache.
+    size_t getMemoryBytes()
+    {
+        size_t bytes = sizeof(Cache);
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            bytes += getKeyedHeapBytes(portElementMap) +
+                     getKeyedHeapBytes(nodeDefMap) +
+                     getKeyedHeapBytes(implementationMap) +
+                     getHashedHeapBytes(implementationLookupMap);
+            for (const auto& pair : implementationLookupMap)
+            {
+                bytes += getHeapBytes(pair.first.target) + getHeapBytes(pair.first.language);
+            }
+        }
+        {
+            std::lock_guard<std::mutex> guard(resolverMutex);
+            bytes += getHashedHeapBytes(resolverMap) + getKeyedHeapBytes(geomTokenMap);
+            for (const auto& pair : resolverMap)
+            {
+                bytes += sizeof(StringResolver) +
+                         getHeapBytes(pair.first.geom) +
+                         getHeapBytes(pair.first.target) +
+                         getHeapBytes(pair.first.type);
+            }
+            if (geomInfoPaths)
+            {
+                bytes += getHeapBytes(*geomInfoPaths);
+            }
+        }
+        return bytes;
+    }
+
   public:
     weak_ptr<Document> doc;
     std::mutex mutex;
@@ -117,6 +615,201 @@ class Document::Cache
     std::unordered_multimap<string, PortElementPtr> portElementMap;
     std::unordered_multimap<string, NodeDefPtr> nodeDefMap;
     std::unordered_multimap<string, InterfaceElementPtr> implementationMap;
+    std::unordered_map<ImplementationKey, InterfaceElementPtr, ImplementationKeyHash> implementationLookupMap;
+
+    // String resolvers are cached independently of the maps above, so that
+    // resolver lookups never trigger a traversal of the document.
+    std::mutex resolverMutex;
+    bool resolversValid;
+    std::unordered_map<StringResolverKey, StringResolverEntry, StringResolverKeyHash> resolverMap;
+    std::unordered_map<string, shared_ptr<const StringMap>> geomTokenMap;
+    shared_ptr<const GeomInfoPaths> geomInfoPaths;
+};
+
+//
+// Document validation state
+//
+
+class Document::ValidationState
+{
+  public:
+    ValidationState() :
+        allDirty(true)
+    {
+    }
+    ~ValidationState() { }
+
+  public:
+    std::mutex mutex;
+    bool allDirty;
+    vector<const Element*> children;
+    vector<ValidationResult> results;
+    std::unordered_set<const Element*> dirtyChildren;
+};
+
+//
+// Document name path index
+//
+
+class Document::NamePathIndex
+{
+  public:
+    NamePathIndex() { }
+    ~NamePathIndex() { }
+
+    // Return true if the given element is indexed at its current name path.
+    bool contains(ConstElementPtr elem) const
+    {
+        auto range = elements.equal_range(getPathHash(elem.get()).value);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            if (it->second == elem)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Return the element indexed at the given name path, or an empty shared
+    // pointer if no element is indexed at this path.
+    ElementPtr find(const string& namePath) const
+    {
+        auto range = elements.equal_range(PathHash().append(namePath).value);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            if (hasNamePath(it->second.get(), namePath))
+            {
+                return it->second;
+            }
+        }
+        return ElementPtr();
+    }
+
+    // Add the given element and its descendants to the index.
+    void addTree(ElementPtr root)
+    {
+        addTree(root, getPathHash(root->getParentRaw()).append(root->getName()));
+    }
+
+    // Remove the given element and its descendants from the index.
+    void removeTree(ElementPtr root)
+    {
+        removeTree(root.get(), getPathHash(root->getParentRaw()).append(root->getName()));
+    }
+
+    // Re-index the given element and its descendants for a new name of
+    // the given element.
+    void renameTree(ElementPtr root, const string& name)
+    {
+        PathHash parentHash = getPathHash(root->getParentRaw());
+        removeTree(root.get(), parentHash.append(root->getName()));
+        addTree(root, parentHash.append(name));
+    }
+
+  private:
+    // An incremental FNV-1a hash of a name path, which is extended by one
+    // name at a time.
+    struct PathHash
+    {
+        PathHash() :
+            value(14695981039346656037ULL),
+            empty(true)
+        {
+        }
+
+        PathHash append(const string& name) const
+        {
+            PathHash result;
+            result.value = value;
+            result.empty = false;
+            if (!empty)
+            {
+                result.add(NAME_PATH_SEPARATOR);
+            }
+            result.add(name);
+            return result;
+        }
+
+        void add(const string& str)
+        {
+            for (unsigned char c : str)
+            {
+                value = (value ^ c) * 1099511628211ULL;
+            }
+        }
+
+        uint64_t value;
+        bool empty;
+    };
+
+    // Return the hash of the name path of the given element, as returned
+    // by getNamePath.
+    static PathHash getPathHash(const Element* elem)
+    {
+        if (!elem || !elem->getParentRaw())
+        {
+            return PathHash();
+        }
+        return getPathHash(elem->getParentRaw()).append(elem->getName());
+    }
+
+    // Return true if the given element has the given name path, comparing
+    // the names of the element and its ancestors with the path in place.
+    static bool hasNamePath(const Element* elem, const string& namePath)
+    {
+        size_t pos = namePath.size();
+        for (; elem && elem->getParentRaw(); elem = elem->getParentRaw())
+        {
+            const string& name = elem->getName();
+            if (pos < name.size() || namePath.compare(pos - name.size(), name.size(), name) != 0)
+            {
+                return false;
+            }
+            pos -= name.size();
+            if (elem->getParentRaw()->getParentRaw())
+            {
+                const size_t separatorSize = NAME_PATH_SEPARATOR.size();
+                if (pos < separatorSize || namePath.compare(pos - separatorSize, separatorSize, NAME_PATH_SEPARATOR) != 0)
+                {
+                    return false;
+                }
+                pos -= separatorSize;
+            }
+        }
+        return pos == 0;
+    }
+
+    void addTree(const ElementPtr& elem, const PathHash& hash)
+    {
+        elements.emplace(hash.value, elem);
+        for (const ElementPtr& child : elem->getChildren())
+        {
+            addTree(child, hash.append(child->getName()));
+        }
+    }
+
+    void removeTree(const Element* elem, const PathHash& hash)
+    {
+        auto range = elements.equal_range(hash.value);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            if (it->second.get() == elem)
+            {
+                elements.erase(it);
+                break;
+            }
+        }
+        for (const ElementPtr& child : elem->getChildren())
+        {
+            removeTree(child.get(), hash.append(child->getName()));
+        }
+    }
+
+  public:
+    // Elements keyed by the hashes of their name paths.  Paths are not
+    // stored, since they are recovered from the element hierarchy.
+    std::unordered_multimap<uint64_t, ElementPtr> elements;
 };
 
 //
@@ -125,7 +818,10 @@ class Document::Cache
 
 Document::Document(ElementPtr parent, const string& name) :
     GraphElement(parent, CATEGORY, name),
-    _cache(std::unique_ptr<Cache>(new Cache))
+    _cache(std::unique_ptr<Cache>(new Cache)),
+    _validationState(std::unique_ptr<ValidationState>(new ValidationState)),
+    _notificationsSuspended(false),
+    _transaction(nullptr)
 {
 }
 
@@ -258,181 +954,310 @@ vector<InterfaceElementPtr> Document::getMatchingImplementations(const string& n
     return implementations;
 }
 
-bool Document::validate(string* message) const
+bool Document::findCachedImplementation(const NodeDef& nodeDef, const string& target, const string& language,
+                                        InterfaceElementPtr& implementation) const
+{
+    // Refresh the cache.
+    _cache->refresh();
+
+    std::lock_guard<std::mutex> guard(_cache->mutex);
+    auto it = _cache->implementationLookupMap.find(ImplementationKey{ &nodeDef, target, language });
+    if (it == _cache->implementationLookupMap.end())
+    {
+        return false;
+    }
+    implementation = it->second;
+    return true;
+}
+
+void Document::cacheImplementation(const NodeDef& nodeDef, const string& target, const string& language,
+                                   InterfaceElementPtr implementation) const
+{
+    std::lock_guard<std::mutex> guard(_cache->mutex);
+    if (_cache->valid)
+    {
+        _cache->implementationLookupMap[ImplementationKey{ &nodeDef, target, language }] = implementation;
+    }
+}
+
+ConstStringResolverPtr Document::getCachedStringResolver(const Element& scope, const string& geom,
+                                                         ConstMaterialPtr material, const string& target,
+                                                         const string& type) const
+{
+    StringResolverKey key{ &scope, geom, material.get(), target, type };
+    {
+        std::lock_guard<std::mutex> guard(_cache->resolverMutex);
+        _cache->refreshResolvers();
+        auto it = _cache->resolverMap.find(key);
+        if (it != _cache->resolverMap.end() && it->second.matches(scope, material))
+        {
+            return it->second.resolver;
+        }
+    }
+
+    // Create the resolver without holding the lock, since resolving the
+    // tokens of geometry and material elements may request other resolvers.
+    StringResolverEntry entry;
+    entry.scope = scope.getSelf();
+    entry.material = material;
+    entry.resolver = scope.createStringResolver(geom, material, target, type);
+
+    std::lock_guard<std::mutex> guard(_cache->resolverMutex);
+    if (_cache->resolversValid)
+    {
+        // Replace any stale entry for elements previously at these addresses.
+        _cache->resolverMap[key] = entry;
+    }
+    return entry.resolver;
+}
+
+shared_ptr<const StringMap> Document::getGeomTokenSubstitutions(const string& geom) const
+{
+    shared_ptr<const GeomInfoPaths> geomInfoPaths;
+    {
+        std::lock_guard<std::mutex> guard(_cache->resolverMutex);
+        _cache->refreshResolvers();
+        auto it = _cache->geomTokenMap.find(geom);
+        if (it != _cache->geomTokenMap.end())
+        {
+            return it->second;
+        }
+        geomInfoPaths = _cache->geomInfoPaths;
+    }
+
+    // Parse the active geometry of each geominfo once per document edit.
+    if (!geomInfoPaths)
+    {
+        shared_ptr<GeomInfoPaths> newPaths = std::make_shared<GeomInfoPaths>();
+        for (GeomInfoPtr geomInfo : getGeomInfos())
+        {
+            newPaths->push_back(std::make_pair(createGeomPaths(geomInfo->getActiveGeom()), geomInfo));
+        }
+        geomInfoPaths = newPaths;
+        std::lock_guard<std::mutex> guard(_cache->resolverMutex);
+        if (_cache->resolversValid && !_cache->geomInfoPaths)
+        {
+            _cache->geomInfoPaths = geomInfoPaths;
+        }
+    }
+
+    // Tokens of later geominfos take precedence over earlier ones.
+    vector<GeomPath> queryPaths = createGeomPaths(geom);
+    shared_ptr<StringMap> substitutions = std::make_shared<StringMap>();
+    for (const auto& pair : *geomInfoPaths)
+    {
+        bool matching = false;
+        for (const GeomPath& infoPath : pair.first)
+        {
+            for (const GeomPath& queryPath : queryPaths)
+            {
+                if (queryPath.isMatching(infoPath))
+                {
+                    matching = true;
+                    break;
+                }
+            }
+            if (matching)
+                break;
+        }
+        if (!matching)
+            continue;
+        for (TokenPtr token : pair.second->getTokens())
+        {
+            (*substitutions)["<" + token->getName() + ">"] = token->getResolvedValueString();
+        }
+    }
+
+    std::lock_guard<std::mutex> guard(_cache->resolverMutex);
+    if (_cache->resolversValid)
+    {
+        _cache->geomTokenMap.insert(std::make_pair(geom, substitutions));
+    }
+    return substitutions;
+}
+
+void Document::invalidateStringResolvers() const
+{
+    _cache->resolversValid = false;
+}
+
+bool Document::validate(string* message) const
+{
+    bool res = true;
+    validateRequire(hasVersionString(), res, message, "Missing version string");
+    return GraphElement::validate(message) && res;
+}
+
+bool Document::validateParallel(string* message, unsigned int threadCount) const
+{
+    return validateChildren(message, threadCount, false);
+}
+
+bool Document::validateIncremental(string* message, unsigned int threadCount) const
 {
-    bool res = true;
-    validateRequire(hasVersionString(), res, message, "Missing version string");
-    return GraphElement::validate(message) && res;
+    return validateChildren(message, threadCount, true);
 }
 
-void Document::upgradeVersion()
+bool Document::validateChildren(string* message, unsigned int threadCount, bool incremental) const
 {
-    std::pair<int, int> versions = getVersionIntegers();
-    int majorVersion = versions.first;
-    int minorVersion = versions.second;
-    if (majorVersion == MATERIALX_MAJOR_VERSION &&
-        minorVersion == MATERIALX_MINOR_VERSION)
-    {
-        return;
-    }
+    vector<ElementPtr> children = getChildren();
+    vector<ValidationResult> results(children.size());
+    vector<size_t> pending;
 
-    // Upgrade from v1.22 to v1.23
-    if (majorVersion == 1 && minorVersion == 22)
+    // Determine which top-level children require validation.
+    std::unique_lock<std::mutex> lock(_validationState->mutex, std::defer_lock);
+    if (incremental)
     {
-        for (ElementPtr elem : traverseTree())
+        lock.lock();
+        ValidationState& state = *_validationState;
+        bool reuse = !state.allDirty && state.children.size() == children.size();
+        for (size_t i = 0; i < children.size() && reuse; i++)
         {
-            if (elem->isA<TypedElement>())
-            {
-                TypedElementPtr typedElem = elem->asA<TypedElement>();
-                if (typedElem->getType() == "vector")
-                {
-                    typedElem->setType(getTypeString<Vector3>());
-                }
-            }
+            reuse = state.children[i] == children[i].get();
         }
-        minorVersion = 23;
-    }
-
-    // Upgrade from v1.23 to v1.24
-    if (majorVersion == 1 && minorVersion == 23)
-    {
-        for (ElementPtr elem : traverseTree())
+        for (size_t i = 0; i < children.size(); i++)
         {
-            if (elem->getCategory() == "shader" && elem->hasAttribute("shadername"))
+            if (reuse && !state.dirtyChildren.count(children[i].get()))
             {
-                elem->setAttribute(NodeDef::NODE_ATTRIBUTE, elem->getAttribute("shadername"));
-                elem->removeAttribute("shadername");
+                results[i] = state.results[i];
             }
-            vector<ElementPtr> origChildren = elem->getChildren();
-            for (ElementPtr child : origChildren)
+            else
             {
-                if (child->getCategory() == "assign")
-                {
-                    updateChildSubclass<MaterialAssign>(elem, child);
-                }
+                pending.push_back(i);
             }
         }
-        minorVersion = 24;
+    }
+    else
+    {
+        for (size_t i = 0; i < children.size(); i++)
+        {
+            pending.push_back(i);
+        }
     }
 
-    // Upgrade from v1.24 to v1.25
-    if (majorVersion == 1 && minorVersion == 24)
+    // Validate each pending child into its own result.  Messages are always
+    // stored in incremental mode, so that they may be reported by later calls.
+    bool storeMessages = message || incremental;
+    parallelFor(pending.size(), [&](size_t i)
+    {
+        ValidationResult& result = results[pending[i]];
+        result.valid = children[pending[i]]->validate(storeMessages ? &result.message : nullptr);
+    }, threadCount);
+
+    // Merge results in the order of a serial call to Document::validate.
+    bool res = true;
+    validateRequire(hasVersionString(), res, message, "Missing version string");
+    validateRequire(isValidName(getName()), res, message, "Invalid element name");
+    if (hasInheritString())
+    {
+        bool validInherit = getInheritsFrom() && getInheritsFrom()->getCategory() == getCategory();
+        validateRequire(validInherit, res, message, "Invalid element inheritance");
+    }
+    for (const ValidationResult& result : results)
     {
-        for (ElementPtr elem : traverseTree())
+        if (message)
         {
-            if (elem->isA<Input>() && elem->hasAttribute("graphname"))
-            {
-                elem->setAttribute("opgraph", elem->getAttribute("graphname"));
-                elem->removeAttribute("graphname");
-            }
+            *message += result.message;
         }
-        minorVersion = 25;
+        res = result.valid && res;
     }
+    validateRequire(!hasInheritanceCycle(), res, message, "Cycle in element inheritance chain");
 
-    // Upgrade from v1.25 to v1.26
-    if (majorVersion == 1 && minorVersion == 25)
+    // Store results for the next incremental validation.
+    if (incremental)
     {
-        for (ElementPtr elem : traverseTree())
+        ValidationState& state = *_validationState;
+        state.allDirty = false;
+        state.children.clear();
+        for (const ElementPtr& child : children)
         {
-            if (elem->getCategory() == "constant")
-            {
-                ElementPtr param = elem->getChild("color");
-                if (param)
-                {
-                    param->setName("value");
-                }
-            }
+            state.children.push_back(child.get());
         }
-        minorVersion = 26;
+        state.results = std::move(results);
+        state.dirtyChildren.clear();
+    }
+
+    return res;
+}
+
+void Document::upgradeVersion(unsigned int threadCount)
+{
+    std::pair<int, int> versions = getVersionIntegers();
+    int majorVersion = versions.first;
+    int minorVersion = versions.second;
+    if (majorVersion == MATERIALX_MAJOR_VERSION &&
+        minorVersion == MATERIALX_MINOR_VERSION)
+    {
+        return;
+    }
+    if (majorVersion != 1 || minorVersion < 22 || minorVersion > 35 ||
+        (minorVersion > FIRST_IN_PLACE_VERSION && minorVersion < 34))
+    {
+        return;
+    }
+
+    // Parallel upgrades suspend per-edit notifications, so present the full
+    // upgrade to observers as a single update.
+    DocumentPtr doc = getDocument();
+    std::unique_ptr<ScopedUpdate> update;
+    if (threadCount != 1)
+    {
+        update = std::unique_ptr<ScopedUpdate>(new ScopedUpdate(doc));
+    }
+
+    // Upgrade from v1.22 to v1.26 in a single traversal.
+    if (minorVersion < FIRST_IN_PLACE_VERSION)
+    {
+        upgradeElements(minorVersion, FIRST_IN_PLACE_VERSION, threadCount);
+        minorVersion = FIRST_IN_PLACE_VERSION;
     }
 
     // Upgrade from v1.26 to v1.34
-    if (majorVersion == 1 && minorVersion == 26)
+    if (minorVersion == FIRST_IN_PLACE_VERSION)
     {
         // Upgrade elements in place.
-        for (ElementPtr elem : traverseTree())
+        upgradeElements(FIRST_IN_PLACE_VERSION, FIRST_IN_PLACE_VERSION + 1, threadCount);
+
+        // Assign nodedef names to shaderrefs, resolving all nodedefs before
+        // the document is edited.
+        vector<std::pair<ShaderRefPtr, NodeDefPtr>> shaderRefs;
+        for (MaterialPtr mat : getMaterials())
         {
-            vector<ElementPtr> origChildren = elem->getChildren();
-            for (ElementPtr child : origChildren)
+            for (ShaderRefPtr shaderRef : mat->getShaderRefs())
             {
-                if (child->getCategory() == "opgraph")
-                {
-                    updateChildSubclass<NodeGraph>(elem, child);
-                }
-                else if (child->getCategory() == "shader")
-                {
-                    NodeDefPtr nodeDef = updateChildSubclass<NodeDef>(elem, child);
-                    if (nodeDef->hasAttribute("shadertype"))
-                    {
-                        nodeDef->setType(SURFACE_SHADER_TYPE_STRING);
-                        nodeDef->removeAttribute("shadertype");
-                    }
-                    if (nodeDef->hasAttribute("shaderprogram"))
-                    {
-                        nodeDef->setNodeString(nodeDef->getAttribute("shaderprogram"));
-                        nodeDef->removeAttribute("shaderprogram");
-                    }
-                }
-                else if (child->isA<Parameter>())
-                {
-                    ParameterPtr param = child->asA<Parameter>();
-                    if (param->getType() == "opgraphnode")
-                    {
-                        if (elem->isA<Node>())
-                        {
-                            InputPtr input = updateChildSubclass<Input>(elem, param);
-                            input->setNodeName(input->getAttribute("value"));
-                            input->removeAttribute("value");
-                            if (input->getConnectedNode())
-                            {
-                                input->setType(input->getConnectedNode()->getType());
-                            }
-                            else
-                            {
-                                input->setType(getTypeString<Color3>());
-                            }
-                        }
-                        else if (elem->isA<Output>())
-                        {
-                            if (child->getName() == "in")
-                            {
-                                elem->setAttribute("nodename", child->getAttribute("value"));
-                            }
-                            elem->removeChild(child->getName());
-                        }
-                    }
-               }
+                shaderRefs.emplace_back(shaderRef, shaderRef->getNodeDef());
             }
         }
-
-        // Assign nodedef names to shaderrefs.
-        for (MaterialPtr mat : getMaterials())
+        std::unordered_map<const NodeDef*, vector<ShaderRefPtr>> nodeDefShaderRefs;
+        for (auto& pair : shaderRefs)
         {
-            for (ShaderRefPtr shaderRef : mat->getShaderRefs())
+            if (!pair.second)
             {
-                if (!shaderRef->getNodeDef())
+                pair.second = getNodeDef(pair.first->getName());
+                if (pair.second)
                 {
-                    NodeDefPtr nodeDef = getNodeDef(shaderRef->getName());
-                    if (nodeDef)
-                    {
-                        shaderRef->setNodeDefString(nodeDef->getName());
-                    }
+                    pair.first->setNodeDefString(pair.second->getName());
                 }
             }
+            if (pair.second)
+            {
+                nodeDefShaderRefs[pair.second.get()].push_back(pair.first);
+            }
         }
 
         // Move connections from nodedef inputs to bindinputs.
         for (NodeDefPtr nodeDef : getNodeDefs())
         {
+            auto it = nodeDefShaderRefs.find(nodeDef.get());
             for (InputPtr input : nodeDef->getActiveInputs())
             {
                 if (input->hasAttribute("opgraph") && input->hasAttribute("graphoutput"))
                 {
-                    for (MaterialPtr mat : getMaterials())
+                    if (it != nodeDefShaderRefs.end())
                     {
-                        for (ShaderRefPtr shaderRef : mat->getShaderRefs())
+                        for (ShaderRefPtr shaderRef : it->second)
                         {
-                            if (shaderRef->getNodeDef() == nodeDef && !shaderRef->getChild(input->getName()))
+                            if (!shaderRef->getChild(input->getName()))
                             {
                                 BindInputPtr bind = shaderRef->addBindInput(input->getName(), input->getType());
                                 bind->setNodeGraphString(input->getAttribute("opgraph"));
@@ -481,138 +1306,320 @@ void Document::upgradeVersion()
         minorVersion = 34;
     }
 
-    // Upgrade from v1.34 to v1.35
-    if (majorVersion == 1 && minorVersion == 34)
+    // Upgrade from v1.34 to v1.36 in a single traversal, followed by the
+    // conversion of material overrides.
+    if (minorVersion == 34 || minorVersion == 35)
     {
-        for (ElementPtr elem : traverseTree())
+        upgradeElements(minorVersion, 36, threadCount);
+        for (MaterialPtr material : getMaterials())
         {
-            TypedElementPtr typedElem = elem->asA<TypedElement>();
-            ValueElementPtr valueElem = elem->asA<ValueElement>();
-            MaterialAssignPtr matAssign = elem->asA<MaterialAssign>();
-            if (typedElem && typedElem->getType() == "matrix")
-            {
-                typedElem->setType(getTypeString<Matrix44>());
-            }
-            if (valueElem && valueElem->hasAttribute("default"))
-            {
-                valueElem->setValueString(elem->getAttribute("default"));
-                valueElem->removeAttribute("default");
-            }
-            if (matAssign)
-            {
-                matAssign->setMaterial(matAssign->getName());
-            }
+            upgradeMaterialOverrides(material);
         }
-        minorVersion = 35;
+        minorVersion = 36;
     }
 
-    // Upgrade from v1.35 to v1.36
-    if (majorVersion == 1 && minorVersion == 35)
+    if (majorVersion == MATERIALX_MAJOR_VERSION &&
+        minorVersion == MATERIALX_MINOR_VERSION)
+    {
+        setVersionString(DOCUMENT_VERSION_STRING);
+    }
+}
+
+void Document::upgradeElements(int startVersion, int endVersion, unsigned int threadCount)
+{
+    // Upgrade the document element, which may replace top-level children.
+    upgradeElement(getSelf(), startVersion, endVersion);
+
+    const vector<ElementPtr>& children = getChildren();
+    auto upgradeSubtree = [&children, startVersion, endVersion](size_t index)
     {
-        for (ElementPtr elem : traverseTree())
+        for (ElementPtr elem : children[index]->traverseTree())
         {
-            ValueElementPtr valueElem = elem->asA<ValueElement>();
-            MaterialPtr material = elem->asA<Material>();
-            LookPtr look = elem->asA<Look>();
-            GeomInfoPtr geomInfo = elem->asA<GeomInfo>();
+            upgradeElement(elem, startVersion, endVersion);
+        }
+    };
+    if (threadCount == 1 || children.size() < 2 || _transaction)
+    {
+        for (size_t i = 0; i < children.size(); i++)
+        {
+            upgradeSubtree(i);
+        }
+        return;
+    }
 
-            if (valueElem)
-            {
-                if (valueElem->getType() == GEOMNAME_TYPE_STRING &&
-                    valueElem->getValueString() == "*")
-                {
-                    valueElem->setValueString(UNIVERSAL_GEOM_NAME);
-                }
-                if (valueElem->getType() == FILENAME_TYPE_STRING)
-                {
-                    StringMap stringMap;
-                    stringMap["%UDIM"] = UDIM_TOKEN;
-                    stringMap["%UVTILE"] = UV_TILE_TOKEN;
-                    valueElem->setValueString(replaceSubstrings(valueElem->getValueString(), stringMap));
-                }
-            }
+    // Upgrade steps edit only the subtree being traversed, so top-level
+    // subtrees may be upgraded concurrently.  Document callbacks are not
+    // thread-safe, so they are suspended, and the state they maintain is
+    // refreshed once all subtrees have been upgraded.
+    _notificationsSuspended = true;
+    try
+    {
+        parallelFor(children.size(), upgradeSubtree, threadCount);
+    }
+    catch (...)
+    {
+        _notificationsSuspended = false;
+        refreshSuspendedState();
+        throw;
+    }
+    _notificationsSuspended = false;
+    refreshSuspendedState();
+}
 
-            vector<ElementPtr> origChildren = elem->getChildren();
-            for (ElementPtr child : origChildren)
-            {
-                if (material && child->getCategory() == "override")
-                {
-                    for (ShaderRefPtr shaderRef : material->getShaderRefs())
-                    {
-                        NodeDefPtr nodeDef = shaderRef->getNodeDef();
-                        if (nodeDef)
-                        {
-                            for (ValueElementPtr activeValue : nodeDef->getActiveValueElements())
-                            {
-                                if (activeValue->getAttribute("publicname") == child->getName() &&
-                                    !shaderRef->getChild(child->getName()))
-                                {
-                                    if (activeValue->isA<Parameter>())
-                                    {
-                                        BindParamPtr bindParam = shaderRef->addBindParam(activeValue->getName(), activeValue->getType());
-                                        bindParam->setValueString(child->getAttribute("value"));
-                                    }
-                                    else if (activeValue->isA<Input>())
-                                    {
-                                        BindInputPtr bindInput = shaderRef->addBindInput(activeValue->getName(), activeValue->getType());
-                                        bindInput->setValueString(child->getAttribute("value"));
-                                    }
-                                }
-                            }
-                        }
-                    }
-                    elem->removeChild(child->getName());
-                }
-                else if (material && child->getCategory() == "materialinherit")
-                {
-                    elem->setInheritString(child->getAttribute("material"));
-                    elem->removeChild(child->getName());
-                }
-                else if (look && child->getCategory() == "lookinherit")
-                {
-                    elem->setInheritString(child->getAttribute("look"));
-                    elem->removeChild(child->getName());
-                }
-            }
+void Document::refreshSuspendedState()
+{
+    _cache->invalidate();
+    invalidateValidation(nullptr);
+    for (ElementPtr elem : traverseTree())
+    {
+        GraphElementPtr graph = elem->asA<GraphElement>();
+        if (graph)
+        {
+            graph->invalidateConnectionIndex();
         }
-        minorVersion = 36;
     }
+    if (_namePathIndex)
+    {
+        _namePathIndex.reset();
+        setNamePathIndexEnabled(true);
+    }
+}
 
-    if (majorVersion == MATERIALX_MAJOR_VERSION &&
-        minorVersion == MATERIALX_MINOR_VERSION)
+DocumentMemoryStats Document::getMemoryStats() const
+{
+    DocumentMemoryStats stats;
+
+    // Count the content of each element, tracking the number of copies of
+    // each heap-allocated string.
+    std::unordered_map<string, size_t> stringCounts;
+    auto countString = [&stringCounts](const string& str)
     {
-        setVersionString(DOCUMENT_VERSION_STRING);
+        size_t bytes = getHeapBytes(str);
+        if (bytes)
+        {
+            stringCounts[str]++;
+        }
+        return bytes;
+    };
+    for (ElementPtr elem : traverseTree())
+    {
+        stats.elementCount++;
+        stats.categoryCounts[elem->_category]++;
+
+        // Elements are allocated together with their reference counts.
+        stats.elementBytes += sizeof(Element) + 3 * sizeof(void*);
+        stats.nameBytes += countString(elem->_name) +
+                           getHeapBytes(elem->_category) +
+                           getHeapBytes(elem->_sourceUri);
+
+        stats.attributeCount += elem->_attributeMap.size();
+        for (const auto& pair : elem->_attributeMap)
+        {
+            stats.attributeKeyBytes += countString(pair.first);
+            stats.attributeValueBytes += countString(pair.second);
+        }
+        for (const string& attrib : elem->_attributeOrder)
+        {
+            stats.attributeKeyBytes += countString(attrib);
+        }
+        stats.attributeMapBytes += getHashedHeapBytes(elem->_attributeMap) +
+                                   getHeapBytes(elem->_attributeOrder);
+        stats.childMapBytes += getKeyedHeapBytes(elem->_childMap);
+        stats.childOrderBytes += getHeapBytes(elem->_childOrder);
+        stats.scopeCacheBytes += elem->getScopeCacheBytes();
+
+        GraphElementPtr graph = elem->asA<GraphElement>();
+        if (graph)
+        {
+            stats.cacheBytes += graph->getConnectionIndexBytes();
+        }
+    }
+    for (const auto& pair : stringCounts)
+    {
+        stats.duplicateStringBytes += (pair.second - 1) * getHeapBytes(pair.first);
+    }
+
+    // Count the caches and indices of the document.
+    stats.cacheBytes += _cache->getMemoryBytes();
+    {
+        std::lock_guard<std::mutex> guard(_validationState->mutex);
+        const ValidationState& state = *_validationState;
+        stats.cacheBytes += sizeof(ValidationState) +
+                            getHeapBytes(state.children) +
+                            getHeapBytes(state.results) +
+                            getHashedHeapBytes(state.dirtyChildren);
+        for (const ValidationResult& result : state.results)
+        {
+            stats.cacheBytes += getHeapBytes(result.message);
+        }
+    }
+    if (_namePathIndex)
+    {
+        stats.cacheBytes += sizeof(NamePathIndex) + getHashedHeapBytes(_namePathIndex->elements);
+    }
+
+    return stats;
+}
+
+void Document::setNamePathIndexEnabled(bool enable)
+{
+    if (!enable)
+    {
+        _namePathIndex.reset();
+        return;
+    }
+    if (!_namePathIndex)
+    {
+        _namePathIndex = std::unique_ptr<NamePathIndex>(new NamePathIndex);
+        for (ElementPtr child : getChildren())
+        {
+            _namePathIndex->addTree(child);
+        }
+    }
+}
+
+ElementPtr Document::getIndexedElement(const string& namePath) const
+{
+    return _namePathIndex->find(namePath);
+}
+
+void Document::invalidateGraphConnections(ConstElementPtr elem) const
+{
+    ConstGraphElementPtr graph = elem ? elem->getAncestorOfType<GraphElement>() : nullptr;
+    if (graph)
+    {
+        graph->invalidateConnectionIndex();
+    }
+}
+
+void Document::invalidateValidation(ConstElementPtr elem, const string& attrib) const
+{
+    std::lock_guard<std::mutex> guard(_validationState->mutex);
+    ValidationState& state = *_validationState;
+    if (state.allDirty)
+    {
+        return;
+    }
+
+    // Edits to the document itself, and edits to attributes that are
+    // referenced by other elements, require a full validation.
+    if (!elem || elem.get() == this || isReferenceAttribute(attrib))
+    {
+        state.allDirty = true;
+        return;
+    }
+
+    // Flag the top-level ancestor of the edited element.
+    ConstElementPtr parent = elem->getParent();
+    while (parent && parent.get() != this)
+    {
+        elem = parent;
+        parent = elem->getParent();
+    }
+    if (!parent)
+    {
+        state.allDirty = true;
+        return;
+    }
+    state.dirtyChildren.insert(elem.get());
+}
+
+void Document::invalidateValidation(ConstElementPtr elem, const string& attrib, const string& value) const
+{
+    if (value != elem->getAttribute(attrib) || !elem->hasAttribute(attrib))
+    {
+        invalidateValidation(elem, attrib);
     }
 }
 
-void Document::onAddElement(ElementPtr, ElementPtr)
+void Document::onAddElement(ElementPtr parent, ElementPtr elem)
 {
-    _cache->valid = false;
+    _cache->invalidate();
+    invalidateValidation(nullptr);
+
+    // New elements carry no connections of their own, but a new node may
+    // resolve existing connections by name.  Subtrees restored by a
+    // transaction may carry connections of their own.
+    if (elem->isA<Node>() ||
+        elem->hasAttribute(PortElement::NODE_NAME_ATTRIBUTE) ||
+        !elem->getChildren().empty())
+    {
+        invalidateGraphConnections(parent);
+    }
+
+    if (_namePathIndex && (parent.get() == this || _namePathIndex->contains(parent)))
+    {
+        _namePathIndex->addTree(elem);
+    }
 }
 
-void Document::onRemoveElement(ElementPtr, ElementPtr)
+void Document::onRemoveElement(ElementPtr parent, ElementPtr elem)
 {
-    _cache->valid = false;
+    _cache->invalidate();
+    invalidateValidation(nullptr);
+    invalidateGraphConnections(parent);
+
+    if (_namePathIndex && _namePathIndex->contains(elem))
+    {
+        _namePathIndex->removeTree(elem);
+    }
 }
 
-void Document::onSetAttribute(ElementPtr, const string&, const string&)
+void Document::onSetAttribute(ElementPtr elem, const string& attrib, const string& value)
 {
-    _cache->valid = false;
+    _cache->invalidate();
+    invalidateValidation(elem, attrib, value);
+
+    if (attrib == PortElement::NODE_NAME_ATTRIBUTE)
+    {
+        PortElementPtr port = elem->asA<PortElement>();
+        ConstGraphElementPtr graph = port ? port->getAncestorOfType<GraphElement>() : nullptr;
+        if (graph)
+        {
+            graph->updateConnectionIndex(port, value);
+        }
+    }
+    else if (attrib == NAME_ATTRIBUTE)
+    {
+        if (elem->isA<Node>())
+        {
+            invalidateGraphConnections(elem->getParent());
+        }
+        if (_namePathIndex && _namePathIndex->contains(elem))
+        {
+            _namePathIndex->renameTree(elem, value);
+        }
+    }
 }
 
-void Document::onRemoveAttribute(ElementPtr, const string&)
+void Document::onRemoveAttribute(ElementPtr elem, const string& attrib)
 {
-    _cache->valid = false;
+    _cache->invalidate();
+    invalidateValidation(elem, attrib);
+
+    if (attrib == PortElement::NODE_NAME_ATTRIBUTE)
+    {
+        PortElementPtr port = elem->asA<PortElement>();
+        ConstGraphElementPtr graph = port ? port->getAncestorOfType<GraphElement>() : nullptr;
+        if (graph)
+        {
+            graph->updateConnectionIndex(port, EMPTY_STRING);
+        }
+    }
 }
 
-void Document::onCopyContent(ElementPtr)
+void Document::onCopyContent(ElementPtr elem)
 {
-    _cache->valid = false;
+    _cache->invalidate();
+    invalidateValidation(nullptr);
+    invalidateGraphConnections(elem);
 }
 
-void Document::onClearContent(ElementPtr)
+void Document::onClearContent(ElementPtr elem)
 {
-    _cache->valid = false;
+    _cache->invalidate();
+    invalidateValidation(nullptr);
+    invalidateGraphConnections(elem);
 }
 
 } // namespace MaterialX
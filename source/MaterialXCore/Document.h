@@ -16,16 +16,155 @@
 #include <MaterialXCore/Node.h>
 #include <MaterialXCore/Variant.h>
 
+#include <map>
+
 namespace MaterialX
 {
 
 class Document;
+class DocumentChange;
+class DocumentTransaction;
 
 /// A shared pointer to a Document
 using DocumentPtr = shared_ptr<Document>;
 /// A shared pointer to a const Document
 using ConstDocumentPtr = shared_ptr<const Document>;
 
+/// A coalesced set of document changes
+using DocumentChangeSet = vector<DocumentChange>;
+
+/// @class DocumentChange
+/// A single change within a coalesced set of document changes.
+///
+/// Changes are reported with respect to the state of the document at the
+/// time they are delivered, so each element and attribute appears at most
+/// once within a change set.
+class DocumentChange
+{
+  public:
+    enum Type
+    {
+        TypeAddElement = 0,
+        TypeRemoveElement = 1,
+        TypeSetAttribute = 2,
+        TypeRemoveAttribute = 3,
+        TypeReorderChildren = 4
+    };
+
+  public:
+    DocumentChange(Type type, ElementPtr element, const string& attribute = EMPTY_STRING) :
+        _type(type),
+        _element(element),
+        _attribute(attribute)
+    {
+    }
+    ~DocumentChange() { }
+
+    /// Return the type of this change.
+    Type getType() const
+    {
+        return _type;
+    }
+
+    /// Return the element to which this change applies.  For added and
+    /// removed elements, Element::getParent returns the parent element.
+    ElementPtr getElement() const
+    {
+        return _element;
+    }
+
+    /// Return the name of the attribute to which this change applies, or
+    /// an empty string for changes to elements and child orders.
+    const string& getAttribute() const
+    {
+        return _attribute;
+    }
+
+  private:
+    Type _type;
+    ElementPtr _element;
+    string _attribute;
+};
+
+/// @class DocumentMemoryStats
+/// Statistics on the memory used by a document, as returned by
+/// Document::getMemoryStats.
+///
+/// Byte counts are estimates, computed from the sizes of the objects and
+/// containers that store document data, and exclude allocator overhead.
+class DocumentMemoryStats
+{
+  public:
+    DocumentMemoryStats() :
+        elementCount(0),
+        elementBytes(0),
+        nameBytes(0),
+        attributeCount(0),
+        attributeKeyBytes(0),
+        attributeValueBytes(0),
+        attributeMapBytes(0),
+        childMapBytes(0),
+        childOrderBytes(0),
+        scopeCacheBytes(0),
+        cacheBytes(0),
+        duplicateStringBytes(0)
+    {
+    }
+    ~DocumentMemoryStats() { }
+
+    /// Return the total number of bytes used by the document.
+    size_t getTotalBytes() const
+    {
+        return elementBytes + nameBytes + attributeKeyBytes + attributeValueBytes +
+               attributeMapBytes + childMapBytes + childOrderBytes + scopeCacheBytes + cacheBytes;
+    }
+
+  public:
+    /// The number of elements in the document, including the document itself.
+    size_t elementCount;
+
+    /// The number of elements of each category.
+    std::map<string, size_t> categoryCounts;
+
+    /// Bytes in element objects and their reference counts.
+    size_t elementBytes;
+
+    /// Heap bytes in element names, categories, and source URIs.
+    size_t nameBytes;
+
+    /// The number of attributes stored on elements.
+    size_t attributeCount;
+
+    /// Heap bytes in attribute names, across attribute maps and orders.
+    size_t attributeKeyBytes;
+
+    /// Heap bytes in attribute values.
+    size_t attributeValueBytes;
+
+    /// Bytes in the entries and buckets of attribute maps, and in attribute
+    /// order vectors.
+    size_t attributeMapBytes;
+
+    /// Bytes in child maps, including their keys.
+    size_t childMapBytes;
+
+    /// Bytes in child order vectors.
+    size_t childOrderBytes;
+
+    /// Bytes in the cached scopes and name paths of elements.
+    size_t scopeCacheBytes;
+
+    /// Bytes in the lookup caches and indices of the document, including
+    /// cached string resolvers, validation state, the name path index, and
+    /// graph connection indices.
+    size_t cacheBytes;
+
+    /// Heap bytes in name and attribute strings that duplicate the content
+    /// of another such string in the document.  These bytes are included
+    /// in the totals above.
+    size_t duplicateStringBytes;
+};
+
 /// @class Document
 /// A MaterialX document, which represents the top-level element in the
 /// MaterialX ownership hierarchy.
@@ -456,7 +595,12 @@ class Document : public GraphElement
 
     /// Upgrade the content of this document from earlier supported versions to
     /// the library version.  Documents from future versions are left unmodified.
-    void upgradeVersion();
+    /// @param threadCount The maximum number of threads to use, distributing
+    ///    the top-level children of the document across threads.  If zero,
+    ///    then the hardware concurrency of the host is used.  When more than
+    ///    one thread is requested, per-edit callbacks are not issued during
+    ///    the upgrade, which is instead reported as a single update.
+    void upgradeVersion(unsigned int threadCount = 1);
 
     /// @}
     /// @name Color Management System
@@ -502,6 +646,31 @@ class Document : public GraphElement
         return getAttribute(CMS_CONFIG_ATTRIBUTE);
     }
 
+    /// @}
+    /// @name Name Path Index
+    /// @{
+
+    /// Enable or disable the name path index of this document.  While the
+    /// index is enabled, Element::getDescendant resolves name paths from the
+    /// document with a single lookup, and the index is updated as elements
+    /// are added, removed, and renamed.  The index is disabled by default.
+    void setNamePathIndexEnabled(bool enable);
+
+    /// Return true if the name path index of this document is enabled.
+    bool getNamePathIndexEnabled() const
+    {
+        return _namePathIndex != nullptr;
+    }
+
+    /// @}
+    /// @name Memory Statistics
+    /// @{
+
+    /// Return statistics on the memory used by this document, including its
+    /// elements, attributes, and caches.  The cost of this method is linear
+    /// in the size of the document.
+    DocumentMemoryStats getMemoryStats() const;
+
     /// @}
     /// @name Validation
     /// @{
@@ -513,6 +682,28 @@ class Document : public GraphElement
     /// @return True if the document passes all tests, false otherwise.
     bool validate(string* message = nullptr) const override;
 
+    /// Validate the document as in Document::validate, distributing the
+    /// top-level children of the document across multiple threads.  The
+    /// returned messages are identical to those of a serial validation.
+    /// @param message An optional output string, to which a description of
+    ///    each error will be appended.
+    /// @param threadCount The maximum number of threads to use.  If zero,
+    ///    then the hardware concurrency of the host is used.
+    /// @return True if the document passes all tests, false otherwise.
+    bool validateParallel(string* message = nullptr, unsigned int threadCount = 0) const;
+
+    /// Validate the document as in Document::validate, re-validating only
+    /// those top-level children whose content has been edited since the
+    /// previous call to this method.  Edits that may affect the validity of
+    /// other elements, such as changes to names, types, or connections,
+    /// cause the full document to be re-validated.
+    /// @param message An optional output string, to which a description of
+    ///    each error will be appended.
+    /// @param threadCount The maximum number of threads to use.  If zero,
+    ///    then the hardware concurrency of the host is used.
+    /// @return True if the document passes all tests, false otherwise.
+    bool validateIncremental(string* message = nullptr, unsigned int threadCount = 1) const;
+
     /// @}
     /// @name Callbacks
     /// @{
@@ -541,6 +732,11 @@ class Document : public GraphElement
     /// Called when data is written from the current document.
     virtual void onWrite() { }
 
+    /// Called when a set of changes is committed to the document by a
+    /// DocumentTransaction, or reverted and reapplied by its undo and redo
+    /// methods.  Individual callbacks are not issued for these changes.
+    virtual void onCommitChanges(const DocumentChangeSet&) { }
+
     /// Called before a set of document updates is performed.
     virtual void onBeginUpdate() { }
 
@@ -560,31 +756,113 @@ class Document : public GraphElement
     static const string CMS_ATTRIBUTE;
     static const string CMS_CONFIG_ATTRIBUTE;
 
+  private:
+    friend class Element;
+    friend class NodeDef;
+    friend class DocumentTransaction;
+
+    // Return the shared string resolver for the given scope and arguments,
+    // creating and caching it if needed.
+    ConstStringResolverPtr getCachedStringResolver(const Element& scope, const string& geom,
+                                                   ConstMaterialPtr material, const string& target,
+                                                   const string& type) const;
+
+    // Return the geometry token substitutions that apply to the given
+    // geometry string, caching them until the document is edited.
+    shared_ptr<const StringMap> getGeomTokenSubstitutions(const string& geom) const;
+
+    // Discard all cached string resolvers and token substitutions.
+    void invalidateStringResolvers() const;
+
+    // Look up a memoized implementation for the given nodedef, target and
+    // language, returning true if an entry was found.
+    bool findCachedImplementation(const NodeDef& nodeDef, const string& target, const string& language,
+                                  InterfaceElementPtr& implementation) const;
+
+    // Store the implementation found for the given nodedef, target and
+    // language.  Entries are discarded when the document cache is invalidated.
+    void cacheImplementation(const NodeDef& nodeDef, const string& target, const string& language,
+                             InterfaceElementPtr implementation) const;
+
+    // Return the element at the given name path in the name path index, or
+    // an empty shared pointer if no element is indexed at this path.
+    ElementPtr getIndexedElement(const string& namePath) const;
+
+    // Invalidate the connection index of the graph element within whose
+    // scope the connections of the given element are resolved.
+    void invalidateGraphConnections(ConstElementPtr elem) const;
+
+    // Record an edit to the given element for incremental validation.
+    void invalidateValidation(ConstElementPtr elem, const string& attrib = EMPTY_STRING) const;
+
+    // Record an edit to the given attribute for incremental validation,
+    // ignoring edits that leave the attribute value unchanged.
+    void invalidateValidation(ConstElementPtr elem, const string& attrib, const string& value) const;
+
+    // Apply the upgrade steps from the given start version up to, but not
+    // including, the given end version to all elements of the document.
+    void upgradeElements(int startVersion, int endVersion, unsigned int threadCount);
+
+    // Refresh the document state maintained by callbacks, after a set of
+    // edits for which notifications were suspended.
+    void refreshSuspendedState();
+
+    // Validate the document across its top-level children in parallel.  In
+    // incremental mode, stored results are reused for top-level children that
+    // have not been edited since the previous incremental validation.
+    bool validateChildren(string* message, unsigned int threadCount, bool incremental) const;
+
   private:
     class Cache;
     std::unique_ptr<Cache> _cache;
+
+    class ValidationState;
+    std::unique_ptr<ValidationState> _validationState;
+
+    class NamePathIndex;
+    std::unique_ptr<NamePathIndex> _namePathIndex;
+
+    bool _notificationsSuspended;
+    DocumentTransaction* _transaction;
 };
 
 /// @class ScopedUpdate
 /// An RAII class for Document updates.
 ///
 /// A ScopedUpdate instance calls Document::onBeginUpdate when created, and
-/// Document::onEndUpdate when destroyed.
+/// Document::onEndUpdate when destroyed.  A ScopedUpdate for an empty
+/// document pointer has no effect.
 class ScopedUpdate
 {
   public:
     explicit ScopedUpdate(DocumentPtr doc) :
+        _docPtr(doc),
+        _doc(doc.get())
+    {
+        if (_doc)
+        {
+            _doc->onBeginUpdate();
+        }
+    }
+    explicit ScopedUpdate(Document* doc) :
         _doc(doc)
     {
-        _doc->onBeginUpdate();
+        if (_doc)
+        {
+            _doc->onBeginUpdate();
+        }
     }
     ~ScopedUpdate()
     {
-        _doc->onEndUpdate();
+        if (_doc)
+        {
+            _doc->onEndUpdate();
+        }
     }
 
   private:
-    DocumentPtr _doc;
+    DocumentPtr _docPtr;
+    Document* _doc;
 };
 
 /// @class ScopedDisableCallbacks
@@ -7,6 +7,7 @@
 
 #include <MaterialXCore/Document.h>
 #include <MaterialXCore/Node.h>
+#include <MaterialXCore/Transaction.h>
 #include <MaterialXCore/Util.h>
 
 namespace MaterialX
@@ -35,10 +36,55 @@ const string ValueElement::UI_MAX_ATTRIBUTE = "uimax";
 
 Element::CreatorMap Element::_creatorMap;
 
+namespace {
+
+bool isScopeAttribute(const string& attrib)
+{
+    return attrib == Element::FILE_PREFIX_ATTRIBUTE ||
+           attrib == Element::GEOM_PREFIX_ATTRIBUTE ||
+           attrib == Element::COLOR_SPACE_ATTRIBUTE ||
+           attrib == Element::NAMESPACE_ATTRIBUTE;
+}
+
+} // anonymous namespace
+
+//
+// Element scope structures
+//
+
+// The values of scoping attributes that are active at the scope of an element.
+struct Element::ScopeValues
+{
+    string filePrefix;
+    string geomPrefix;
+    string colorSpace;
+    string sourceUri;
+    string space;
+    bool hasSpace = false;
+};
+
+// The cached scope of an element, including its name path and its scope
+// values, which are shared with descendants that define no scoping
+// attributes of their own.
+struct Element::ScopeCache
+{
+    shared_ptr<const ScopeValues> values;
+    string namePath;
+};
+
 //
 // Element methods
 //
 
+Element::~Element()
+{
+    // Children that outlive this element are detached from it.
+    for (const ElementPtr& child : _childOrder)
+    {
+        child->_parentRaw = nullptr;
+    }
+}
+
 bool Element::operator==(const Element& rhs) const
 {
     if (getCategory() != rhs.getCategory() ||
@@ -76,7 +122,6 @@ bool Element::operator!=(const Element& rhs) const
 
 void Element::setName(const string& name)
 {
-    DocumentPtr doc = getDocument();
     ElementPtr parent = getParent();
     if (parent && parent->_childMap.count(name) && name != getName())
     {
@@ -84,8 +129,16 @@ void Element::setName(const string& name)
     }
 
     // Handle change notifications.
+    Document* doc = getNotifiedDocument();
     ScopedUpdate update(doc);
-    doc->onSetAttribute(getSelf(), NAME_ATTRIBUTE, name);
+    if (doc)
+    {
+        doc->onSetAttribute(getSelf(), NAME_ATTRIBUTE, name);
+    }
+    else if (DocumentTransaction* transaction = getTransaction())
+    {
+        transaction->recordSetAttribute(getSelf(), NAME_ATTRIBUTE, name);
+    }
 
     if (parent)
     {
@@ -93,13 +146,16 @@ void Element::setName(const string& name)
         parent->_childMap[name] = getSelf();
     }
     _name = name;
+    invalidateScope();
 }
 
 string Element::getNamePath(ConstElementPtr relativeTo) const
 {
-    if (!relativeTo)
+    // Name paths relative to the root are cached.
+    ConstElementPtr root = getRoot();
+    if (!relativeTo || relativeTo == root)
     {
-        relativeTo = getDocument();
+        return getScopeCache().namePath;
     }
 
     string res;
@@ -116,15 +172,36 @@ string Element::getNamePath(ConstElementPtr relativeTo) const
 
 ElementPtr Element::getDescendant(const string& namePath)
 {
-    const StringVec nameVec = splitString(namePath, NAME_PATH_SEPARATOR);
+    // Resolve paths from the document through its name path index, if enabled.
+    // Paths in the canonical form returned by getNamePath are resolved by the
+    // index alone, while other forms fall back to a walk of the hierarchy.
+    DocumentPtr doc = asA<Document>();
+    if (doc && doc->_namePathIndex && !namePath.empty())
+    {
+        ElementPtr elem = doc->getIndexedElement(namePath);
+        const char separator = NAME_PATH_SEPARATOR[0];
+        bool canonical = namePath.front() != separator &&
+                         namePath.back() != separator &&
+                         namePath.find(string(2, separator)) == string::npos;
+        if (elem || canonical)
+        {
+            return elem;
+        }
+    }
+
     ElementPtr elem = getSelf();
-    for (const string& name : nameVec)
+    string name;
+    string::size_type pos = namePath.find_first_not_of(NAME_PATH_SEPARATOR);
+    while (pos != string::npos)
     {
+        string::size_type end = namePath.find_first_of(NAME_PATH_SEPARATOR, pos);
+        name.assign(namePath, pos, end == string::npos ? string::npos : end - pos);
         elem = elem->getChild(name);
         if (!elem)
         {
             return ElementPtr();
         }
+        pos = namePath.find_first_not_of(NAME_PATH_SEPARATOR, end);
     }
     return elem;
 }
@@ -155,11 +232,19 @@ std::pair<int, int> Element::getVersionIntegers() const
 
 void Element::registerChildElement(ElementPtr child)
 {
-    DocumentPtr doc = getDocument();
+    child->_parentRaw = this;
 
     // Handle change notifications.
+    Document* doc = getNotifiedDocument();
     ScopedUpdate update(doc);
-    doc->onAddElement(getSelf(), child);
+    if (doc)
+    {
+        doc->onAddElement(getSelf(), child);
+    }
+    else if (DocumentTransaction* transaction = getTransaction())
+    {
+        transaction->recordAddElement(getSelf(), child);
+    }
 
     _childMap[child->getName()] = child;
     _childOrder.push_back(child);
@@ -167,15 +252,139 @@ void Element::registerChildElement(ElementPtr child)
 
 void Element::unregisterChildElement(ElementPtr child)
 {
-    DocumentPtr doc = getDocument();
-
     // Handle change notifications.
+    Document* doc = getNotifiedDocument();
     ScopedUpdate update(doc);
-    doc->onRemoveElement(getSelf(), child);
+    if (doc)
+    {
+        doc->onRemoveElement(getSelf(), child);
+    }
+    else if (DocumentTransaction* transaction = getTransaction())
+    {
+        transaction->recordRemoveElement(getSelf(), child);
+    }
 
     _childMap.erase(child->getName());
     _childOrder.erase(
         std::find(_childOrder.begin(), _childOrder.end(), child));
+    child->_parentRaw = nullptr;
+}
+
+Document* Element::getNotifiedDocument()
+{
+    Document* doc = getDocumentRaw();
+    if (!doc)
+    {
+        throw ExceptionOrphanedElement("Requested document of orphaned element: " + asString());
+    }
+    return (doc->_notificationsSuspended || doc->_transaction) ? nullptr : doc;
+}
+
+DocumentTransaction* Element::getTransaction()
+{
+    Document* doc = getDocumentRaw();
+    if (!doc)
+    {
+        throw ExceptionOrphanedElement("Requested document of orphaned element: " + asString());
+    }
+    return doc->_notificationsSuspended ? nullptr : doc->_transaction;
+}
+
+void Element::invalidateScope()
+{
+    // The scope of an element is cached only after the scope of its parent,
+    // so an uncached element has no cached descendants.
+    if (!std::atomic_exchange(&_scopeCache, shared_ptr<const ScopeCache>()))
+    {
+        return;
+    }
+
+    for (const ElementPtr& child : _childOrder)
+    {
+        child->invalidateScope();
+    }
+}
+
+const Element::ScopeCache& Element::getScopeCache() const
+{
+    shared_ptr<const ScopeCache> cache = std::atomic_load(&_scopeCache);
+    if (cache)
+    {
+        return *cache;
+    }
+
+    // Start from the scope of the parent, and share its values if this
+    // element defines no scoping attributes of its own.  Elements removed
+    // from their parents reach them through their weak parent links.
+    ConstElementPtr removedParent = _parentRaw ? nullptr : getParent();
+    const Element* parent = _parentRaw ? _parentRaw : removedParent.get();
+    const ScopeCache* parentCache = parent ? &parent->getScopeCache() : nullptr;
+    shared_ptr<const ScopeValues> values = parentCache ? parentCache->values :
+                                                         std::make_shared<ScopeValues>();
+    bool hasOwnFilePrefix = hasFilePrefix();
+    bool hasOwnGeomPrefix = hasGeomPrefix();
+    bool hasOwnColorSpace = hasColorSpace();
+    bool hasOwnNamespace = hasNamespace();
+    if (hasOwnFilePrefix || hasOwnGeomPrefix || hasOwnColorSpace || hasOwnNamespace || hasSourceUri())
+    {
+        shared_ptr<ScopeValues> ownValues = std::make_shared<ScopeValues>(*values);
+        if (hasOwnFilePrefix)
+            ownValues->filePrefix = getFilePrefix();
+        if (hasOwnGeomPrefix)
+            ownValues->geomPrefix = getGeomPrefix();
+        if (hasOwnColorSpace)
+            ownValues->colorSpace = getColorSpace();
+        if (hasSourceUri())
+            ownValues->sourceUri = getSourceUri();
+        if (hasOwnNamespace)
+        {
+            ownValues->space = getNamespace();
+            ownValues->hasSpace = true;
+        }
+        values = ownValues;
+    }
+
+    // Publish the new cache, deferring to any cache that was published by
+    // another thread in the meantime.
+    string namePath;
+    if (parentCache)
+    {
+        namePath = parentCache->namePath.empty() ? getName() :
+                   parentCache->namePath + NAME_PATH_SEPARATOR + getName();
+    }
+    shared_ptr<ScopeCache> newCache = std::make_shared<ScopeCache>();
+    newCache->values = values;
+    newCache->namePath = std::move(namePath);
+    shared_ptr<const ScopeCache> expected;
+    if (!std::atomic_compare_exchange_strong(&_scopeCache, &expected, shared_ptr<const ScopeCache>(newCache)))
+    {
+        return *expected;
+    }
+    return *newCache;
+}
+
+size_t Element::getScopeCacheBytes() const
+{
+    shared_ptr<const ScopeCache> cache = std::atomic_load(&_scopeCache);
+    if (!cache)
+    {
+        return 0;
+    }
+    size_t bytes = sizeof(ScopeCache) + getHeapBytes(cache->namePath);
+
+    // Scope values are counted by the highest element that shares them.
+    shared_ptr<const ScopeCache> parentCache = _parentRaw ? std::atomic_load(&_parentRaw->_scopeCache) : nullptr;
+    if (!parentCache || parentCache->values != cache->values)
+    {
+        const ScopeValues& values = *cache->values;
+        bytes += sizeof(ScopeValues) +
+                 getHeapBytes(values.filePrefix) +
+                 getHeapBytes(values.geomPrefix) +
+                 getHeapBytes(values.colorSpace) +
+                 getHeapBytes(values.sourceUri) +
+                 getHeapBytes(values.space);
+    }
+    return bytes;
 }
 
 int Element::getChildIndex(const string& name) const
@@ -203,8 +412,20 @@ void Element::setChildIndex(const string& name, int index)
         throw Exception("Invalid child index");
     }
 
+    size_t oldIndex = (size_t) std::distance(_childOrder.begin(), it);
     _childOrder.erase(it);
     _childOrder.insert(_childOrder.begin() + (size_t) index, child);
+
+    // Child order determines the precedence of geometry tokens.
+    Document* doc = getDocumentRaw();
+    if (doc && !doc->_notificationsSuspended)
+    {
+        doc->invalidateStringResolvers();
+        if (doc->_transaction)
+        {
+            doc->_transaction->recordSetChildIndex(getSelf(), child, oldIndex);
+        }
+    }
 }
 
 void Element::removeChild(const string& name)
@@ -220,17 +441,50 @@ void Element::removeChild(const string& name)
 
 void Element::setAttribute(const string& attrib, const string& value)
 {
-    DocumentPtr doc = getDocument();
+    setAttributeImpl(attrib, value);
+}
+
+void Element::setAttribute(string&& attrib, string&& value)
+{
+    setAttributeImpl(std::move(attrib), std::move(value));
+}
 
+template <class S> void Element::setAttributeImpl(S&& attrib, S&& value)
+{
     // Handle change notifications.
+    Document* doc = getNotifiedDocument();
     ScopedUpdate update(doc);
-    doc->onSetAttribute(getSelf(), attrib, value);
+    if (doc)
+    {
+        doc->onSetAttribute(getSelf(), attrib, value);
+    }
+    else if (DocumentTransaction* transaction = getTransaction())
+    {
+        transaction->recordSetAttribute(getSelf(), attrib, value);
+    }
 
-    if (!_attributeMap.count(attrib))
+    bool scopeAttribute = isScopeAttribute(attrib);
+    StringMap::iterator it = _attributeMap.find(attrib);
+    if (it != _attributeMap.end())
     {
+        it->second = std::forward<S>(value);
+    }
+    else
+    {
+        // Elements built from serialized content typically store a few
+        // attributes each, so reserve space for them up front.
+        if (_attributeOrder.empty())
+        {
+            _attributeOrder.reserve(4);
+        }
         _attributeOrder.push_back(attrib);
+        _attributeMap.emplace(std::forward<S>(attrib), std::forward<S>(value));
+    }
+
+    if (scopeAttribute)
+    {
+        invalidateScope();
     }
-    _attributeMap[attrib] = value;
 }
 
 void Element::removeAttribute(const string& attrib)
@@ -238,18 +492,55 @@ void Element::removeAttribute(const string& attrib)
     StringMap::iterator it = _attributeMap.find(attrib);
     if (it != _attributeMap.end())
     {
-        DocumentPtr doc = getDocument();
-
         // Handle change notifications.
+        Document* doc = getNotifiedDocument();
         ScopedUpdate update(doc);
-        doc->onRemoveAttribute(getSelf(), attrib);
+        if (doc)
+        {
+            doc->onRemoveAttribute(getSelf(), attrib);
+        }
+        else if (DocumentTransaction* transaction = getTransaction())
+        {
+            transaction->recordRemoveAttribute(getSelf(), attrib);
+        }
 
         _attributeMap.erase(it);
         _attributeOrder.erase(
             std::find(_attributeOrder.begin(), _attributeOrder.end(), attrib));
+
+        if (isScopeAttribute(attrib))
+        {
+            invalidateScope();
+        }
     }
 }
 
+const string& Element::getActiveFilePrefix() const
+{
+    return getScopeCache().values->filePrefix;
+}
+
+const string& Element::getActiveGeomPrefix() const
+{
+    return getScopeCache().values->geomPrefix;
+}
+
+const string& Element::getActiveColorSpace() const
+{
+    return getScopeCache().values->colorSpace;
+}
+
+const string& Element::getActiveSourceUri() const
+{
+    return getScopeCache().values->sourceUri;
+}
+
+string Element::getQualifiedName(const string& name) const
+{
+    const ScopeValues& values = *getScopeCache().values;
+    return values.hasSpace ? values.space + NAME_PREFIX_SEPARATOR + name : name;
+}
+
 template<class T> shared_ptr<T> Element::asA()
 {
     return std::dynamic_pointer_cast<T>(getSelf());
@@ -263,11 +554,8 @@ template<class T> shared_ptr<const T> Element::asA() const
 ElementPtr Element::addChildOfCategory(const string& category,
                                        const string& name)
 {
-    string childName = name;
-    if (childName.empty())
-    {
-        childName = createValidChildName(category + "1");
-    }
+    string generatedName = name.empty() ? createValidChildName(category + "1") : EMPTY_STRING;
+    const string& childName = name.empty() ? generatedName : name;
 
     if (_childMap.count(childName))
     {
@@ -323,6 +611,47 @@ ConstElementPtr Element::getRoot() const
     return root;
 }
 
+DocumentPtr Element::getDocument()
+{
+    Document* doc = getDocumentRaw();
+    return doc ? std::static_pointer_cast<Document>(doc->getSelf()) : getRoot()->asA<Document>();
+}
+
+ConstDocumentPtr Element::getDocument() const
+{
+    const Document* doc = getDocumentRaw();
+    return doc ? std::static_pointer_cast<const Document>(doc->getSelf()) : getRoot()->asA<Document>();
+}
+
+Document* Element::getDocumentRaw()
+{
+    return const_cast<Document*>(static_cast<const Element*>(this)->getDocumentRaw());
+}
+
+const Document* Element::getDocumentRaw() const
+{
+    const Element* root = getRootRaw();
+    if (root)
+    {
+        return static_cast<const Document*>(root);
+    }
+
+    // Elements removed from their parents reach the document through their
+    // weak root links.
+    ElementPtr lockedRoot = _root.lock();
+    return lockedRoot ? dynamic_cast<const Document*>(lockedRoot.get()) : nullptr;
+}
+
+const Element* Element::getRootRaw() const
+{
+    const Element* root = this;
+    while (root->_parentRaw)
+    {
+        root = root->_parentRaw;
+    }
+    return dynamic_cast<const Document*>(root) ? root : nullptr;
+}
+
 bool Element::hasInheritedBase(ConstElementPtr base) const
 {
     for (ConstElementPtr elem : traverseInheritance())
@@ -375,16 +704,24 @@ InheritanceIterator Element::traverseInheritance() const
 
 void Element::copyContentFrom(const ConstElementPtr& source, const CopyOptions* copyOptions)
 {
-    DocumentPtr doc = getDocument();
     bool skipDuplicateElements = copyOptions && copyOptions->skipDuplicateElements;
 
     // Handle change notifications.
+    Document* doc = getNotifiedDocument();
     ScopedUpdate update(doc);
-    doc->onCopyContent(getSelf());
+    if (doc)
+    {
+        doc->onCopyContent(getSelf());
+    }
+    else if (DocumentTransaction* transaction = getTransaction())
+    {
+        transaction->recordCopyContent(getSelf());
+    }
 
     _sourceUri = source->_sourceUri;
     _attributeMap = source->_attributeMap;
     _attributeOrder = source->_attributeOrder;
+    invalidateScope();
 
     for (const ConstElementPtr& child : source->getChildren())
     {
@@ -400,15 +737,22 @@ void Element::copyContentFrom(const ConstElementPtr& source, const CopyOptions*
 
 void Element::clearContent()
 {
-    DocumentPtr doc = getDocument();
-
     // Handle change notifications.
+    Document* doc = getNotifiedDocument();
     ScopedUpdate update(doc);
-    doc->onClearContent(getSelf());
+    if (doc)
+    {
+        doc->onClearContent(getSelf());
+    }
+    else if (DocumentTransaction* transaction = getTransaction())
+    {
+        transaction->recordClearContent(getSelf());
+    }
 
     _sourceUri = EMPTY_STRING;
     _attributeMap.clear();
     _attributeOrder.clear();
+    invalidateScope();
 
     vector<ElementPtr> children = getChildren();
     for (ElementPtr child : children)
@@ -448,16 +792,9 @@ StringResolverPtr Element::createStringResolver(const string& geom,
     // If a geometry name is specified, then apply it to the filename map.
     if (!geom.empty())
     {
-        for (GeomInfoPtr geomInfo : getDocument()->getGeomInfos())
+        for (const auto& pair : *getDocument()->getGeomTokenSubstitutions(geom))
         {
-            if (!geomStringsMatch(geom, geomInfo->getActiveGeom()))
-                continue;
-            for (TokenPtr token : geomInfo->getTokens())
-            {
-                string key = "<" + token->getName() + ">";
-                string value = token->getResolvedValueString();
-                resolver->setFilenameSubstitution(key, value);
-            }
+            resolver->setFilenameSubstitution(pair.first, pair.second);
         }
     }
 
@@ -479,6 +816,19 @@ StringResolverPtr Element::createStringResolver(const string& geom,
     return resolver;
 }
 
+ConstStringResolverPtr Element::getStringResolver(const string& geom,
+                                                  ConstMaterialPtr material,
+                                                  const string& target,
+                                                  const string& type) const
+{
+    const Document* doc = getDocumentRaw();
+    if (!doc)
+    {
+        return createStringResolver(geom, material, target, type);
+    }
+    return doc->getCachedStringResolver(*this, geom, material, target, type);
+}
+
 string Element::asString() const
 {
     string res = "<" + getCategory();
@@ -527,7 +877,7 @@ string ValueElement::getResolvedValueString(StringResolverPtr resolver) const
     }
     if (!resolver)
     {
-        resolver = createStringResolver();
+        return getStringResolver()->resolve(getValueString(), getType());
     }
     return resolver->resolve(getValueString(), getType());
 }
@@ -646,11 +996,15 @@ string StringResolver::resolve(const string& str, const string& type) const
 {
     if (type == FILENAME_TYPE_STRING)
     {
-        return _filePrefix + replaceSubstrings(str, _filenameMap);
+        string result = _filePrefix;
+        _filenameReplacer.replace(str, result);
+        return result;
     }
     if (type == GEOMNAME_TYPE_STRING)
     {
-        return _geomPrefix + replaceSubstrings(str, _geomNameMap);
+        string result = _geomPrefix;
+        _geomNameReplacer.replace(str, result);
+        return result;
     }
     return str;
 }
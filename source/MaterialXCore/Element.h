@@ -15,6 +15,7 @@
 #include <MaterialXCore/Util.h>
 #include <MaterialXCore/Value.h>
 
+
 namespace MaterialX
 {
 
@@ -24,6 +25,7 @@ class ValueElement;
 class Token;
 class StringResolver;
 class Document;
+class DocumentTransaction;
 class Material;
 class CopyOptions;
 
@@ -49,6 +51,8 @@ using ConstTokenPtr = shared_ptr<const Token>;
 
 /// A shared pointer to a StringResolver
 using StringResolverPtr = shared_ptr<StringResolver>;
+/// A shared pointer to a const StringResolver
+using ConstStringResolverPtr = shared_ptr<const StringResolver>;
 
 /// A hash map from strings to elements
 using ElementMap = std::unordered_map<string, ElementPtr>;
@@ -68,11 +72,12 @@ class Element : public std::enable_shared_from_this<Element>
         _category(category),
         _name(name),
         _parent(parent),
-        _root(parent ? parent->getRoot() : nullptr)
+        _root(parent ? parent->getRoot() : nullptr),
+        _parentRaw(nullptr)
     {
     }
   public:
-    virtual ~Element() { }
+    virtual ~Element();
 
   protected:
     using DocumentPtr = shared_ptr<Document>;
@@ -80,6 +85,8 @@ class Element : public std::enable_shared_from_this<Element>
     using ConstMaterialPtr = shared_ptr<const Material>;
 
     template <class T> friend class ElementRegistry;
+    friend class Document;
+    friend class DocumentTransaction;
 
   public:
     /// Return true if the given element tree, including all descendants,
@@ -161,17 +168,7 @@ class Element : public std::enable_shared_from_this<Element>
 
     /// Return the file prefix string that is active at the scope of this
     /// element, taking all ancestor elements into account.
-    const string& getActiveFilePrefix() const
-    {
-        for (ConstElementPtr elem = getSelf(); elem; elem = elem->getParent())
-        {
-            if (elem->hasFilePrefix())
-            {
-                return elem->getFilePrefix();
-            }
-        }
-        return EMPTY_STRING;
-    }
+    const string& getActiveFilePrefix() const;
 
     /// @}
     /// @name Geom Prefix
@@ -197,17 +194,7 @@ class Element : public std::enable_shared_from_this<Element>
 
     /// Return the geom prefix string that is active at the scope of this
     /// element, taking all ancestor elements into account.
-    const string& getActiveGeomPrefix() const
-    {
-        for (ConstElementPtr elem = getSelf(); elem; elem = elem->getParent())
-        {
-            if (elem->hasGeomPrefix())
-            {
-                return elem->getGeomPrefix();
-            }
-        }
-        return EMPTY_STRING;
-    }
+    const string& getActiveGeomPrefix() const;
 
     /// @}
     /// @name Color Space
@@ -233,17 +220,7 @@ class Element : public std::enable_shared_from_this<Element>
 
     /// Return the color space string that is active at the scope of this
     /// element, taking all ancestor elements into account.
-    const string& getActiveColorSpace() const
-    {
-        for (ConstElementPtr elem = getSelf(); elem; elem = elem->getParent())
-        {
-            if (elem->hasColorSpace())
-            {
-                return elem->getColorSpace();
-            }
-        }
-        return EMPTY_STRING;
-    }
+    const string& getActiveColorSpace() const;
 
     /// @}
     /// @name Target
@@ -339,17 +316,7 @@ class Element : public std::enable_shared_from_this<Element>
 
     /// Return a qualified version of the given name, taking the namespace at the
     /// scope of this element into account.
-    string getQualifiedName(const string& name) const
-    {
-        for (ConstElementPtr elem = getSelf(); elem; elem = elem->getParent())
-        {
-            if (elem->hasNamespace())
-            {
-                return elem->getNamespace() + NAME_PREFIX_SEPARATOR + name;
-            }
-        }
-        return name;
-    }
+    string getQualifiedName(const string& name) const;
 
     /// @}
     /// @name Version
@@ -511,6 +478,14 @@ class Element : public std::enable_shared_from_this<Element>
     /// Set the value string of the given attribute.
     void setAttribute(const string& attrib, const string& value);
 
+    /// Set the value string of the given attribute, moving the given
+    /// strings into the element where possible.
+    void setAttribute(string&& attrib, string&& value);
+
+    // Attribute lookups take string keys only, since C++11 provides neither
+    // string_view nor heterogeneous lookup in unordered containers, and a
+    // C string overload would still build a string key for the lookup.
+
     /// Return true if the given attribute is present.
     bool hasAttribute(const string& attrib) const
     {
@@ -595,24 +570,59 @@ class Element : public std::enable_shared_from_this<Element>
     ConstElementPtr getRoot() const;
 
     /// Return the root document of our tree.
-    DocumentPtr getDocument()
+    DocumentPtr getDocument();
+
+    /// Return the root document of our tree.
+    ConstDocumentPtr getDocument() const;
+
+    /// Return a non-owning pointer to our parent element, or nullptr if this
+    /// element is the root of its tree or has been removed from its parent.
+    /// The pointer remains valid while this element is a child of its parent.
+    Element* getParentRaw()
     {
-        return getRoot()->asA<Document>();
+        return _parentRaw;
     }
 
-    /// Return the root document of our tree.
-    ConstDocumentPtr getDocument() const
+    /// Return a non-owning pointer to our parent element, or nullptr if this
+    /// element is the root of its tree or has been removed from its parent.
+    /// The pointer remains valid while this element is a child of its parent.
+    const Element* getParentRaw() const
     {
-        return getRoot()->asA<Document>();
+        return _parentRaw;
     }
 
+    /// Return a non-owning pointer to the root document of our tree, or
+    /// nullptr if the document no longer exists.  Unlike getDocument, this
+    /// method follows the parent links of the tree without locking them,
+    /// and the pointer remains valid while the document is owned elsewhere.
+    Document* getDocumentRaw();
+
+    /// Return a non-owning pointer to the root document of our tree, or
+    /// nullptr if the document no longer exists.
+    const Document* getDocumentRaw() const;
+
     /// Return the first ancestor of the given subclass, or an empty shared
     /// pointer if no ancestor of this subclass is found.
     template<class T> shared_ptr<const T> getAncestorOfType() const
     {
-        for (ConstElementPtr elem = getSelf(); elem; elem = elem->getParent())
+        const Element* elem = this;
+        for (; elem; elem = elem->_parentRaw)
+        {
+            if (dynamic_cast<const T*>(elem))
+            {
+                return std::static_pointer_cast<const T>(elem->getSelf());
+            }
+            if (!elem->_parentRaw)
+            {
+                break;
+            }
+        }
+
+        // Elements removed from their parents are searched through their
+        // weak parent links.
+        for (ConstElementPtr parent = elem->getParent(); parent; parent = parent->getParent())
         {
-            shared_ptr<const T> typedElem = elem->asA<T>();
+            shared_ptr<const T> typedElem = parent->asA<T>();
             if (typedElem)
             {
                 return typedElem;
@@ -726,6 +736,7 @@ class Element : public std::enable_shared_from_this<Element>
     void setSourceUri(const string& sourceUri)
     {
         _sourceUri = sourceUri;
+        invalidateScope();
     }
 
     /// Return true if this element has a source URI.
@@ -742,17 +753,7 @@ class Element : public std::enable_shared_from_this<Element>
 
     /// Return the source URI that is active at the scope of this
     /// element, taking all ancestor elements into account.
-    const string& getActiveSourceUri() const
-    {
-        for (ConstElementPtr elem = getSelf(); elem; elem = elem->getParent())
-        {
-            if (elem->hasSourceUri())
-            {
-                return elem->getSourceUri();
-            }
-        }
-        return EMPTY_STRING;
-    }
+    const string& getActiveSourceUri() const;
 
     /// @}
     /// @name Validation
@@ -810,6 +811,19 @@ class Element : public std::enable_shared_from_this<Element>
                                            const string& target = EMPTY_STRING,
                                            const string& type = EMPTY_STRING) const;
 
+    /// Return a shared StringResolver at the scope of this element, with the
+    /// same modifiers as a StringResolver constructed by createStringResolver
+    /// for the given arguments.
+    ///
+    /// Resolvers are cached by the owning document for each combination of
+    /// scope, geometry, material, target, and type, and the cache is cleared
+    /// whenever the document is edited.  Since the returned object may be
+    /// shared with other callers, it cannot be modified.
+    ConstStringResolverPtr getStringResolver(const string& geom = EMPTY_STRING,
+                                             ConstMaterialPtr material = nullptr,
+                                             const string& target = EMPTY_STRING,
+                                             const string& type = EMPTY_STRING) const;
+
     /// Return a single-line description of this element, including its category,
     /// name, and attributes.
     string asString() const;
@@ -821,7 +835,12 @@ class Element : public std::enable_shared_from_this<Element>
     // taking the namespace at the scope of this element into account.
     template<class T> shared_ptr<T> resolveRootNameReference(const string& name) const
     {
-        ConstElementPtr root = getRoot();
+        const Element* root = getRootRaw();
+        ConstElementPtr lockedRoot = root ? nullptr : getRoot();
+        if (!root)
+        {
+            root = lockedRoot.get();
+        }
         shared_ptr<T> child = root->getChildOfType<T>(getQualifiedName(name));
         return child ? child : root->getChildOfType<T>(name);
     }
@@ -845,6 +864,22 @@ class Element : public std::enable_shared_from_this<Element>
     virtual void registerChildElement(ElementPtr child);
     virtual void unregisterChildElement(ElementPtr child);
 
+    // Clear the cached scope values and name paths of this element and its
+    // descendants.
+    void invalidateScope();
+
+    // Return the root of our tree as a non-owning pointer, if this element
+    // and its ancestors are attached to a document, or nullptr otherwise.
+    const Element* getRootRaw() const;
+
+    // Return the document to be notified of edits to this element, or
+    // nullptr if the document has suspended notifications or is recording
+    // edits in a transaction.
+    Document* getNotifiedDocument();
+
+    // Return the transaction recording edits to this element, if any.
+    DocumentTransaction* getTransaction();
+
     // Return a non-const copy of our self pointer, for use in constructing
     // graph traversal objects that require non-const storage.
     ElementPtr getSelfNonConst() const
@@ -866,6 +901,10 @@ class Element : public std::enable_shared_from_this<Element>
     weak_ptr<Element> _parent;
     weak_ptr<Element> _root;
 
+    // A non-owning link to our parent, which is set while this element is
+    // registered as a child of its parent.
+    Element* _parentRaw;
+
   private:
     Element(const Element&) = delete;
     Element& operator=(const Element&) = delete;
@@ -875,11 +914,30 @@ class Element : public std::enable_shared_from_this<Element>
         return std::make_shared<T>(parent, name);
     }
 
+  private:
+    // Shared implementation of the setAttribute overloads, forwarding the
+    // given strings into the attribute map.
+    template <class S> void setAttributeImpl(S&& attrib, S&& value);
+
+  private:
+    struct ScopeValues;
+    struct ScopeCache;
+
+    const ScopeCache& getScopeCache() const;
+
+    // Return the number of bytes held by the cached scope of this element,
+    // including scope values that are not shared with its parent.
+    size_t getScopeCacheBytes() const;
+
   private:
     using CreatorFunction = ElementPtr (*)(ElementPtr, const string&);
     using CreatorMap = std::unordered_map<string, CreatorFunction>;
 
     static CreatorMap _creatorMap;
+
+    // The cached scope, which is published and invalidated with the atomic
+    // operations for shared pointers.
+    mutable shared_ptr<const ScopeCache> _scopeCache;
 };
 
 /// @class TypedElement
@@ -975,8 +1033,8 @@ class ValueElement : public TypedElement
     /// Return the resolved value string of an element, applying any string
     /// substitutions that are defined at the element's scope.
     /// @param resolver An optional string resolver, which will be used to
-    ///    apply string substitutions.  By default, a new string resolver
-    ///    will be created at this scope and applied to the return value.
+    ///    apply string substitutions.  By default, the shared string resolver
+    ///    at this scope is applied to the return value.
     string getResolvedValueString(StringResolverPtr resolver = nullptr) const;
 
     /// @}
@@ -1056,8 +1114,8 @@ class ValueElement : public TypedElement
     /// may be queried to access its data.
     ///
     /// @param resolver An optional string resolver, which will be used to
-    ///    apply string substitutions.  By default, a new string resolver
-    ///    will be created at this scope and applied to the return value.
+    ///    apply string substitutions.  By default, the shared string resolver
+    ///    at this scope is applied to the return value.
     /// @return A shared pointer to the typed value of this element, or an
     ///    empty shared pointer if no value is present.
     ValuePtr getResolvedValue(StringResolverPtr resolver = nullptr) const
@@ -1233,6 +1291,7 @@ class StringResolver
     void setFilenameSubstitution(const string& key, const string& value)
     {
         _filenameMap[key] = value;
+        _filenameReplacer.setSubstitution(key, value);
     }
 
     /// Return the map of filename substring substitutions.
@@ -1249,6 +1308,7 @@ class StringResolver
     void setGeomNameSubstitution(const string& key, const string& value)
     {
         _geomNameMap[key] = value;
+        _geomNameReplacer.setSubstitution(key, value);
     }
 
     /// Return the map of geometry name substring substitutions.
@@ -1262,7 +1322,8 @@ class StringResolver
     /// @{
 
     /// Given an input string and type, apply all appropriate modifiers and
-    /// return the resulting string.
+    /// return the resulting string.  Substitutions are applied in a single
+    /// pass, so substituted values are not themselves resolved.
     virtual string resolve(const string& str, const string& type) const;
 
     /// Return true if the given type may be resolved by this class.
@@ -1278,6 +1339,8 @@ class StringResolver
     string _geomPrefix;
     StringMap _filenameMap;
     StringMap _geomNameMap;
+    SubstringReplacer _filenameReplacer;
+    SubstringReplacer _geomNameReplacer;
 };
 
 /// @class CopyOptions
@@ -1307,11 +1370,8 @@ class ExceptionOrphanedElement : public Exception
 
 template<class T> shared_ptr<T> Element::addChild(const string& name)
 {
-    string childName = name;
-    if (childName.empty())
-    {
-        childName = createValidChildName(T::CATEGORY + "1");
-    }
+    string generatedName = name.empty() ? createValidChildName(T::CATEGORY + "1") : EMPTY_STRING;
+    const string& childName = name.empty() ? generatedName : name;
 
     if (_childMap.count(childName))
         throw Exception("Child name is not unique: " + childName);
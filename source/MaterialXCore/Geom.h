@@ -185,7 +185,7 @@ class GeomElement : public Element
     string getActiveGeom() const
     {
         return hasGeom() ?
-               createStringResolver()->resolve(getGeom(), GEOMNAME_TYPE_STRING) :
+               getStringResolver()->resolve(getGeom(), GEOMNAME_TYPE_STRING) :
                EMPTY_STRING;
     }
 
@@ -502,7 +502,7 @@ class Collection : public Element
     string getActiveIncludeGeom() const
     {
         return hasIncludeGeom() ?
-               createStringResolver()->resolve(getIncludeGeom(), GEOMNAME_TYPE_STRING) :
+               getStringResolver()->resolve(getIncludeGeom(), GEOMNAME_TYPE_STRING) :
                EMPTY_STRING;
     }
 
@@ -533,7 +533,7 @@ class Collection : public Element
     string getActiveExcludeGeom() const
     {
         return hasExcludeGeom() ?
-               createStringResolver()->resolve(getExcludeGeom(), GEOMNAME_TYPE_STRING) :
+               getStringResolver()->resolve(getExcludeGeom(), GEOMNAME_TYPE_STRING) :
                EMPTY_STRING;
     }
 
@@ -260,7 +260,8 @@ bool Output::hasUpstreamCycle() const
 {
     try
     {
-        for (Edge edge : traverseGraph()) { }
+        GraphWalker walker;
+        for (Element* elem = walker.begin(getSelfNonConst().get()); elem; elem = walker.next()) { }
     }
     catch (ExceptionFoundCycle&)
     {
@@ -5,9 +5,38 @@
 
 #include <MaterialXCore/Look.h>
 
+#include <MaterialXCore/Document.h>
+
+#include <iterator>
+
 namespace MaterialX
 {
 
+namespace {
+
+bool isArraySeparator(char c)
+{
+    return ARRAY_VALID_SEPARATORS.find(c) != string::npos;
+}
+
+bool isPathSeparator(char c)
+{
+    return GEOM_PATH_SEPARATOR.find(c) != string::npos;
+}
+
+void appendIndices(vector<size_t>& dest, const vector<size_t>& source)
+{
+    dest.insert(dest.end(), source.begin(), source.end());
+}
+
+void sortIndices(vector<size_t>& indices)
+{
+    std::sort(indices.begin(), indices.end());
+    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+}
+
+} // anonymous namespace
+
 const string MaterialAssign::MATERIAL_ATTRIBUTE = "material";
 const string MaterialAssign::EXCLUSIVE_ATTRIBUTE = "exclusive";
 
@@ -109,4 +138,348 @@ MaterialPtr MaterialAssign::getReferencedMaterial() const
     return resolveRootNameReference<Material>(getMaterial());   
 }
 
+//
+// LookResolver methods
+//
+
+LookResolver::LookResolver(ConstDocumentPtr doc) :
+    _nodes(1)
+{
+    // Index collections and their geometry paths.
+    for (CollectionPtr collection : doc->getCollections())
+    {
+        size_t index = _collections.size();
+        _collections.push_back(collection);
+        _collectionIndices[collection.get()] = index;
+        for (const string& path : splitString(collection->getActiveIncludeGeom(), ARRAY_VALID_SEPARATORS))
+        {
+            _nodes[addPath(path)].includes.push_back(index);
+        }
+        for (const string& path : splitString(collection->getActiveExcludeGeom(), ARRAY_VALID_SEPARATORS))
+        {
+            _nodes[addPath(path)].excludes.push_back(index);
+        }
+    }
+
+    // Expand collection include chains, checking for cycles.
+    vector<vector<size_t>> directIncludes(_collections.size());
+    for (size_t i = 0; i < _collections.size(); i++)
+    {
+        for (CollectionPtr included : _collections[i]->getIncludeCollections())
+        {
+            auto it = _collectionIndices.find(included.get());
+            if (it != _collectionIndices.end())
+            {
+                directIncludes[i].push_back(it->second);
+            }
+        }
+    }
+    _includingCollections.resize(_collections.size());
+    for (size_t i = 0; i < _collections.size(); i++)
+    {
+        vector<bool> visited(_collections.size(), false);
+        vector<bool> onPath(_collections.size(), false);
+        std::function<void(size_t)> visit = [&](size_t index)
+        {
+            visited[index] = true;
+            onPath[index] = true;
+            _includingCollections[index].push_back(i);
+            for (size_t included : directIncludes[index])
+            {
+                if (onPath[included])
+                {
+                    throw ExceptionFoundCycle("Encountered a cycle in collection: " + _collections[i]->getName());
+                }
+                if (!visited[included])
+                {
+                    visit(included);
+                }
+            }
+            onPath[index] = false;
+        };
+        visit(i);
+    }
+
+    // Index material assignments and their geometry paths.
+    std::unordered_map<const Element*, size_t> assignIndices;
+    _collectionAssigns.resize(_collections.size());
+    vector<LookPtr> looks = doc->getLooks();
+    for (size_t i = 0; i < looks.size(); i++)
+    {
+        _lookIndices[looks[i].get()] = i;
+        for (MaterialAssignPtr assign : looks[i]->getMaterialAssigns())
+        {
+            size_t index = _assigns.size();
+            _assigns.push_back(assign);
+            assignIndices[assign.get()] = index;
+            for (const string& path : splitString(assign->getActiveGeom(), ARRAY_VALID_SEPARATORS))
+            {
+                _nodes[addPath(path)].assigns.push_back(index);
+            }
+            CollectionPtr collection = assign->getCollection();
+            auto it = collection ? _collectionIndices.find(collection.get()) : _collectionIndices.end();
+            if (it != _collectionIndices.end())
+            {
+                _collectionAssigns[it->second].push_back(index);
+            }
+        }
+    }
+
+    // Store the active material assignments of each look.
+    _lookAssignPositions.resize(looks.size());
+    for (size_t i = 0; i < looks.size(); i++)
+    {
+        vector<MaterialAssignPtr> activeAssigns = looks[i]->getActiveMaterialAssigns();
+        for (size_t pos = 0; pos < activeAssigns.size(); pos++)
+        {
+            auto it = assignIndices.find(activeAssigns[pos].get());
+            if (it != assignIndices.end())
+            {
+                _lookAssignPositions[i].insert(std::make_pair(it->second, pos));
+            }
+        }
+    }
+
+    // Index geometry info elements and their geometry paths.
+    for (GeomInfoPtr geomInfo : doc->getGeomInfos())
+    {
+        size_t index = _geomInfos.size();
+        _geomInfos.push_back(geomInfo);
+        for (const string& path : splitString(geomInfo->getActiveGeom(), ARRAY_VALID_SEPARATORS))
+        {
+            _nodes[addPath(path)].geomInfos.push_back(index);
+        }
+    }
+
+    // Gather the element indices below each node.  Child nodes are always
+    // created after their parents, so a reverse pass visits children first.
+    for (size_t i = _nodes.size(); i-- > 0;)
+    {
+        PathNode& node = _nodes[i];
+        for (const auto& pair : node.children)
+        {
+            const PathNode& child = _nodes[pair.second];
+            appendIndices(node.descendantAssigns, child.assigns);
+            appendIndices(node.descendantAssigns, child.descendantAssigns);
+            appendIndices(node.descendantIncludes, child.includes);
+            appendIndices(node.descendantIncludes, child.descendantIncludes);
+            appendIndices(node.descendantGeomInfos, child.geomInfos);
+            appendIndices(node.descendantGeomInfos, child.descendantGeomInfos);
+        }
+        sortIndices(node.descendantAssigns);
+        sortIndices(node.descendantIncludes);
+        sortIndices(node.descendantGeomInfos);
+    }
+}
+
+LookResolver::~LookResolver()
+{
+}
+
+vector<MaterialAssignPtr> LookResolver::getMaterialAssigns(const string& geom, ConstLookPtr look) const
+{
+    return filterAssigns(matchAssigns(geom), look);
+}
+
+vector<vector<MaterialAssignPtr>> LookResolver::getMaterialAssigns(const StringVec& geoms,
+                                                                   ConstLookPtr look,
+                                                                   unsigned int threadCount) const
+{
+    vector<vector<MaterialAssignPtr>> results(geoms.size());
+    parallelFor(geoms.size(), [&](size_t i)
+    {
+        results[i] = filterAssigns(matchAssigns(geoms[i]), look);
+    }, threadCount);
+    return results;
+}
+
+vector<MaterialPtr> LookResolver::getBoundMaterials(const string& geom, ConstLookPtr look) const
+{
+    vector<MaterialPtr> materials;
+    for (MaterialAssignPtr assign : getMaterialAssigns(geom, look))
+    {
+        MaterialPtr material = assign->getReferencedMaterial();
+        if (material && std::find(materials.begin(), materials.end(), material) == materials.end())
+        {
+            materials.push_back(material);
+        }
+    }
+    return materials;
+}
+
+bool LookResolver::matchesCollection(ConstCollectionPtr collection, const string& geom) const
+{
+    auto it = _collectionIndices.find(collection.get());
+    if (it == _collectionIndices.end())
+    {
+        return collection->matchesGeomString(geom);
+    }
+    PathMatches matches;
+    matchPaths(geom, matches);
+    vector<size_t> collections = matchCollections(matches);
+    return std::binary_search(collections.begin(), collections.end(), it->second);
+}
+
+vector<GeomInfoPtr> LookResolver::getGeomInfos(const string& geom) const
+{
+    PathMatches matches;
+    matchPaths(geom, matches);
+    vector<GeomInfoPtr> geomInfos;
+    for (size_t index : matches.geomInfos)
+    {
+        geomInfos.push_back(_geomInfos[index]);
+    }
+    return geomInfos;
+}
+
+ValuePtr LookResolver::getGeomAttrValue(const string& geomAttrName, const string& geom) const
+{
+    ValuePtr value;
+    for (GeomInfoPtr geomInfo : getGeomInfos(geom))
+    {
+        GeomAttrPtr geomAttr = geomInfo->getGeomAttr(geomAttrName);
+        if (geomAttr)
+        {
+            value = geomAttr->getValue();
+        }
+    }
+    return value;
+}
+
+size_t LookResolver::addPath(const string& path)
+{
+    size_t index = 0;
+    for (const string& name : splitString(path, GEOM_PATH_SEPARATOR))
+    {
+        auto it = _nodes[index].children.find(name);
+        if (it != _nodes[index].children.end())
+        {
+            index = it->second;
+        }
+        else
+        {
+            size_t child = _nodes.size();
+            _nodes[index].children[name] = child;
+            _nodes.emplace_back();
+            index = child;
+        }
+    }
+    return index;
+}
+
+void LookResolver::matchPaths(const string& geom, PathMatches& matches) const
+{
+    const char* geomEnd = geom.data() + geom.size();
+    const char* pathBegin = std::find_if_not(geom.data(), geomEnd, isArraySeparator);
+    string name;
+    while (pathBegin != geomEnd)
+    {
+        const char* pathEnd = std::find_if(pathBegin, geomEnd, isArraySeparator);
+
+        // Paths ending at or above the current node contain the queried path.
+        const PathNode* node = &_nodes[0];
+        const char* nameBegin = std::find_if_not(pathBegin, pathEnd, isPathSeparator);
+        while (node)
+        {
+            appendIndices(matches.assigns, node->assigns);
+            appendIndices(matches.includes, node->includes);
+            appendIndices(matches.excludes, node->excludes);
+            appendIndices(matches.geomInfos, node->geomInfos);
+            if (nameBegin == pathEnd)
+            {
+                break;
+            }
+            const char* nameEnd = std::find_if(nameBegin, pathEnd, isPathSeparator);
+            name.assign(nameBegin, nameEnd);
+            auto it = node->children.find(name);
+            node = (it != node->children.end()) ? &_nodes[it->second] : nullptr;
+            nameBegin = std::find_if_not(nameEnd, pathEnd, isPathSeparator);
+        }
+
+        // Paths ending below the final node are contained by the queried path.
+        if (node)
+        {
+            appendIndices(matches.assigns, node->descendantAssigns);
+            appendIndices(matches.includes, node->descendantIncludes);
+            appendIndices(matches.geomInfos, node->descendantGeomInfos);
+        }
+
+        pathBegin = std::find_if_not(pathEnd, geomEnd, isArraySeparator);
+    }
+
+    sortIndices(matches.assigns);
+    sortIndices(matches.includes);
+    sortIndices(matches.excludes);
+    sortIndices(matches.geomInfos);
+}
+
+vector<size_t> LookResolver::matchCollections(const PathMatches& matches) const
+{
+    // A collection matches if it is not excluded, and if it or any collection
+    // in its include chain has a matching include that is not excluded.
+    vector<size_t> included;
+    std::set_difference(matches.includes.begin(), matches.includes.end(),
+                        matches.excludes.begin(), matches.excludes.end(),
+                        std::back_inserter(included));
+    vector<size_t> including;
+    for (size_t index : included)
+    {
+        appendIndices(including, _includingCollections[index]);
+    }
+    sortIndices(including);
+    vector<size_t> collections;
+    std::set_difference(including.begin(), including.end(),
+                        matches.excludes.begin(), matches.excludes.end(),
+                        std::back_inserter(collections));
+    return collections;
+}
+
+vector<size_t> LookResolver::matchAssigns(const string& geom) const
+{
+    PathMatches matches;
+    matchPaths(geom, matches);
+    vector<size_t> assigns = matches.assigns;
+    for (size_t index : matchCollections(matches))
+    {
+        appendIndices(assigns, _collectionAssigns[index]);
+    }
+    sortIndices(assigns);
+    return assigns;
+}
+
+vector<MaterialAssignPtr> LookResolver::filterAssigns(const vector<size_t>& assigns, ConstLookPtr look) const
+{
+    vector<MaterialAssignPtr> result;
+    if (!look)
+    {
+        for (size_t index : assigns)
+        {
+            result.push_back(_assigns[index]);
+        }
+        return result;
+    }
+
+    auto lookIt = _lookIndices.find(look.get());
+    if (lookIt == _lookIndices.end())
+    {
+        return result;
+    }
+    const std::unordered_map<size_t, size_t>& positions = _lookAssignPositions[lookIt->second];
+    vector<std::pair<size_t, size_t>> activeAssigns;
+    for (size_t index : assigns)
+    {
+        auto it = positions.find(index);
+        if (it != positions.end())
+        {
+            activeAssigns.push_back(std::make_pair(it->second, index));
+        }
+    }
+    std::sort(activeAssigns.begin(), activeAssigns.end());
+    for (const auto& pair : activeAssigns)
+    {
+        result.push_back(_assigns[pair.second]);
+    }
+    return result;
+}
+
 } // namespace MaterialX
@@ -15,14 +15,21 @@
 #include <MaterialXCore/Property.h>
 #include <MaterialXCore/Variant.h>
 
+#include <unordered_map>
+
 namespace MaterialX
 {
 
+class Document;
 class Look;
 class LookInherit;
+class LookResolver;
 class MaterialAssign;
 class Visibility;
 
+/// A shared pointer to a const Document
+using ConstDocumentPtr = shared_ptr<const Document>;
+
 /// A shared pointer to a Look
 using LookPtr = shared_ptr<Look>;
 /// A shared pointer to a const Look
@@ -439,6 +446,133 @@ class Visibility : public GeomElement
     static const string VISIBLE_ATTRIBUTE;
 };
 
+/// @class LookResolver
+/// A compiled index of the material assignments, collections, and geometry
+/// info elements of a document, optimized for resolving the elements that
+/// apply to large numbers of geometries.
+///
+/// The active geometry strings of all indexed elements are compiled into a
+/// single path trie, and collection include chains are expanded once when the
+/// resolver is created, so that the cost of each query is proportional to the
+/// depth of the queried path and the number of matching elements.  Query
+/// results are identical to those of Material::getGeometryBindings,
+/// Collection::matchesGeomString, and Document::getGeomAttrValue.
+///
+/// A resolver must be recreated after its source document is edited.  Queries
+/// may be made concurrently from multiple threads.
+class LookResolver
+{
+  public:
+    /// Create a resolver for the given document.
+    /// @throws ExceptionFoundCycle if a cycle is encountered in a collection
+    ///    include chain or a look inheritance chain.
+    explicit LookResolver(ConstDocumentPtr doc);
+    ~LookResolver();
+
+    /// @name Material Assignments
+    /// @{
+
+    /// Return all material assignments whose geometry or collection matches
+    /// the given geometry string.
+    /// @param geom The geometry string to be matched.
+    /// @param look An optional look.  If specified, then only the active
+    ///    material assignments of the look are returned, in the order of
+    ///    Look::getActiveMaterialAssigns.  Otherwise, the material assignments
+    ///    of all looks are returned in document order.
+    vector<MaterialAssignPtr> getMaterialAssigns(const string& geom, ConstLookPtr look = nullptr) const;
+
+    /// Return the material assignments for each of the given geometry
+    /// strings, resolving geometries in parallel.
+    /// @param geoms The geometry strings to be matched.
+    /// @param look An optional look, as in the single geometry form of this
+    ///    method.
+    /// @param threadCount The maximum number of threads to use.  If zero,
+    ///    then the hardware concurrency of the host is used.
+    /// @return A vector of material assignments for each geometry string,
+    ///    in the order of the given geometry strings.
+    vector<vector<MaterialAssignPtr>> getMaterialAssigns(const StringVec& geoms,
+                                                         ConstLookPtr look = nullptr,
+                                                         unsigned int threadCount = 0) const;
+
+    /// Return all materials bound to the given geometry string, in the
+    /// order of their material assignments.
+    vector<MaterialPtr> getBoundMaterials(const string& geom, ConstLookPtr look = nullptr) const;
+
+    /// @}
+    /// @name Collections
+    /// @{
+
+    /// Return true if the given collection and geometry string have any
+    /// geometries in common, taking included and excluded geometries into
+    /// account.
+    bool matchesCollection(ConstCollectionPtr collection, const string& geom) const;
+
+    /// @}
+    /// @name Geometry Info
+    /// @{
+
+    /// Return all geometry info elements whose geometry matches the given
+    /// geometry string, in document order.
+    vector<GeomInfoPtr> getGeomInfos(const string& geom) const;
+
+    /// Return the value of a geometric attribute for the given geometry
+    /// string, taking the last matching geometry info element into account.
+    ValuePtr getGeomAttrValue(const string& geomAttrName, const string& geom) const;
+
+    /// @}
+
+  private:
+    // A node in the geometry path trie.  Each element index is stored at the
+    // node where one of its geometry paths ends, and the descendant vectors
+    // hold the element indices stored anywhere below the node.
+    struct PathNode
+    {
+        std::unordered_map<string, size_t> children;
+        vector<size_t> assigns;
+        vector<size_t> includes;
+        vector<size_t> excludes;
+        vector<size_t> geomInfos;
+        vector<size_t> descendantAssigns;
+        vector<size_t> descendantIncludes;
+        vector<size_t> descendantGeomInfos;
+    };
+
+    // The element indices matched by a geometry string.
+    struct PathMatches
+    {
+        vector<size_t> assigns;
+        vector<size_t> includes;
+        vector<size_t> excludes;
+        vector<size_t> geomInfos;
+    };
+
+    size_t addPath(const string& path);
+    void matchPaths(const string& geom, PathMatches& matches) const;
+    vector<size_t> matchCollections(const PathMatches& matches) const;
+    vector<size_t> matchAssigns(const string& geom) const;
+    vector<MaterialAssignPtr> filterAssigns(const vector<size_t>& assigns, ConstLookPtr look) const;
+
+  private:
+    vector<PathNode> _nodes;
+
+    vector<MaterialAssignPtr> _assigns;
+    vector<CollectionPtr> _collections;
+    vector<GeomInfoPtr> _geomInfos;
+
+    std::unordered_map<const Element*, size_t> _collectionIndices;
+    std::unordered_map<const Element*, size_t> _lookIndices;
+
+    // For each collection, the collections whose include chains contain it,
+    // including the collection itself.
+    vector<vector<size_t>> _includingCollections;
+
+    // For each collection, the material assignments that reference it.
+    vector<vector<size_t>> _collectionAssigns;
+
+    // For each look, the position of each active material assignment.
+    vector<std::unordered_map<size_t, size_t>> _lookAssignPositions;
+};
+
 } // namespace MaterialX
 
 #endif
@@ -9,6 +9,7 @@
 #include <MaterialXCore/Material.h>
 
 #include <deque>
+#include <mutex>
 
 namespace MaterialX
 {
@@ -92,7 +93,8 @@ Edge Node::getUpstreamEdge(ConstMaterialPtr material, size_t index) const
     if (index < getUpstreamEdgeCount())
     {
         InputPtr input = getInputs()[index];
-        ElementPtr upstreamNode = input->getConnectedNode();
+        ConstGraphElementPtr graph = getParent() ? getParent()->asA<GraphElement>() : nullptr;
+        ElementPtr upstreamNode = graph ? graph->getIndexedConnectedNode(*input) : input->getConnectedNode();
         if (upstreamNode)
         {
             return Edge(getSelfNonConst(), input, upstreamNode);
@@ -153,14 +155,14 @@ OutputPtr Node::getNodeDefOutput(ElementPtr connectingElement)
 
 vector<PortElementPtr> Node::getDownstreamPorts() const
 {
-    vector<PortElementPtr> downstreamPorts;
-    for (PortElementPtr port : getDocument()->getMatchingPorts(getName()))
+    ConstElementPtr parent = getParent();
+    ConstGraphElementPtr graph = parent ? parent->getAncestorOfType<GraphElement>() : nullptr;
+    if (!graph)
     {
-        if (port->getConnectedNode() == getSelf())
-        {
-            downstreamPorts.push_back(port);
-        }
+        return vector<PortElementPtr>();
     }
+
+    vector<PortElementPtr> downstreamPorts = graph->getIndexedDownstreamPorts(*this);
     std::sort(downstreamPorts.begin(), downstreamPorts.end(), [](const ConstElementPtr& a, const ConstElementPtr& b)
     {
         return a->getName() > b->getName();
@@ -175,10 +177,161 @@ bool Node::validate(string* message) const
     return InterfaceElement::validate(message) && res;
 }
 
+//
+// GraphElement connection index
+//
+
+class GraphElement::ConnectionIndex
+{
+  public:
+    ConnectionIndex() :
+        valid(false)
+    {
+    }
+    ~ConnectionIndex() { }
+
+    // Rebuild the index if needed.  The caller is responsible for holding
+    // the index mutex.
+    void refresh(const GraphElement& graph)
+    {
+        if (valid)
+        {
+            return;
+        }
+
+        upstreamNodeMap.clear();
+        downstreamPortMap.clear();
+
+        // Gather all ports whose connections are resolved within this graph,
+        // excluding those owned by nested graphs.
+        TreeWalker walker;
+        for (ElementPtr child : graph.getChildren())
+        {
+            for (Element* elem = walker.begin(child.get()); elem; elem = walker.next())
+            {
+                if (dynamic_cast<GraphElement*>(elem))
+                {
+                    walker.setPruneSubtree(true);
+                    continue;
+                }
+                const string& nodeName = elem->getAttribute(PortElement::NODE_NAME_ATTRIBUTE);
+                if (nodeName.empty() || !dynamic_cast<PortElement*>(elem))
+                {
+                    continue;
+                }
+                NodePtr node = graph.getNode(nodeName);
+                if (node)
+                {
+                    addConnection(elem->getSelf()->asA<PortElement>(), node);
+                }
+            }
+        }
+
+        valid = true;
+    }
+
+    void addConnection(PortElementPtr port, NodePtr node)
+    {
+        upstreamNodeMap[port.get()] = node;
+        downstreamPortMap[node.get()].push_back(port);
+    }
+
+    void removeConnection(const PortElement* port)
+    {
+        auto it = upstreamNodeMap.find(port);
+        if (it == upstreamNodeMap.end())
+        {
+            return;
+        }
+        vector<PortElementPtr>& ports = downstreamPortMap[it->second.get()];
+        ports.erase(std::remove_if(ports.begin(), ports.end(), [port](const PortElementPtr& p)
+        {
+            return p.get() == port;
+        }), ports.end());
+        upstreamNodeMap.erase(it);
+    }
+
+    void clear()
+    {
+        upstreamNodeMap.clear();
+        downstreamPortMap.clear();
+        valid = false;
+    }
+
+  public:
+    std::mutex mutex;
+    bool valid;
+
+    std::unordered_map<const Element*, NodePtr> upstreamNodeMap;
+    std::unordered_map<const Element*, vector<PortElementPtr>> downstreamPortMap;
+};
+
 //
 // GraphElement methods
 //
 
+GraphElement::GraphElement(ElementPtr parent, const string& category, const string& name) :
+    InterfaceElement(parent, category, name),
+    _connectionIndex(new ConnectionIndex)
+{
+}
+
+GraphElement::~GraphElement()
+{
+}
+
+NodePtr GraphElement::getIndexedConnectedNode(const PortElement& port) const
+{
+    std::lock_guard<std::mutex> guard(_connectionIndex->mutex);
+    _connectionIndex->refresh(*this);
+    auto it = _connectionIndex->upstreamNodeMap.find(&port);
+    return (it != _connectionIndex->upstreamNodeMap.end()) ? it->second : NodePtr();
+}
+
+vector<PortElementPtr> GraphElement::getIndexedDownstreamPorts(const Node& node) const
+{
+    std::lock_guard<std::mutex> guard(_connectionIndex->mutex);
+    _connectionIndex->refresh(*this);
+    auto it = _connectionIndex->downstreamPortMap.find(&node);
+    return (it != _connectionIndex->downstreamPortMap.end()) ? it->second : vector<PortElementPtr>();
+}
+
+void GraphElement::updateConnectionIndex(PortElementPtr port, const string& nodeName) const
+{
+    std::lock_guard<std::mutex> guard(_connectionIndex->mutex);
+    if (!_connectionIndex->valid)
+    {
+        return;
+    }
+
+    // Apply the new connection in place, rather than invalidating the index.
+    _connectionIndex->removeConnection(port.get());
+    NodePtr node = nodeName.empty() ? nullptr : getNode(nodeName);
+    if (node)
+    {
+        _connectionIndex->addConnection(port, node);
+    }
+}
+
+void GraphElement::invalidateConnectionIndex() const
+{
+    std::lock_guard<std::mutex> guard(_connectionIndex->mutex);
+    _connectionIndex->clear();
+}
+
+size_t GraphElement::getConnectionIndexBytes() const
+{
+    std::lock_guard<std::mutex> guard(_connectionIndex->mutex);
+    size_t bytes = sizeof(ConnectionIndex) +
+                   getHashedHeapBytes(_connectionIndex->upstreamNodeMap) +
+                   getHashedHeapBytes(_connectionIndex->downstreamPortMap);
+    for (const auto& pair : _connectionIndex->downstreamPortMap)
+    {
+        bytes += getHeapBytes(pair.second);
+    }
+    return bytes;
+}
+
 void GraphElement::flattenSubgraphs(const string& target)
 {
     vector<NodePtr> processNodeVec = getNodes();
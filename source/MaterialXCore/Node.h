@@ -157,12 +157,9 @@ class Node : public InterfaceElement
 class GraphElement : public InterfaceElement
 {
   protected:
-    GraphElement(ElementPtr parent, const string& category, const string& name) :
-        InterfaceElement(parent, category, name)
-    {
-    }
+    GraphElement(ElementPtr parent, const string& category, const string& name);
   public:
-    virtual ~GraphElement() { }
+    virtual ~GraphElement();
 
     /// @name Node Elements
     /// @{
@@ -233,6 +230,32 @@ class GraphElement : public InterfaceElement
     string asStringDot() const;
 
     /// @}
+
+  private:
+    friend class Node;
+    friend class Document;
+
+    // Return the node connected to the given port, where the port lies within
+    // the connection scope of this graph.
+    NodePtr getIndexedConnectedNode(const PortElement& port) const;
+
+    // Return all ports within the connection scope of this graph that are
+    // connected to the given node, in no particular order.
+    vector<PortElementPtr> getIndexedDownstreamPorts(const Node& node) const;
+
+    // Update the connection index for a change to the node name of the given
+    // port, before the new node name has been applied.
+    void updateConnectionIndex(PortElementPtr port, const string& nodeName) const;
+
+    // Invalidate the connection index, which will be rebuilt on demand.
+    void invalidateConnectionIndex() const;
+
+    // Return the number of bytes held by the connection index.
+    size_t getConnectionIndexBytes() const;
+
+  private:
+    class ConnectionIndex;
+    std::unique_ptr<ConnectionIndex> _connectionIndex;
 };
 
 /// @class NodeGraph
@@ -56,6 +56,37 @@ class Observer
     /// Called when content is cleared from an element.
     virtual void onClearContent(ElementPtr) { }
 
+    /// Called when a set of changes is committed to the document by a
+    /// DocumentTransaction, or reverted and reapplied by its undo and redo
+    /// methods.  The default implementation reports each change through
+    /// the individual callbacks above, after the change has been applied.
+    virtual void onCommitChanges(const DocumentChangeSet& changes)
+    {
+        for (const DocumentChange& change : changes)
+        {
+            ElementPtr elem = change.getElement();
+            const string& attrib = change.getAttribute();
+            switch (change.getType())
+            {
+                case DocumentChange::TypeAddElement:
+                    onAddElement(elem->getParent(), elem);
+                    break;
+                case DocumentChange::TypeRemoveElement:
+                    onRemoveElement(elem->getParent(), elem);
+                    break;
+                case DocumentChange::TypeSetAttribute:
+                    onSetAttribute(elem, attrib, attrib == Element::NAME_ATTRIBUTE ?
+                                                 elem->getName() : elem->getAttribute(attrib));
+                    break;
+                case DocumentChange::TypeRemoveAttribute:
+                    onRemoveAttribute(elem, attrib);
+                    break;
+                case DocumentChange::TypeReorderChildren:
+                    break;
+            }
+        }
+    }
+
     /// Called when data is read into the current document.
     virtual void onRead() { }
 
@@ -195,6 +226,7 @@ class ObservedDocument : public Document
 
     void onCopyContent(ElementPtr elem) override
     {
+        Document::onCopyContent(elem);
         if (_callbacksEnabled)
         {
             for (auto& item : _observerMap)
@@ -206,6 +238,7 @@ class ObservedDocument : public Document
 
     void onClearContent(ElementPtr elem) override
     {
+        Document::onClearContent(elem);
         if (_callbacksEnabled)
         {
             for (auto& item : _observerMap)
@@ -215,6 +248,18 @@ class ObservedDocument : public Document
         }
     }
 
+    void onCommitChanges(const DocumentChangeSet& changes) override
+    {
+        Document::onCommitChanges(changes);
+        if (_callbacksEnabled)
+        {
+            for (auto& item : _observerMap)
+            {
+                item.second->onCommitChanges(changes);
+            }
+        }
+    }
+
     void onRead() override
     {
         if (_callbacksEnabled)
@@ -0,0 +1,433 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXCore/Transaction.h>
+
+#include <set>
+#include <unordered_set>
+
+namespace MaterialX
+{
+
+namespace {
+
+size_t findIndex(const StringVec& values, const string& value)
+{
+    return (size_t) std::distance(values.begin(), std::find(values.begin(), values.end(), value));
+}
+
+size_t findIndex(const vector<ElementPtr>& elems, const ElementPtr& elem)
+{
+    return (size_t) std::distance(elems.begin(), std::find(elems.begin(), elems.end(), elem));
+}
+
+// Return true if the given element or one of its ancestors is in the given
+// set.  Removed elements retain their parent pointers, so the ancestors of
+// removed elements may be checked in the same way.
+bool hasAncestorInSet(ConstElementPtr elem, const std::unordered_set<const Element*>& elems)
+{
+    for (; elem; elem = elem->getParent())
+    {
+        if (elems.count(elem.get()))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // anonymous namespace
+
+//
+// DocumentTransaction methods
+//
+
+DocumentTransaction::DocumentTransaction(DocumentPtr doc) :
+    _doc(doc),
+    _open(true),
+    _undone(false),
+    _replaying(false)
+{
+    if (_doc->_transaction)
+    {
+        throw Exception("Document already has an open transaction");
+    }
+    _doc->_transaction = this;
+}
+
+DocumentTransaction::~DocumentTransaction()
+{
+    commit();
+}
+
+size_t DocumentTransaction::getEditCount() const
+{
+    return _journal.size();
+}
+
+void DocumentTransaction::commit()
+{
+    if (!_open)
+    {
+        return;
+    }
+    _open = false;
+    _doc->_transaction = nullptr;
+    deliverChanges(createChangeSet(false));
+}
+
+void DocumentTransaction::undo()
+{
+    if (!canUndo())
+    {
+        throw Exception("Transaction cannot be undone");
+    }
+    replay(true);
+    _undone = true;
+    deliverChanges(createChangeSet(true));
+}
+
+void DocumentTransaction::redo()
+{
+    if (!canRedo())
+    {
+        throw Exception("Transaction cannot be redone");
+    }
+    replay(false);
+    _undone = false;
+    deliverChanges(createChangeSet(false));
+}
+
+void DocumentTransaction::recordSetAttribute(ElementPtr elem, const string& attrib, const string& value)
+{
+    if (!_replaying)
+    {
+        if (attrib == Element::NAME_ATTRIBUTE)
+        {
+            Edit edit(Edit::SetName, elem);
+            edit.value = elem->getName();
+            _journal.push_back(std::move(edit));
+        }
+        else if (!hasAttributeEdit(elem, attrib))
+        {
+            Edit edit(Edit::SetAttribute, elem);
+            edit.attribute = attrib;
+            edit.hasValue = elem->hasAttribute(attrib);
+            if (edit.hasValue)
+            {
+                edit.value = elem->getAttribute(attrib);
+                edit.index = findIndex(elem->_attributeOrder, attrib);
+            }
+            _journal.push_back(std::move(edit));
+        }
+    }
+    _doc->Document::onSetAttribute(elem, attrib, value);
+}
+
+bool DocumentTransaction::hasAttributeEdit(ElementPtr elem, const string& attrib) const
+{
+    // Repeated edits to an existing attribute share the journal entry of the
+    // first edit, which holds its original value.  Only the trailing run of
+    // attribute edits to the same element is searched, so that edits such as
+    // value and type pairs are coalesced in constant time.
+    if (!elem->hasAttribute(attrib))
+    {
+        return false;
+    }
+    for (auto it = _journal.rbegin(); it != _journal.rend(); ++it)
+    {
+        if (it->type != Edit::SetAttribute || it->element != elem)
+        {
+            break;
+        }
+        if (it->attribute == attrib)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void DocumentTransaction::recordRemoveAttribute(ElementPtr elem, const string& attrib)
+{
+    if (!_replaying)
+    {
+        Edit edit(Edit::SetAttribute, elem);
+        edit.attribute = attrib;
+        edit.hasValue = true;
+        edit.value = elem->getAttribute(attrib);
+        edit.index = findIndex(elem->_attributeOrder, attrib);
+        _journal.push_back(std::move(edit));
+    }
+    _doc->Document::onRemoveAttribute(elem, attrib);
+}
+
+void DocumentTransaction::recordAddElement(ElementPtr parent, ElementPtr child)
+{
+    if (!_replaying)
+    {
+        Edit edit(Edit::AddElement, parent);
+        edit.child = child;
+        edit.index = parent->_childOrder.size();
+        _journal.push_back(std::move(edit));
+    }
+    _doc->Document::onAddElement(parent, child);
+}
+
+void DocumentTransaction::recordRemoveElement(ElementPtr parent, ElementPtr child)
+{
+    if (!_replaying)
+    {
+        Edit edit(Edit::RemoveElement, parent);
+        edit.child = child;
+        edit.index = findIndex(parent->_childOrder, child);
+        _journal.push_back(std::move(edit));
+    }
+    _doc->Document::onRemoveElement(parent, child);
+}
+
+void DocumentTransaction::recordSetChildIndex(ElementPtr parent, ElementPtr child, size_t oldIndex)
+{
+    if (!_replaying)
+    {
+        Edit edit(Edit::SetChildIndex, parent);
+        edit.child = child;
+        edit.index = oldIndex;
+        _journal.push_back(std::move(edit));
+    }
+}
+
+void DocumentTransaction::recordCopyContent(ElementPtr elem)
+{
+    recordContent(elem);
+    _doc->Document::onCopyContent(elem);
+}
+
+void DocumentTransaction::recordClearContent(ElementPtr elem)
+{
+    recordContent(elem);
+    _doc->Document::onClearContent(elem);
+}
+
+void DocumentTransaction::recordContent(ElementPtr elem)
+{
+    if (!_replaying)
+    {
+        Edit edit(Edit::SetContent, elem);
+        edit.content = std::make_shared<Content>();
+        edit.content->attributeMap = elem->_attributeMap;
+        edit.content->attributeOrder = elem->_attributeOrder;
+        edit.content->sourceUri = elem->_sourceUri;
+        _journal.push_back(std::move(edit));
+    }
+}
+
+void DocumentTransaction::replay(bool reverse)
+{
+    // Route edits made during the replay through this transaction, so that
+    // the document maintains its own state without notifying observers.
+    _doc->_transaction = this;
+    _replaying = true;
+    try
+    {
+        for (size_t i = 0; i < _journal.size(); i++)
+        {
+            Edit& edit = _journal[reverse ? _journal.size() - 1 - i : i];
+            ElementPtr elem = edit.element;
+            switch (edit.type)
+            {
+                case Edit::SetAttribute:
+                {
+                    bool hasValue = elem->hasAttribute(edit.attribute);
+                    string value = elem->getAttribute(edit.attribute);
+                    size_t index = findIndex(elem->_attributeOrder, edit.attribute);
+                    if (edit.hasValue)
+                    {
+                        elem->setAttribute(edit.attribute, edit.value);
+                        StringVec& order = elem->_attributeOrder;
+                        size_t currentIndex = findIndex(order, edit.attribute);
+                        if (currentIndex != edit.index && edit.index < order.size())
+                        {
+                            order.erase(order.begin() + currentIndex);
+                            order.insert(order.begin() + edit.index, edit.attribute);
+                        }
+                    }
+                    else
+                    {
+                        elem->removeAttribute(edit.attribute);
+                    }
+                    edit.hasValue = hasValue;
+                    edit.value = std::move(value);
+                    edit.index = index;
+                    break;
+                }
+                case Edit::SetName:
+                {
+                    string name = elem->getName();
+                    elem->setName(edit.value);
+                    edit.value = std::move(name);
+                    break;
+                }
+                case Edit::AddElement:
+                case Edit::RemoveElement:
+                {
+                    ElementPtr child = edit.child;
+                    vector<ElementPtr>& children = elem->_childOrder;
+                    size_t index = findIndex(children, child);
+                    if (index < children.size())
+                    {
+                        elem->unregisterChildElement(child);
+                        edit.index = index;
+                    }
+                    else
+                    {
+                        child->invalidateScope();
+                        elem->registerChildElement(child);
+                        if (edit.index < children.size() - 1)
+                        {
+                            children.pop_back();
+                            children.insert(children.begin() + edit.index, child);
+                        }
+                    }
+                    break;
+                }
+                case Edit::SetChildIndex:
+                {
+                    size_t index = findIndex(elem->_childOrder, edit.child);
+                    elem->setChildIndex(edit.child->getName(), (int) edit.index);
+                    edit.index = index;
+                    break;
+                }
+                case Edit::SetContent:
+                {
+                    _doc->Document::onCopyContent(elem);
+                    std::swap(elem->_attributeMap, edit.content->attributeMap);
+                    std::swap(elem->_attributeOrder, edit.content->attributeOrder);
+                    std::swap(elem->_sourceUri, edit.content->sourceUri);
+                    elem->invalidateScope();
+                    break;
+                }
+            }
+        }
+    }
+    catch (...)
+    {
+        _replaying = false;
+        _doc->_transaction = nullptr;
+        throw;
+    }
+    _replaying = false;
+    _doc->_transaction = nullptr;
+}
+
+DocumentChangeSet DocumentTransaction::createChangeSet(bool reverse) const
+{
+    // Track the net additions and removals of elements, and the attributes
+    // and child orders edited, in order of first occurrence.
+    std::unordered_set<const Element*> addedElements;
+    std::unordered_set<const Element*> removedElements;
+    std::set<std::pair<const Element*, string>> editedKeys;
+    vector<std::pair<ElementPtr, string>> editedAttributes;
+    vector<ElementPtr> structuralElements;
+    auto addEditedAttribute = [&editedKeys, &editedAttributes](const ElementPtr& elem, const string& attrib)
+    {
+        if (editedKeys.insert(std::make_pair(elem.get(), attrib)).second)
+        {
+            editedAttributes.push_back(std::make_pair(elem, attrib));
+        }
+    };
+
+    for (size_t i = 0; i < _journal.size(); i++)
+    {
+        const Edit& edit = _journal[reverse ? _journal.size() - 1 - i : i];
+        switch (edit.type)
+        {
+            case Edit::SetAttribute:
+                addEditedAttribute(edit.element, edit.attribute);
+                break;
+            case Edit::SetName:
+                addEditedAttribute(edit.element, Element::NAME_ATTRIBUTE);
+                break;
+            case Edit::AddElement:
+            case Edit::RemoveElement:
+            {
+                const Element* child = edit.child.get();
+                bool added = (edit.type == Edit::AddElement) != reverse;
+                std::unordered_set<const Element*>& opposite = added ? removedElements : addedElements;
+                if (!opposite.erase(child))
+                {
+                    (added ? addedElements : removedElements).insert(child);
+                    structuralElements.push_back(edit.child);
+                }
+                break;
+            }
+            case Edit::SetChildIndex:
+                addEditedAttribute(edit.element, EMPTY_STRING);
+                break;
+            case Edit::SetContent:
+                for (const string& attrib : edit.content->attributeOrder)
+                {
+                    addEditedAttribute(edit.element, attrib);
+                }
+                for (const string& attrib : edit.element->_attributeOrder)
+                {
+                    addEditedAttribute(edit.element, attrib);
+                }
+                break;
+        }
+    }
+
+    // Report each added or removed subtree by its root, and omit edits
+    // within added and removed subtrees.
+    DocumentChangeSet changes;
+    std::unordered_set<const Element*> reportedElements;
+    for (const ElementPtr& elem : structuralElements)
+    {
+        bool added = addedElements.count(elem.get()) != 0;
+        bool removed = removedElements.count(elem.get()) != 0;
+        ElementPtr parent = elem->getParent();
+        if ((added || removed) &&
+            !hasAncestorInSet(parent, addedElements) &&
+            !hasAncestorInSet(parent, removedElements) &&
+            reportedElements.insert(elem.get()).second)
+        {
+            changes.emplace_back(added ? DocumentChange::TypeAddElement : DocumentChange::TypeRemoveElement, elem);
+        }
+    }
+    for (const auto& pair : editedAttributes)
+    {
+        const ElementPtr& elem = pair.first;
+        const string& attrib = pair.second;
+        if (hasAncestorInSet(elem, addedElements) || hasAncestorInSet(elem, removedElements))
+        {
+            continue;
+        }
+        if (attrib.empty())
+        {
+            changes.emplace_back(DocumentChange::TypeReorderChildren, elem);
+        }
+        else if (attrib == Element::NAME_ATTRIBUTE || elem->hasAttribute(attrib))
+        {
+            changes.emplace_back(DocumentChange::TypeSetAttribute, elem, attrib);
+        }
+        else
+        {
+            changes.emplace_back(DocumentChange::TypeRemoveAttribute, elem, attrib);
+        }
+    }
+    return changes;
+}
+
+void DocumentTransaction::deliverChanges(const DocumentChangeSet& changes)
+{
+    if (changes.empty())
+    {
+        return;
+    }
+    ScopedUpdate update(_doc);
+    _doc->onCommitChanges(changes);
+}
+
+} // namespace MaterialX
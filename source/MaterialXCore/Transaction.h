@@ -0,0 +1,197 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#ifndef MATERIALX_TRANSACTION
+#define MATERIALX_TRANSACTION
+
+/// @file
+/// Document transaction classes
+
+#include <MaterialXCore/Document.h>
+
+namespace MaterialX
+{
+
+/// @class DocumentTransaction
+/// A set of edits to a Document, which are delivered to the document and
+/// its observers as a single coalesced change set, and which may be undone
+/// and redone.
+///
+/// While a transaction is open, edits to its document are recorded in a
+/// compact change journal, holding previous attribute values and references
+/// to added and removed subtrees, rather than being sent as individual
+/// callbacks.  When the transaction is committed, Document::onCommitChanges
+/// is called once with the coalesced changes.  Undo and redo operations
+/// replay the journal, with time and memory proportional to the number of
+/// recorded edits rather than the size of the document.
+///
+/// A document may have at most one open transaction at a time, and undo and
+/// redo operations are valid only when applied in stack order with respect
+/// to other transactions on the same document.
+///
+/// A transaction registers itself with its document for its lifetime, and
+/// should be declared as a local object in the scope of its edits.  It may
+/// not be copied or moved.
+class DocumentTransaction
+{
+  public:
+    /// Open a new transaction on the given document.
+    /// @throws Exception if the document already has an open transaction.
+    explicit DocumentTransaction(DocumentPtr doc);
+
+    /// Destroy the transaction, committing it if it is still open.
+    ~DocumentTransaction();
+
+    /// @name Transaction State
+    /// @{
+
+    /// Return the document of this transaction.
+    DocumentPtr getDocument() const
+    {
+        return _doc;
+    }
+
+    /// Return true if this transaction is open for recording edits.
+    bool isOpen() const
+    {
+        return _open;
+    }
+
+    /// Return the number of edits recorded in the change journal.
+    size_t getEditCount() const;
+
+    /// Commit this transaction, closing it for further edits and delivering
+    /// its changes to the document.  Committing a closed transaction has
+    /// no effect.
+    void commit();
+
+    /// @}
+    /// @name Undo and Redo
+    /// @{
+
+    /// Return true if the edits of this transaction may be undone.
+    bool canUndo() const
+    {
+        return !_open && !_undone && _doc->_transaction == nullptr;
+    }
+
+    /// Return true if the edits of this transaction may be redone.
+    bool canRedo() const
+    {
+        return !_open && _undone && _doc->_transaction == nullptr;
+    }
+
+    /// Revert all edits of this committed transaction.
+    /// @throws Exception if the transaction cannot be undone.
+    void undo();
+
+    /// Reapply all edits of this transaction, after a call to undo.
+    /// @throws Exception if the transaction cannot be redone.
+    void redo();
+
+    /// @}
+
+  private:
+    DocumentTransaction(const DocumentTransaction&) = delete;
+    DocumentTransaction& operator=(const DocumentTransaction&) = delete;
+    DocumentTransaction(DocumentTransaction&&) = delete;
+    DocumentTransaction& operator=(DocumentTransaction&&) = delete;
+
+    friend class Element;
+
+    // Record an edit to an attribute, including the name attribute, before
+    // the new value has been applied.
+    void recordSetAttribute(ElementPtr elem, const string& attrib, const string& value);
+
+    // Record the removal of an attribute, before it has been applied.
+    void recordRemoveAttribute(ElementPtr elem, const string& attrib);
+
+    // Record the addition of a child, before it has been applied.
+    void recordAddElement(ElementPtr parent, ElementPtr child);
+
+    // Record the removal of a child, before it has been applied.
+    void recordRemoveElement(ElementPtr parent, ElementPtr child);
+
+    // Record a change to the index of a child, after it has been applied.
+    void recordSetChildIndex(ElementPtr parent, ElementPtr child, size_t oldIndex);
+
+    // Record the copying of content into an element, before it has been
+    // applied.  Children copied into the element are recorded separately.
+    void recordCopyContent(ElementPtr elem);
+
+    // Record the clearing of content from an element, before it has been
+    // applied.  Children removed from the element are recorded separately.
+    void recordClearContent(ElementPtr elem);
+
+  private:
+    // The attributes and source URI of an element.
+    struct Content
+    {
+        StringMap attributeMap;
+        StringVec attributeOrder;
+        string sourceUri;
+    };
+
+    // A single recorded edit, holding the state of the document on the
+    // other side of the edit from its current state.
+    struct Edit
+    {
+        enum Type
+        {
+            SetAttribute,
+            SetName,
+            AddElement,
+            RemoveElement,
+            SetChildIndex,
+            SetContent
+        };
+
+        Edit(Type type, ElementPtr element) :
+            type(type),
+            element(element),
+            hasValue(false),
+            index(0)
+        {
+        }
+
+        Type type;
+        ElementPtr element;
+        ElementPtr child;
+        string attribute;
+        string value;
+        bool hasValue;
+        size_t index;
+        shared_ptr<Content> content;
+    };
+
+    // Return true if the given attribute edit may be coalesced into an
+    // existing journal entry.
+    bool hasAttributeEdit(ElementPtr elem, const string& attrib) const;
+
+    // Record the current content of the given element.
+    void recordContent(ElementPtr elem);
+
+    // Swap the state recorded by each edit with the current state of the
+    // document, in reverse order when undoing.
+    void replay(bool reverse);
+
+    // Return the coalesced changes of the journal, with respect to the
+    // current state of the document.
+    DocumentChangeSet createChangeSet(bool reverse) const;
+
+    // Deliver the given changes to the document as a single update.
+    void deliverChanges(const DocumentChangeSet& changes);
+
+  private:
+    DocumentPtr _doc;
+    vector<Edit> _journal;
+    bool _open;
+    bool _undone;
+    bool _replaying;
+};
+
+} // namespace MaterialX
+
+#endif
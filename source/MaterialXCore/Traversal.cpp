@@ -5,6 +5,7 @@
 
 #include <MaterialXCore/Traversal.h>
 
+#include <MaterialXCore/Material.h>
 #include <MaterialXCore/Node.h>
 
 namespace MaterialX
@@ -16,6 +17,9 @@ const TreeIterator NULL_TREE_ITERATOR(nullptr);
 const GraphIterator NULL_GRAPH_ITERATOR(nullptr, nullptr);
 const InheritanceIterator NULL_INHERITANCE_ITERATOR(nullptr);
 
+const size_t GraphPathSet::SMALL_PATH_SIZE = 16;
+const size_t GraphSnapshot::INVALID_ID = (size_t) -1;
+
 //
 // Edge methods
 //
@@ -47,36 +51,107 @@ TreeIterator& TreeIterator::operator++()
         return *this;
     }
 
+    _walker.setPruneSubtree(_prune);
+    _prune = false;
+    _walker.next();
+    return *this;
+}
+
+//
+// BasicTreeWalker methods
+//
+
+namespace {
+
+template <class T> T toWalkerPointer(const ElementPtr& elem);
+
+template <> Element* toWalkerPointer(const ElementPtr& elem)
+{
+    return elem.get();
+}
+
+template <> ElementPtr toWalkerPointer(const ElementPtr& elem)
+{
+    return elem;
+}
+
+} // anonymous namespace
+
+template <class T> const T& BasicTreeWalker<T>::next()
+{
     if (!_prune && _elem && !_elem->getChildren().empty())
     {
         // Traverse to the first child of this element.
         _stack.push_back(StackFrame(_elem, 0));
-        _elem = _elem->getChildren()[0];
-        return *this;
+        _elem = toWalkerPointer<T>(_elem->getChildren()[0]);
+        return _elem;
     }
     _prune = false;
 
-    while (true)
+    while (!_stack.empty())
     {
-        if (_stack.empty())
-        {
-            // Traversal is complete.
-            _elem = ElementPtr();
-            return *this;
-        }
-
         // Traverse to our siblings.
         StackFrame& parentFrame = _stack.back();
         const vector<ElementPtr>& siblings = parentFrame.first->getChildren();
         if (parentFrame.second + 1 < siblings.size())
         {
-            _elem = siblings[++parentFrame.second];
-            return *this;
+            _elem = toWalkerPointer<T>(siblings[++parentFrame.second]);
+            return _elem;
         }
 
         // Traverse to our parent's siblings.
         _stack.pop_back();
     }
+
+    // Traversal is complete.
+    _elem = T();
+    return _elem;
+}
+
+template class BasicTreeWalker<Element*>;
+template class BasicTreeWalker<ElementPtr>;
+
+//
+// GraphPathSet methods
+//
+
+void GraphPathSet::push(const Element* elem)
+{
+    _path.push_back(elem);
+    if (!_set.empty())
+    {
+        _set.insert(elem);
+    }
+    else if (_path.size() > SMALL_PATH_SIZE)
+    {
+        _set.insert(_path.begin(), _path.end());
+    }
+}
+
+void GraphPathSet::erase(const Element* elem)
+{
+    if (!_path.empty() && _path.back() == elem)
+    {
+        _path.pop_back();
+    }
+    else
+    {
+        auto it = std::find(_path.begin(), _path.end(), elem);
+        if (it == _path.end())
+        {
+            return;
+        }
+        _path.erase(it);
+    }
+
+    if (_path.size() > SMALL_PATH_SIZE)
+    {
+        _set.erase(elem);
+    }
+    else
+    {
+        _set.clear();
+    }
 }
 
 //
@@ -86,7 +161,7 @@ TreeIterator& TreeIterator::operator++()
 size_t GraphIterator::getNodeDepth() const
 {
     size_t nodeDepth = 0;
-    for (ElementPtr elem : _pathElems)
+    for (const Element* elem : _pathElems.getElements())
     {
         if (elem->isA<Node>())
         {
@@ -160,24 +235,113 @@ GraphIterator& GraphIterator::operator++()
 void GraphIterator::extendPathUpstream(ElementPtr upstreamElem, ElementPtr connectingElem)
 {
     // Check for cycles.
-    if (_pathElems.count(upstreamElem))
+    if (_pathElems.contains(upstreamElem.get()))
     {
         throw ExceptionFoundCycle("Encountered cycle at element: " + upstreamElem->asString());
     }
 
     // Extend the current path to the new element.
-    _pathElems.insert(upstreamElem);
+    _pathElems.push(upstreamElem.get());
     _upstreamElem = upstreamElem;
     _connectingElem = connectingElem;
 }
 
 void GraphIterator::returnPathDownstream(ElementPtr upstreamElem)
 {
-    _pathElems.erase(upstreamElem);
+    _pathElems.erase(upstreamElem.get());
     _upstreamElem = ElementPtr();
     _connectingElem = ElementPtr();
 }
 
+//
+// GraphWalker methods
+//
+
+Element* GraphWalker::begin(Element* root, ConstMaterialPtr material)
+{
+    _upstreamElem = root;
+    _connectingElem = nullptr;
+    _pathElems.clear();
+    _pathElems.push(root);
+    _material = material;
+    _stack.clear();
+    _prune = false;
+
+    // Advance once to generate a valid edge.
+    return next();
+}
+
+Element* GraphWalker::next()
+{
+    if (!_prune && _upstreamElem && _upstreamElem->getUpstreamEdgeCount())
+    {
+        // Traverse to the first upstream edge of this element.
+        _stack.push_back(StackFrame(_upstreamElem, 0));
+        Edge nextEdge = _upstreamElem->getUpstreamEdge(_material, 0);
+        if (nextEdge)
+        {
+            extendPathUpstream(nextEdge);
+            return _upstreamElem;
+        }
+    }
+    _prune = false;
+
+    while (true)
+    {
+        if (_upstreamElem)
+        {
+            returnPathDownstream(_upstreamElem);
+        }
+
+        if (_stack.empty())
+        {
+            // Traversal is complete.
+            _pathElems.clear();
+            _material = nullptr;
+            return nullptr;
+        }
+
+        // Traverse to our siblings.
+        StackFrame& parentFrame = _stack.back();
+        if (parentFrame.second + 1 < parentFrame.first->getUpstreamEdgeCount())
+        {
+            Edge nextEdge = parentFrame.first->getUpstreamEdge(_material, ++parentFrame.second);
+            if (nextEdge)
+            {
+                extendPathUpstream(nextEdge);
+                return _upstreamElem;
+            }
+            continue;
+        }
+
+        // Traverse to our parent's siblings.
+        returnPathDownstream(parentFrame.first);
+        _stack.pop_back();
+    }
+}
+
+void GraphWalker::extendPathUpstream(const Edge& edge)
+{
+    // Check for cycles.
+    ElementPtr upstreamElem = edge.getUpstreamElement();
+    if (_pathElems.contains(upstreamElem.get()))
+    {
+        throw ExceptionFoundCycle("Encountered cycle at element: " + upstreamElem->asString());
+    }
+
+    // Extend the current path to the new element.
+    _pathElems.push(upstreamElem.get());
+    _upstreamElem = upstreamElem.get();
+    _connectingElem = edge.getConnectingElement().get();
+}
+
+void GraphWalker::returnPathDownstream(Element* upstreamElem)
+{
+    _pathElems.erase(upstreamElem);
+    _upstreamElem = nullptr;
+    _connectingElem = nullptr;
+}
+
 //
 // InheritanceIterator methods
 //
@@ -216,4 +380,178 @@ InheritanceIterator& InheritanceIterator::operator++()
     return *this;
 }
 
+//
+// GraphSnapshot methods
+//
+
+GraphSnapshot::GraphSnapshot(ConstGraphElementPtr graph)
+{
+    for (ElementPtr child : graph->getChildren())
+    {
+        _elementIds[child.get()] = _elements.size();
+        _elements.push_back(child);
+    }
+    build(nullptr);
+}
+
+GraphSnapshot::GraphSnapshot(ConstMaterialPtr material)
+{
+    for (ShaderRefPtr shaderRef : material->getShaderRefs())
+    {
+        _elementIds[shaderRef.get()] = _elements.size();
+        _elements.push_back(shaderRef);
+    }
+    build(material);
+}
+
+GraphSnapshot::GraphSnapshot(const vector<ElementPtr>& roots, ConstMaterialPtr material)
+{
+    for (ElementPtr root : roots)
+    {
+        if (root && !_elementIds.count(root.get()))
+        {
+            _elementIds[root.get()] = _elements.size();
+            _elements.push_back(root);
+        }
+    }
+    build(material);
+}
+
+size_t GraphSnapshot::getElementId(ConstElementPtr elem) const
+{
+    auto it = _elementIds.find(elem.get());
+    return (it != _elementIds.end()) ? it->second : INVALID_ID;
+}
+
+bool GraphSnapshot::isUpstream(size_t upstreamId, size_t downstreamId) const
+{
+    vector<char> visited(_elements.size(), 0);
+    vector<size_t> stack(1, downstreamId);
+    visited[downstreamId] = 1;
+    while (!stack.empty())
+    {
+        size_t id = stack.back();
+        stack.pop_back();
+        for (size_t upId : getUpstreamIds(id))
+        {
+            if (upId == upstreamId)
+            {
+                return true;
+            }
+            if (!visited[upId])
+            {
+                visited[upId] = 1;
+                stack.push_back(upId);
+            }
+        }
+    }
+    return false;
+}
+
+vector<size_t> GraphSnapshot::getUpstreamClosure(size_t id) const
+{
+    vector<size_t> closure;
+    vector<char> visited(_elements.size(), 0);
+    vector<size_t> stack(1, id);
+    visited[id] = 1;
+    while (!stack.empty())
+    {
+        size_t currentId = stack.back();
+        stack.pop_back();
+        if (currentId != id)
+        {
+            closure.push_back(currentId);
+        }
+        IdRange upstreamIds = getUpstreamIds(currentId);
+        for (size_t i = upstreamIds.size(); i-- > 0; )
+        {
+            size_t upId = upstreamIds[i];
+            if (!visited[upId])
+            {
+                visited[upId] = 1;
+                stack.push_back(upId);
+            }
+        }
+    }
+    return closure;
+}
+
+void GraphSnapshot::build(ConstMaterialPtr material)
+{
+    // Resolve upstream edges, assigning IDs to newly discovered elements as
+    // they are encountered.  Since elements are visited in ID order, the
+    // upstream arrays are written directly in compressed row form.
+    for (size_t id = 0; id < _elements.size(); id++)
+    {
+        _upstreamOffsets.push_back(_upstreamIds.size());
+        ElementPtr elem = _elements[id];
+        for (size_t i = 0; i < elem->getUpstreamEdgeCount(); i++)
+        {
+            Edge edge = elem->getUpstreamEdge(material, i);
+            ElementPtr upstreamElem = edge.getUpstreamElement();
+            if (!upstreamElem)
+            {
+                continue;
+            }
+            auto it = _elementIds.find(upstreamElem.get());
+            size_t upstreamId = _elements.size();
+            if (it != _elementIds.end())
+            {
+                upstreamId = it->second;
+            }
+            else
+            {
+                _elementIds[upstreamElem.get()] = upstreamId;
+                _elements.push_back(upstreamElem);
+            }
+            _upstreamIds.push_back(upstreamId);
+            _connectingElements.push_back(edge.getConnectingElement());
+        }
+    }
+    _upstreamOffsets.push_back(_upstreamIds.size());
+
+    // Invert the upstream arrays to generate downstream arrays.
+    const size_t elementCount = _elements.size();
+    _downstreamOffsets.assign(elementCount + 1, 0);
+    for (size_t upstreamId : _upstreamIds)
+    {
+        _downstreamOffsets[upstreamId + 1]++;
+    }
+    for (size_t id = 0; id < elementCount; id++)
+    {
+        _downstreamOffsets[id + 1] += _downstreamOffsets[id];
+    }
+    _downstreamIds.resize(_upstreamIds.size());
+    vector<size_t> insertOffsets(_downstreamOffsets.begin(), _downstreamOffsets.end() - 1);
+    for (size_t id = 0; id < elementCount; id++)
+    {
+        for (size_t upstreamId : getUpstreamIds(id))
+        {
+            _downstreamIds[insertOffsets[upstreamId]++] = id;
+        }
+    }
+
+    // Compute a topological order using Kahn's algorithm.  Elements on or
+    // downstream of a cycle never reach an in-degree of zero.
+    vector<size_t> inDegree(elementCount);
+    for (size_t id = 0; id < elementCount; id++)
+    {
+        inDegree[id] = _upstreamOffsets[id + 1] - _upstreamOffsets[id];
+        if (inDegree[id] == 0)
+        {
+            _topologicalOrder.push_back(id);
+        }
+    }
+    for (size_t i = 0; i < _topologicalOrder.size(); i++)
+    {
+        for (size_t downstreamId : getDownstreamIds(_topologicalOrder[i]))
+        {
+            if (--inDegree[downstreamId] == 0)
+            {
+                _topologicalOrder.push_back(downstreamId);
+            }
+        }
+    }
+}
+
 } // namespace MaterialX
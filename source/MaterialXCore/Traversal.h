@@ -11,14 +11,18 @@
 
 #include <MaterialXCore/Library.h>
 
+#include <unordered_set>
+
 namespace MaterialX
 {
 
 class Element;
+class GraphElement;
 class Material;
 
 using ElementPtr = shared_ptr<Element>;
 using ConstElementPtr = shared_ptr<const Element>;
+using ConstGraphElementPtr = shared_ptr<const GraphElement>;
 using ConstMaterialPtr = shared_ptr<const Material>;
 
 /// @class Edge
@@ -84,29 +88,116 @@ class Edge
     ElementPtr _elemUp;
 };
 
+/// @class BasicTreeWalker
+/// A lightweight object for traversal of an element tree, which holds the
+/// current element and its ancestors by the given pointer type.
+///
+/// The walker retains its internal storage when reused for additional
+/// traversals.  TreeWalker and TreeIterator are implemented on top of this
+/// class.
+template <class T> class BasicTreeWalker
+{
+  public:
+    BasicTreeWalker() :
+        _elem(),
+        _prune(false)
+    {
+    }
+    ~BasicTreeWalker() { }
+
+    bool operator==(const BasicTreeWalker& rhs) const
+    {
+        return _elem == rhs._elem &&
+               _stack == rhs._stack &&
+               _prune == rhs._prune;
+    }
+    bool operator!=(const BasicTreeWalker& rhs) const
+    {
+        return !(*this == rhs);
+    }
+
+    /// Begin a traversal of the tree rooted at the given element, returning
+    /// the root element.
+    const T& begin(const T& root)
+    {
+        _elem = root;
+        _stack.clear();
+        _prune = false;
+        return _elem;
+    }
+
+    /// Advance to the next element in the traversal, returning a null
+    /// pointer when the traversal is complete.
+    const T& next();
+
+    /// Return the current element in the traversal.
+    const T& getElement() const
+    {
+        return _elem;
+    }
+
+    /// Return the element depth of the current traversal, where the starting
+    /// element represents a depth of zero.
+    size_t getElementDepth() const
+    {
+        return _stack.size();
+    }
+
+    /// Set the prune subtree flag, which controls whether the current subtree
+    /// is pruned from traversal.
+    void setPruneSubtree(bool prune)
+    {
+        _prune = prune;
+    }
+
+  private:
+    using StackFrame = std::pair<T, size_t>;
+
+    T _elem;
+    vector<StackFrame> _stack;
+    bool _prune;
+};
+
+/// @class TreeWalker
+/// A lightweight object for read-only traversal of an element tree.
+///
+/// A TreeWalker stores raw element pointers rather than shared pointers,
+/// so the traversed tree must not be modified while a traversal is in
+/// progress.
+///
+/// Example usage:
+/// @code
+/// TreeWalker walker;
+/// for (Element* elem = walker.begin(root.get()); elem; elem = walker.next())
+/// {
+///     ...
+/// }
+/// @endcode
+/// @sa TreeIterator
+using TreeWalker = BasicTreeWalker<Element*>;
+
 /// @class TreeIterator
 /// An iterator object representing the state of a tree traversal.
 ///
+/// A TreeIterator is a thin wrapper over a tree walker holding shared
+/// pointers to the current element and its ancestors, so that the current
+/// element and its children may be edited during traversal.
+///
 /// @sa Element::traverseTree
 class TreeIterator
 {
   public:
     explicit TreeIterator(ElementPtr elem):
-        _elem(elem),
         _prune(false),
         _holdCount(0)
     {
+        _walker.begin(elem);
     }
     ~TreeIterator() { }
 
-  private:
-    using StackFrame = std::pair<ElementPtr, size_t>;
-
-  public:
     bool operator==(const TreeIterator& rhs) const
     {
-        return _elem == rhs._elem &&
-               _stack == rhs._stack &&
+        return _walker == rhs._walker &&
                _prune == rhs._prune;
     }
     bool operator!=(const TreeIterator& rhs) const
@@ -118,7 +209,7 @@ class TreeIterator
     /// traversal.
     ElementPtr operator*() const
     {
-        return _elem;
+        return _walker.getElement();
     }
 
     /// Iterate to the next element in the traversal.
@@ -130,7 +221,7 @@ class TreeIterator
     /// Return the current element in the traversal.
     ElementPtr getElement() const
     {
-        return _elem;
+        return _walker.getElement();
     }
 
     /// @}
@@ -141,7 +232,7 @@ class TreeIterator
     /// element represents a depth of zero.
     size_t getElementDepth() const
     {
-        return _stack.size();
+        return _walker.getElementDepth();
     }
 
     /// @}
@@ -181,12 +272,61 @@ class TreeIterator
     /// @}
 
   private:
-    ElementPtr _elem;
-    vector<StackFrame> _stack;
+    BasicTreeWalker<ElementPtr> _walker;
     bool _prune;
     size_t _holdCount;
 };
 
+/// @class GraphPathSet
+/// The set of elements along the current path of a graph traversal, used
+/// for cycle detection.
+///
+/// Elements are stored as raw pointers in path order, and membership tests
+/// are answered by a linear search for short paths and by a hash set for
+/// long paths.
+class GraphPathSet
+{
+  public:
+    GraphPathSet() { }
+    ~GraphPathSet() { }
+
+    /// Return true if the given element lies on the path.
+    bool contains(const Element* elem) const
+    {
+        if (_set.empty())
+        {
+            return std::find(_path.begin(), _path.end(), elem) != _path.end();
+        }
+        return _set.count(elem) != 0;
+    }
+
+    /// Extend the path to the given element.
+    void push(const Element* elem);
+
+    /// Remove the given element from the path, if present.
+    void erase(const Element* elem);
+
+    /// Remove all elements from the path, retaining allocated storage.
+    void clear()
+    {
+        _path.clear();
+        _set.clear();
+    }
+
+    /// Return the elements along the path, from downstream to upstream.
+    const vector<const Element*>& getElements() const
+    {
+        return _path;
+    }
+
+  public:
+    static const size_t SMALL_PATH_SIZE;
+
+  private:
+    vector<const Element*> _path;
+    std::unordered_set<const Element*> _set;
+};
+
 /// @class GraphIterator
 /// An iterator object representing the state of an upstream graph traversal.
 ///
@@ -200,12 +340,11 @@ class GraphIterator
         _prune(false),
         _holdCount(0)
     {
-        _pathElems.insert(elem);
+        _pathElems.push(elem.get());
     }
     ~GraphIterator() { }
 
   private:
-    using ElementSet = std::set<ElementPtr>;
     using StackFrame = std::pair<ElementPtr, size_t>;
 
   public:
@@ -325,13 +464,106 @@ class GraphIterator
   private:
     ElementPtr _upstreamElem;
     ElementPtr _connectingElem;
-    ElementSet _pathElems;
+    GraphPathSet _pathElems;
     ConstMaterialPtr _material;
     vector<StackFrame> _stack;
     bool _prune;
     size_t _holdCount;
 };
 
+/// @class GraphWalker
+/// A lightweight object for read-only upstream traversal of a dataflow graph.
+///
+/// A GraphWalker visits edges in the same order as GraphIterator, but stores
+/// raw element pointers rather than shared pointers, and retains its internal
+/// storage when reused for additional traversals.  The traversed graph must
+/// not be modified while a traversal is in progress.
+///
+/// Example usage:
+/// @code
+/// GraphWalker walker;
+/// for (Element* elem = walker.begin(output.get()); elem; elem = walker.next())
+/// {
+///     ...
+/// }
+/// @endcode
+/// @sa GraphIterator
+class GraphWalker
+{
+  public:
+    GraphWalker() :
+        _upstreamElem(nullptr),
+        _connectingElem(nullptr),
+        _prune(false)
+    {
+    }
+    ~GraphWalker() { }
+
+    /// Begin an upstream traversal from the given element, optionally in the
+    /// context of the given material, returning the upstream element of the
+    /// first edge, or a null pointer if no edges are present.
+    /// @throws ExceptionFoundCycle if a cycle is encountered.
+    Element* begin(Element* root, ConstMaterialPtr material = nullptr);
+
+    /// Advance to the next edge in the traversal, returning its upstream
+    /// element, or a null pointer when the traversal is complete.
+    /// @throws ExceptionFoundCycle if a cycle is encountered.
+    Element* next();
+
+    /// Return the downstream element of the current edge.
+    Element* getDownstreamElement() const
+    {
+        return !_stack.empty() ? _stack.back().first : nullptr;
+    }
+
+    /// Return the connecting element, if any, of the current edge.
+    Element* getConnectingElement() const
+    {
+        return _connectingElem;
+    }
+
+    /// Return the upstream element of the current edge.
+    Element* getUpstreamElement() const
+    {
+        return _upstreamElem;
+    }
+
+    /// Return the index of the current edge within the range of upstream edges
+    /// available to the downstream element.
+    size_t getUpstreamIndex() const
+    {
+        return !_stack.empty() ? _stack.back().second : 0;
+    }
+
+    /// Return the element depth of the current traversal, where a single edge
+    /// between two elements represents a depth of one.
+    size_t getElementDepth() const
+    {
+        return _stack.size();
+    }
+
+    /// Set the prune subgraph flag, which controls whether the current subgraph
+    /// is pruned from traversal.
+    void setPruneSubgraph(bool prune)
+    {
+        _prune = prune;
+    }
+
+  private:
+    void extendPathUpstream(const Edge& edge);
+    void returnPathDownstream(Element* upstreamElem);
+
+  private:
+    using StackFrame = std::pair<Element*, size_t>;
+
+    Element* _upstreamElem;
+    Element* _connectingElem;
+    GraphPathSet _pathElems;
+    ConstMaterialPtr _material;
+    vector<StackFrame> _stack;
+    bool _prune;
+};
+
 /// @class InheritanceIterator
 /// An iterator object representing the current state of an inheritance traversal.
 ///
@@ -388,6 +620,156 @@ class InheritanceIterator
     size_t _holdCount;
 };
 
+/// @class GraphSnapshot
+/// An immutable, dense snapshot of a dataflow graph, optimized for repeated
+/// traversal and analysis.
+///
+/// Each element in the snapshot is assigned an integer ID, and the upstream
+/// and downstream edges of all elements are stored in compressed sparse row
+/// arrays.  Edges are resolved once when the snapshot is created, so a
+/// snapshot must be recreated after its source graph is edited.
+class GraphSnapshot
+{
+  public:
+    /// @class IdRange
+    /// A contiguous range of element IDs within a snapshot.
+    class IdRange
+    {
+      public:
+        IdRange(const size_t* begin, const size_t* end) :
+            _begin(begin),
+            _end(end)
+        {
+        }
+
+        const size_t* begin() const { return _begin; }
+        const size_t* end() const { return _end; }
+        size_t size() const { return (size_t) (_end - _begin); }
+        bool empty() const { return _begin == _end; }
+        size_t operator[](size_t index) const { return _begin[index]; }
+
+      private:
+        const size_t* _begin;
+        const size_t* _end;
+    };
+
+  public:
+    /// Create a snapshot of the children of the given graph element and the
+    /// edges between them.
+    explicit GraphSnapshot(ConstGraphElementPtr graph);
+
+    /// Create a snapshot of the shader references of the given material and
+    /// all elements upstream of them.
+    explicit GraphSnapshot(ConstMaterialPtr material);
+
+    /// Create a snapshot of the given root elements and all elements upstream
+    /// of them, optionally in the context of the given material.
+    explicit GraphSnapshot(const vector<ElementPtr>& roots, ConstMaterialPtr material = nullptr);
+
+    ~GraphSnapshot() { }
+
+    /// @name Elements
+    /// @{
+
+    /// Return the number of elements in the snapshot.
+    size_t getElementCount() const
+    {
+        return _elements.size();
+    }
+
+    /// Return the element with the given ID.
+    ElementPtr getElement(size_t id) const
+    {
+        return _elements[id];
+    }
+
+    /// Return the ID of the given element, or INVALID_ID if the element is
+    /// not present in the snapshot.
+    size_t getElementId(ConstElementPtr elem) const;
+
+    /// @}
+    /// @name Edges
+    /// @{
+
+    /// Return the number of edges in the snapshot.
+    size_t getEdgeCount() const
+    {
+        return _upstreamIds.size();
+    }
+
+    /// Return the IDs of the elements directly upstream of the given element,
+    /// ordered by upstream edge index.  An element connected through several
+    /// edges appears once per edge.
+    IdRange getUpstreamIds(size_t id) const
+    {
+        return IdRange(_upstreamIds.data() + _upstreamOffsets[id],
+                       _upstreamIds.data() + _upstreamOffsets[id + 1]);
+    }
+
+    /// Return the connecting element, if any, of the given upstream edge of
+    /// the given element.
+    ElementPtr getConnectingElement(size_t id, size_t index) const
+    {
+        return _connectingElements[_upstreamOffsets[id] + index];
+    }
+
+    /// Return the IDs of the elements directly downstream of the given
+    /// element, in ascending order.  An element connected through several
+    /// edges appears once per edge.
+    IdRange getDownstreamIds(size_t id) const
+    {
+        return IdRange(_downstreamIds.data() + _downstreamOffsets[id],
+                       _downstreamIds.data() + _downstreamOffsets[id + 1]);
+    }
+
+    /// @}
+    /// @name Analysis
+    /// @{
+
+    /// Return the IDs of all elements in topological order, with each element
+    /// following the elements upstream of it.  Elements that lie on or
+    /// downstream of a cycle are omitted.
+    const vector<size_t>& getTopologicalOrder() const
+    {
+        return _topologicalOrder;
+    }
+
+    /// Return true if the snapshot contains a cycle.
+    bool hasCycle() const
+    {
+        return _topologicalOrder.size() != _elements.size();
+    }
+
+    /// Return true if the given upstream element can be reached by following
+    /// edges upstream from the given downstream element.
+    bool isUpstream(size_t upstreamId, size_t downstreamId) const;
+
+    /// Return the IDs of all elements that can be reached by following edges
+    /// upstream from the given element, in depth-first order.
+    vector<size_t> getUpstreamClosure(size_t id) const;
+
+    /// @}
+
+  public:
+    static const size_t INVALID_ID;
+
+  private:
+    void build(ConstMaterialPtr material);
+
+  private:
+    vector<ElementPtr> _elements;
+    std::unordered_map<const Element*, size_t> _elementIds;
+
+    vector<size_t> _upstreamOffsets;
+    vector<size_t> _upstreamIds;
+    vector<ElementPtr> _connectingElements;
+
+    vector<size_t> _downstreamOffsets;
+    vector<size_t> _downstreamIds;
+
+    vector<size_t> _topologicalOrder;
+};
+
 /// @class ExceptionFoundCycle
 /// An exception that is thrown when a traversal call encounters a cycle.
 class ExceptionFoundCycle : public Exception
@@ -7,6 +7,14 @@
 
 #include <cmath>
 
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #define MATERIALX_SIMD_SSE
+    #include <xmmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #define MATERIALX_SIMD_NEON
+    #include <arm_neon.h>
+#endif
+
 namespace MaterialX
 {
 
@@ -34,6 +42,123 @@ const Matrix44 Matrix44::IDENTITY(1, 0, 0, 0,
                                   0, 0, 0, 1);
 
 
+namespace {
+
+//
+// Four-wide float operations, used by batch transformations.  Products and
+// sums are evaluated separately, in the same order as the scalar methods,
+// so that batch results match those of single transformations.
+//
+
+#if defined(MATERIALX_SIMD_SSE)
+
+using Float4 = __m128;
+
+inline Float4 loadFloat4(const float* ptr) { return _mm_loadu_ps(ptr); }
+inline void storeFloat4(float* ptr, Float4 v) { _mm_storeu_ps(ptr, v); }
+inline Float4 splatFloat4(float s) { return _mm_set1_ps(s); }
+inline Float4 addFloat4(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+inline Float4 mulFloat4(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+
+#elif defined(MATERIALX_SIMD_NEON)
+
+using Float4 = float32x4_t;
+
+inline Float4 loadFloat4(const float* ptr) { return vld1q_f32(ptr); }
+inline void storeFloat4(float* ptr, Float4 v) { vst1q_f32(ptr, v); }
+inline Float4 splatFloat4(float s) { return vdupq_n_f32(s); }
+inline Float4 addFloat4(Float4 a, Float4 b) { return vaddq_f32(a, b); }
+inline Float4 mulFloat4(Float4 a, Float4 b) { return vmulq_f32(a, b); }
+
+#else
+
+struct Float4
+{
+    float v[4];
+};
+
+inline Float4 loadFloat4(const float* ptr) { return { { ptr[0], ptr[1], ptr[2], ptr[3] } }; }
+inline void storeFloat4(float* ptr, Float4 a) { for (size_t i = 0; i < 4; i++) ptr[i] = a.v[i]; }
+inline Float4 splatFloat4(float s) { return { { s, s, s, s } }; }
+inline Float4 addFloat4(Float4 a, Float4 b) { return { { a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] } }; }
+inline Float4 mulFloat4(Float4 a, Float4 b) { return { { a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3] } }; }
+
+#endif
+
+inline Float4 maddFloat4(Float4 a, Float4 b, Float4 c)
+{
+    return addFloat4(mulFloat4(a, b), c);
+}
+
+// Multiply each of an array of vectors with C stored components by a matrix,
+// given as its four columns, where the missing components of each vector
+// contribute the given offset.
+template <size_t C> void multiplyVectors(const Float4* columns, Float4 offset, float* data, size_t count, size_t stride)
+{
+    float result[4];
+    for (size_t i = 0; i < count; i++, data += stride)
+    {
+        Float4 res = mulFloat4(columns[0], splatFloat4(data[0]));
+        if (C > 1)
+            res = maddFloat4(columns[1], splatFloat4(data[1]), res);
+        if (C > 2)
+            res = maddFloat4(columns[2], splatFloat4(data[2]), res);
+        if (C > 3)
+        {
+            storeFloat4(data, maddFloat4(columns[3], splatFloat4(data[3]), res));
+            continue;
+        }
+        storeFloat4(result, addFloat4(res, offset));
+        for (size_t j = 0; j < C; j++)
+            data[j] = result[j];
+    }
+}
+
+// Multiply an array of strided vectors in place by the given matrix, where
+// the components of each vector that are not stored are taken from the
+// vector (0, 0, 0, w).
+void multiplyVectors(const Matrix44& matrix, float* data, size_t count, size_t components, size_t stride, float w)
+{
+    if (components < 1 || components > 4)
+    {
+        throw Exception("Invalid component count for batch transformation: " + std::to_string(components));
+    }
+    if (!stride)
+    {
+        stride = components;
+    }
+    else if (stride < components)
+    {
+        throw Exception("Batch transformation stride is smaller than its component count");
+    }
+
+    float columnData[4][4];
+    for (size_t i = 0; i < 4; i++)
+    {
+        for (size_t j = 0; j < 4; j++)
+        {
+            columnData[j][i] = matrix[i][j];
+        }
+    }
+    const Float4 columns[4] =
+    {
+        loadFloat4(columnData[0]),
+        loadFloat4(columnData[1]),
+        loadFloat4(columnData[2]),
+        loadFloat4(columnData[3])
+    };
+    const Float4 offset = mulFloat4(columns[3], splatFloat4(w));
+    switch (components)
+    {
+        case 1: multiplyVectors<1>(columns, offset, data, count, stride); break;
+        case 2: multiplyVectors<2>(columns, offset, data, count, stride); break;
+        case 3: multiplyVectors<3>(columns, offset, data, count, stride); break;
+        default: multiplyVectors<4>(columns, offset, data, count, stride); break;
+    }
+}
+
+} // anonymous namespace
+
 //
 // Vector methods
 //
@@ -245,6 +370,90 @@ Vector3 Matrix44::transformNormal(const Vector3& rhs) const
     return Vector3(rhs4[0], rhs4[1], rhs4[2]);
 }
 
+void Matrix44::transformPoints(float* data, size_t count, size_t components, size_t stride) const
+{
+    multiplyVectors(*this, data, count, components, stride, 1.0f);
+}
+
+void Matrix44::transformVectors(float* data, size_t count, size_t components, size_t stride) const
+{
+    multiplyVectors(*this, data, count, components, stride, 0.0f);
+}
+
+void Matrix44::transformNormals(float* data, size_t count, size_t components, size_t stride) const
+{
+    multiplyVectors(getInverse().getTranspose(), data, count, components, stride, 0.0f);
+}
+
+void Matrix44::transformPoints(float* x, float* y, float* z, size_t count) const
+{
+    // Transform four points per iteration, with one matrix entry per lane.
+    Float4 entries[3][4];
+    for (size_t i = 0; i < 3; i++)
+    {
+        for (size_t j = 0; j < 4; j++)
+        {
+            entries[i][j] = splatFloat4(_arr[i][j]);
+        }
+    }
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        Float4 px = loadFloat4(x + i);
+        Float4 py = loadFloat4(y + i);
+        Float4 pz = loadFloat4(z + i);
+        Float4 res[3];
+        for (size_t j = 0; j < 3; j++)
+        {
+            res[j] = mulFloat4(entries[j][0], px);
+            res[j] = maddFloat4(entries[j][1], py, res[j]);
+            res[j] = maddFloat4(entries[j][2], pz, res[j]);
+            res[j] = addFloat4(res[j], entries[j][3]);
+        }
+        storeFloat4(x + i, res[0]);
+        storeFloat4(y + i, res[1]);
+        storeFloat4(z + i, res[2]);
+    }
+    for (; i < count; i++)
+    {
+        Vector3 res = transformPoint(Vector3(x[i], y[i], z[i]));
+        x[i] = res[0];
+        y[i] = res[1];
+        z[i] = res[2];
+    }
+}
+
+void Matrix44::multiplyMatrices(const Matrix44* lhs, const Matrix44* rhs, Matrix44* result, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        // Each row of the product is a combination of the rows of the
+        // right-hand matrix, weighted by a row of the left-hand matrix.
+        const float* weights = lhs[i].data();
+        const float* rhsData = rhs[i].data();
+        const Float4 rows[4] =
+        {
+            loadFloat4(rhsData),
+            loadFloat4(rhsData + 4),
+            loadFloat4(rhsData + 8),
+            loadFloat4(rhsData + 12)
+        };
+        Float4 res[4];
+        for (size_t j = 0; j < 4; j++, weights += 4)
+        {
+            res[j] = mulFloat4(splatFloat4(weights[0]), rows[0]);
+            res[j] = maddFloat4(splatFloat4(weights[1]), rows[1], res[j]);
+            res[j] = maddFloat4(splatFloat4(weights[2]), rows[2], res[j]);
+            res[j] = maddFloat4(splatFloat4(weights[3]), rows[3], res[j]);
+        }
+        float* resultData = result[i].data();
+        for (size_t j = 0; j < 4; j++)
+        {
+            storeFloat4(resultData + j * 4, res[j]);
+        }
+    }
+}
+
 Matrix44 Matrix44::createTranslation(const Vector3& v)
 {
     return Matrix44(1.0f, 0.0f, 0.0f, 0.0f,
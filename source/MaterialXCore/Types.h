@@ -600,6 +600,40 @@ class Matrix44 : public MatrixN<Matrix44, float, 4>
     Vector3 transformVector(const Vector3& rhs) const;
     Vector3 transformNormal(const Vector3& rhs) const;
 
+    /// @}
+    /// @name Batch Transformations
+    /// @{
+
+    /// Transform an array of points in place, with results matching those
+    /// of multiply for each point.
+    /// @param data A pointer to the first component of the first point.
+    /// @param count The number of points to transform.
+    /// @param components The number of components stored for each point,
+    ///    between one and four.  Components that are not stored are taken
+    ///    from the point (0, 0, 0, 1).
+    /// @param stride The distance in floats between consecutive points,
+    ///    or zero if points are tightly packed.
+    void transformPoints(float* data, size_t count, size_t components = 3, size_t stride = 0) const;
+
+    /// Transform an array of vectors in place, where components that are
+    /// not stored are taken from the vector (0, 0, 0, 0).  Arguments are
+    /// interpreted as in transformPoints.
+    void transformVectors(float* data, size_t count, size_t components = 3, size_t stride = 0) const;
+
+    /// Transform an array of normals in place by the inverse transpose of
+    /// this matrix, which is computed once for the full array.  Arguments
+    /// are interpreted as in transformVectors.
+    void transformNormals(float* data, size_t count, size_t components = 3, size_t stride = 0) const;
+
+    /// Transform an array of points in place, where the coordinates of the
+    /// points are stored in separate arrays.
+    void transformPoints(float* x, float* y, float* z, size_t count) const;
+
+    /// Compute the matrix products of corresponding elements of two arrays,
+    /// storing each product lhs[i] * rhs[i] in result[i].  The result array
+    /// may alias either input array.
+    static void multiplyMatrices(const Matrix44* lhs, const Matrix44* rhs, Matrix44* result, size_t count);
+
     /// @}
     /// @name 3D Transformations
     /// @{
@@ -7,6 +7,9 @@
 
 #include <MaterialXCore/Element.h>
 
+#include <atomic>
+#include <thread>
+
 namespace MaterialX
 {
 
@@ -108,6 +111,122 @@ string replaceSubstrings(string str, const StringMap& stringMap)
     return str;
 }
 
+//
+// SubstringReplacer methods
+//
+
+SubstringReplacer::SubstringReplacer() :
+    _nodes(1, KeyNode{ {}, string::npos })
+{
+}
+
+void SubstringReplacer::setSubstitution(const string& key, const string& value)
+{
+    if (key.empty())
+    {
+        return;
+    }
+
+    size_t node = 0;
+    for (char c : key)
+    {
+        size_t child = findChild(node, c);
+        if (child == string::npos)
+        {
+            child = _nodes.size();
+            _nodes[node].children.push_back(std::make_pair(c, child));
+            _nodes.push_back(KeyNode{ {}, string::npos });
+        }
+        node = child;
+    }
+    if (_nodes[node].valueIndex == string::npos)
+    {
+        _nodes[node].valueIndex = _values.size();
+        _values.push_back(value);
+    }
+    else
+    {
+        _values[_nodes[node].valueIndex] = value;
+    }
+    _firstChars.set((unsigned char) key[0]);
+}
+
+void SubstringReplacer::clear()
+{
+    _nodes.assign(1, KeyNode{ {}, string::npos });
+    _values.clear();
+    _firstChars.reset();
+}
+
+void SubstringReplacer::replace(const string& str, string& result) const
+{
+    if (_values.empty())
+    {
+        result += str;
+        return;
+    }
+
+    result.reserve(result.size() + str.size());
+    size_t copyStart = 0;
+    size_t pos = 0;
+    while (pos < str.size())
+    {
+        if (!_firstChars.test((unsigned char) str[pos]))
+        {
+            pos++;
+            continue;
+        }
+
+        // Walk the key trie to find the longest key starting at this position.
+        size_t matchLength = 0;
+        size_t matchValue = string::npos;
+        size_t node = 0;
+        for (size_t i = pos; i < str.size(); i++)
+        {
+            node = findChild(node, str[i]);
+            if (node == string::npos)
+            {
+                break;
+            }
+            if (_nodes[node].valueIndex != string::npos)
+            {
+                matchLength = i - pos + 1;
+                matchValue = _nodes[node].valueIndex;
+            }
+        }
+        if (matchValue == string::npos)
+        {
+            pos++;
+            continue;
+        }
+
+        result.append(str, copyStart, pos - copyStart);
+        result += _values[matchValue];
+        pos += matchLength;
+        copyStart = pos;
+    }
+    result.append(str, copyStart, string::npos);
+}
+
+size_t SubstringReplacer::findChild(size_t node, char c) const
+{
+    for (const std::pair<char, size_t>& child : _nodes[node].children)
+    {
+        if (child.first == c)
+        {
+            return child.second;
+        }
+    }
+    return string::npos;
+}
+
+size_t getHeapBytes(const string& str)
+{
+    // The capacity of an empty string is the capacity of its inline storage.
+    static const size_t INLINE_CAPACITY = string().capacity();
+    return str.capacity() > INLINE_CAPACITY ? str.capacity() + 1 : 0;
+}
+
 string prettyPrint(ConstElementPtr elem)
 {
     string text;
@@ -119,4 +238,61 @@ string prettyPrint(ConstElementPtr elem)
     return text;
 }
 
+void parallelFor(size_t count, const std::function<void(size_t)>& func, unsigned int threadCount)
+{
+    if (!threadCount)
+    {
+        threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    size_t workerCount = std::min((size_t) threadCount, count);
+    if (workerCount <= 1)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            func(i);
+        }
+        return;
+    }
+
+    // Each worker claims the next unprocessed index, so threads that finish
+    // early continue to pick up work from slower ones.
+    std::atomic<size_t> nextIndex(0);
+    vector<std::exception_ptr> exceptions(workerCount);
+    auto worker = [&](size_t workerIndex)
+    {
+        try
+        {
+            for (size_t i = nextIndex++; i < count; i = nextIndex++)
+            {
+                func(i);
+            }
+        }
+        catch (...)
+        {
+            exceptions[workerIndex] = std::current_exception();
+            nextIndex = count;
+        }
+    };
+
+    // The calling thread acts as the first worker.
+    vector<std::thread> threads;
+    for (size_t i = 1; i < workerCount; i++)
+    {
+        threads.emplace_back(worker, i);
+    }
+    worker(0);
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (const std::exception_ptr& exception : exceptions)
+    {
+        if (exception)
+        {
+            std::rethrow_exception(exception);
+        }
+    }
+}
+
 } // namespace MaterialX
@@ -11,6 +11,8 @@
 
 #include <MaterialXCore/Library.h>
 
+#include <bitset>
+
 namespace MaterialX
 {
 
@@ -44,10 +46,102 @@ StringVec splitString(const string& str, const string& sep);
 /// Apply the given substring substitutions to the input string.
 string replaceSubstrings(string str, const StringMap& stringMap);
 
+/// @class SubstringReplacer
+/// A precompiled set of substring substitutions, which are applied to input
+/// strings in a single left-to-right pass.
+///
+/// At each position of an input string, the longest matching key is replaced
+/// by its value, and scanning resumes after the matched key, so substituted
+/// values are never themselves rescanned.
+class SubstringReplacer
+{
+  public:
+    SubstringReplacer();
+    ~SubstringReplacer() { }
+
+    /// Set the substitution for the given key.  Empty keys are ignored.
+    void setSubstitution(const string& key, const string& value);
+
+    /// Remove all substitutions.
+    void clear();
+
+    /// Return true if no substitutions have been set.
+    bool empty() const
+    {
+        return _values.empty();
+    }
+
+    /// Apply all substitutions to the given string, and return the result.
+    string replace(const string& str) const
+    {
+        string result;
+        replace(str, result);
+        return result;
+    }
+
+    /// Apply all substitutions to the given string, appending the result
+    /// to the given output string.
+    void replace(const string& str, string& result) const;
+
+  private:
+    // A node in the character trie of substitution keys.
+    struct KeyNode
+    {
+        vector<std::pair<char, size_t>> children;
+        size_t valueIndex;
+    };
+
+    size_t findChild(size_t node, char c) const;
+
+  private:
+    vector<KeyNode> _nodes;
+    vector<string> _values;
+    std::bitset<256> _firstChars;
+};
+
 /// Pretty print the given element tree, calling asString recursively on each
 /// element in depth-first order.
 string prettyPrint(ConstElementPtr elem);
 
+/// Return the number of bytes of heap storage held by the given string,
+/// or zero if its characters are stored within the string object.
+size_t getHeapBytes(const string& str);
+
+/// Return the number of bytes of heap storage held by the given vector,
+/// excluding any heap storage owned by its elements.
+template<class T> size_t getHeapBytes(const vector<T>& vec)
+{
+    return vec.capacity() * sizeof(T);
+}
+
+/// Return an estimate of the bytes of heap storage held by the given hashed
+/// container, excluding any heap storage owned by its entries.  Each entry
+/// is assumed to be held in a node with a link and a cached hash value.
+template<class T> size_t getHashedHeapBytes(const T& container)
+{
+    return container.bucket_count() * sizeof(void*) +
+           container.size() * (sizeof(typename T::value_type) + 2 * sizeof(void*));
+}
+
+/// Return an estimate of the bytes of heap storage held by the given ordered
+/// container, excluding any heap storage owned by its entries.  Each entry
+/// is assumed to be held in a node with three links and a color flag.
+template<class T> size_t getOrderedHeapBytes(const T& container)
+{
+    return container.size() * (sizeof(typename T::value_type) + 4 * sizeof(void*));
+}
+
+/// Call the given function once for each index in the range [0, count),
+/// distributing indices dynamically across a set of worker threads.
+/// @param count The number of indices to process.
+/// @param func The function to call for each index.
+/// @param threadCount The maximum number of threads to use, including the
+///    calling thread.  If zero, then the hardware concurrency of the host
+///    is used.
+/// @throws The first exception thrown by any invocation of func, after all
+///    worker threads have completed.
+void parallelFor(size_t count, const std::function<void(size_t)>& func, unsigned int threadCount = 0);
+
 } // namespace MaterialX
 
 #endif
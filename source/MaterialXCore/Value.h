@@ -78,12 +78,14 @@ class Value
     /// Set float formatting for converting values to strings.
     /// Formats to use are FloatFormatFixed, FloatFormatScientific 
     /// or FloatFormatDefault to set default format.
+    /// Float formatting is set independently for each thread.
     static void setFloatFormat(FloatFormat format)
     {
         _floatFormat = format;
     }
 
     /// Set float precision for converting values to strings.
+    /// Float precision is set independently for each thread.
     static void setFloatPrecision(int precision)
     {
         _floatPrecision = precision;
@@ -122,8 +124,8 @@ class Value
 
   private:
     static CreatorMap _creatorMap;
-    static FloatFormat _floatFormat;
-    static int _floatPrecision;
+    static thread_local FloatFormat _floatFormat;
+    static thread_local int _floatPrecision;
 };
 
 /// The class template for typed subclasses of Value
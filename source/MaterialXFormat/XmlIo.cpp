@@ -41,15 +41,19 @@ void elementFromXml(const xml_node& xmlNode, ElementPtr elem, const XmlReadOptio
         }
         else if (xmlAttr.name() != Element::NAME_ATTRIBUTE)
         {
-            elem->setAttribute(xmlAttr.name(), xmlAttr.value());
+            // Attribute strings are moved into the element.
+            elem->setAttribute(string(xmlAttr.name()), string(xmlAttr.value()));
         }
     }
 
-    // Create child elements and recurse.
+    // Create child elements and recurse, reusing the storage of the
+    // category and name strings between children.
+    string category;
+    string name;
     for (const xml_node& xmlChild : xmlNode.children())
     {
-        string category = xmlChild.name();
-        string name;
+        category = xmlChild.name();
+        name.clear();
         for (const xml_attribute& xmlAttr : xmlChild.attributes())
         {
             if (xmlAttr.name() == Element::NAME_ATTRIBUTE)
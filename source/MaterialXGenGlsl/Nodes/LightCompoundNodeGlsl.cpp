@@ -48,6 +48,20 @@ void LightCompoundNodeGlsl::initialize(const InterfaceElement& element, GenConte
     }
 }
 
+ShaderGraphPtr LightCompoundNodeGlsl::createGraph(const NodeGraph& graph, GenContext& context) const
+{
+    ShaderGraphPtr rootGraph = CompoundNode::createGraph(graph, context);
+
+    // Prepend the light struct instance name on all input socket variables,
+    // since in generated code these inputs will be members of the light struct.
+    // This is done before the graph is shared with other contexts.
+    for (ShaderGraphInputSocket* inputSocket : rootGraph->getInputSockets())
+    {
+        inputSocket->setVariable("light." + inputSocket->getVariable());
+    }
+    return rootGraph;
+}
+
 void LightCompoundNodeGlsl::createVariables(const ShaderNode&, GenContext& context, Shader& shader) const
 {
     // Create variables for all child nodes
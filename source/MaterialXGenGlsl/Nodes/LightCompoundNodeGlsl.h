@@ -35,6 +35,8 @@ public:
     void emitFunctionCall(const ShaderNode& node, GenContext& context, ShaderStage& stage) const override;
 
 protected:
+    ShaderGraphPtr createGraph(const NodeGraph& graph, GenContext& context) const override;
+
     void emitFunctionDefinition(HwClosureContextPtr ccx, GenContext& context, ShaderStage& stage) const;
 
     VariableBlock _lightUniforms;
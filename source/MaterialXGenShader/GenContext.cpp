@@ -4,6 +4,10 @@
 //
 
 #include <MaterialXGenShader/GenContext.h>
+#include <MaterialXGenShader/ShaderGraph.h>
+#include <MaterialXGenShader/ShaderNodeImpl.h>
+
+#include <unordered_set>
 
 namespace MaterialX
 {
@@ -29,12 +33,128 @@ void GenContext::addNodeImplementation(const string& name, ShaderNodeImplPtr imp
 ShaderNodeImplPtr GenContext::findNodeImplementation(const string& name)
 {
     auto it = _nodeImpls.find(name);
-    return it != _nodeImpls.end() ? it->second : nullptr;
+    if (it != _nodeImpls.end())
+    {
+        return it->second;
+    }
+    if (_sharedNodeImpls)
+    {
+        auto sharedIt = _sharedNodeImpls->find(name);
+        if (sharedIt != _sharedNodeImpls->end())
+        {
+            return sharedIt->second;
+        }
+    }
+    return nullptr;
 }
 
 void GenContext::clearNodeImplementations()
 {
     _nodeImpls.clear();
+    _sharedNodeImpls = nullptr;
+}
+
+void GenContext::clearSharedImplementations()
+{
+    clearNodeImplementations();
+    if (_implRegistry)
+    {
+        _implRegistry->clear();
+    }
+    if (_graphRegistry)
+    {
+        _graphRegistry->clear();
+    }
+}
+
+GenContext GenContext::createWorkerContext()
+{
+    // Move newly cached implementations into a new read-only cache, leaving
+    // any existing read-only cache untouched for the contexts sharing it.
+    if (!_nodeImpls.empty())
+    {
+        using NodeImplMap = std::unordered_map<string, ShaderNodeImplPtr>;
+        std::shared_ptr<NodeImplMap> shared = _sharedNodeImpls ?
+            std::make_shared<NodeImplMap>(*_sharedNodeImpls) :
+            std::make_shared<NodeImplMap>();
+        for (auto& it : _nodeImpls)
+        {
+            (*shared)[it.first] = it.second;
+        }
+        _nodeImpls.clear();
+        _sharedNodeImpls = shared;
+    }
+
+    GenContext worker(_sg);
+    worker._options = _options;
+    worker._sourceCodeSearchPath = _sourceCodeSearchPath;
+    worker._userData = _userData;
+    worker._sharedNodeImpls = _sharedNodeImpls;
+    worker._implRegistry = _implRegistry;
+    worker._graphRegistry = _graphRegistry;
+    return worker;
+}
+
+GenMemoryStats GenContext::getMemoryStats() const
+{
+    GenMemoryStats stats;
+    stats.contextBytes = sizeof(GenContext) +
+                         getHashedHeapBytes(_nodeImpls) +
+                         getHashedHeapBytes(_userData) +
+                         getHashedHeapBytes(_inputSuffix) +
+                         getHashedHeapBytes(_outputSuffix);
+
+    // Implementations may be cached under several names, so each is
+    // counted only once.
+    std::unordered_set<const ShaderNodeImpl*> visited;
+    vector<std::pair<const string*, const ShaderNodeImpl*>> impls;
+    for (const auto& it : _nodeImpls)
+    {
+        impls.emplace_back(&it.first, it.second.get());
+    }
+    if (_sharedNodeImpls)
+    {
+        stats.contextBytes += getHashedHeapBytes(*_sharedNodeImpls);
+        for (const auto& it : *_sharedNodeImpls)
+        {
+            impls.emplace_back(&it.first, it.second.get());
+        }
+    }
+    for (const auto& it : impls)
+    {
+        stats.contextBytes += getHeapBytes(*it.first);
+        const ShaderNodeImpl* impl = it.second;
+        if (!impl || !visited.insert(impl).second)
+        {
+            continue;
+        }
+        stats.implementationCount++;
+        size_t bytes = impl->getMemoryBytes();
+        const ShaderGraph* graph = impl->getGraph();
+        if (graph)
+        {
+            size_t graphBytes = graph->getMemoryBytes();
+            stats.compoundGraphCount++;
+            stats.compoundGraphNodeCount += graph->getNodes().size();
+            stats.compoundGraphBytes += graphBytes;
+            bytes -= std::min(bytes, graphBytes);
+        }
+        stats.implementationBytes += bytes;
+    }
+    for (const auto& it : _userData)
+    {
+        stats.userDataCount += it.second.size();
+        stats.contextBytes += getHeapBytes(it.first) + getHeapBytes(it.second);
+    }
+    for (const auto& it : _inputSuffix)
+    {
+        stats.contextBytes += getHeapBytes(it.second);
+    }
+    for (const auto& it : _outputSuffix)
+    {
+        stats.contextBytes += getHeapBytes(it.second);
+    }
+    return stats;
 }
 
 void GenContext::clearUserData()
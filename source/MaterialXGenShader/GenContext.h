@@ -62,6 +62,54 @@ class GenUserData : public std::enable_shared_from_this<GenUserData>
     GenUserData() { }
 };
 
+/// @class GenMemoryStats
+/// An estimate of the memory held by the caches of a GenContext,
+/// as returned by GenContext::getMemoryStats.
+class GenMemoryStats
+{
+  public:
+    GenMemoryStats() :
+        implementationCount(0),
+        implementationBytes(0),
+        compoundGraphCount(0),
+        compoundGraphNodeCount(0),
+        compoundGraphBytes(0),
+        userDataCount(0),
+        contextBytes(0)
+    {
+    }
+
+    /// Return the total estimated number of bytes.
+    size_t getTotalBytes() const
+    {
+        return implementationBytes + compoundGraphBytes + contextBytes;
+    }
+
+  public:
+    /// The number of distinct cached node implementations.
+    size_t implementationCount;
+
+    /// The bytes held by cached node implementations, excluding the
+    /// graphs of compound implementations.
+    size_t implementationBytes;
+
+    /// The number of cached compound implementations with graphs.
+    size_t compoundGraphCount;
+
+    /// The number of nodes in the graphs of compound implementations.
+    size_t compoundGraphNodeCount;
+
+    /// The bytes held by the graphs of compound implementations.
+    size_t compoundGraphBytes;
+
+    /// The number of user data entries.
+    size_t userDataCount;
+
+    /// The bytes held by the context itself, including the keys of its
+    /// implementation cache, user data and port suffixes.
+    size_t contextBytes;
+};
+
 /// @class GenContext 
 /// A context class for shader generation.
 /// Used for thread local storage of data needed during shader generation.
@@ -77,6 +125,12 @@ class GenContext
         return *_sg;
     }
 
+    /// Return shader generatior.
+    const ShaderGenerator& getShaderGenerator() const
+    {
+        return *_sg;
+    }
+
     /// Return shader generation options.
     GenOptions& getOptions()
     {
@@ -107,6 +161,12 @@ class GenContext
         _sourceCodeSearchPath.append(path);
     }
 
+    /// Return the search path used for finding source code.
+    const FileSearchPath& getSourceCodeSearchPath() const
+    {
+        return _sourceCodeSearchPath;
+    }
+
     /// Resolve a file using the registered search paths.
     FilePath resolveSourceFile(const FilePath& filename) const
     {
@@ -123,6 +183,61 @@ class GenContext
     /// Clear all cached shader node implementation.
     void clearNodeImplementations();
 
+    /// Attach the context to a registry of node implementations shared
+    /// with other contexts, or detach it if nullptr is given.  Node
+    /// implementations not cached by the context are looked up in the
+    /// registry, and implementations created by the context are added to it.
+    void setImplementationRegistry(ShaderNodeImplRegistryPtr registry)
+    {
+        _implRegistry = registry;
+    }
+
+    /// Return the registry of node implementations attached to the context,
+    /// or nullptr if no registry is attached.
+    ShaderNodeImplRegistryPtr getImplementationRegistry() const
+    {
+        return _implRegistry;
+    }
+
+    /// Attach the context to a registry of compound node graphs shared
+    /// with other contexts, or detach it if nullptr is given.  Compound
+    /// node implementations created by the context look up their graphs in
+    /// the registry, and add the graphs they build to it.  Without a
+    /// registry, each compound node implementation builds its own graph.
+    void setGraphRegistry(ShaderGraphRegistryPtr registry)
+    {
+        _graphRegistry = registry;
+    }
+
+    /// Return the registry of compound node graphs attached to the context,
+    /// or nullptr if no registry is attached.
+    ShaderGraphRegistryPtr getGraphRegistry() const
+    {
+        return _graphRegistry;
+    }
+
+    /// Clear the node implementations cached by the context, along with the
+    /// contents of any implementation and graph registries attached to it.
+    /// This should be called when libraries or source files have changed,
+    /// and clears the registries for all contexts sharing them.
+    void clearSharedImplementations();
+
+    /// Create a lightweight context for shader generation on another
+    /// thread.  The new context shares the shader generator, search path,
+    /// user data and registries of this context, and starts
+    /// with a copy of its options.
+    ///
+    /// Node implementations cached by this context are moved to a read-only
+    /// cache, which is shared with the new context without copying.
+    /// Implementations created by either context after this call are cached
+    /// by that context alone.  The caller is responsible for creating worker
+    /// contexts before starting the threads that use them.
+    GenContext createWorkerContext();
+
+    /// Return an estimate of the memory held by this context, including
+    /// its cached node implementations and their graphs.
+    GenMemoryStats getMemoryStats() const;
+
     /// Add user data to the context to make it
     /// available during shader generator.
     void pushUserData(const string& name, GenUserDataPtr data)
@@ -201,6 +316,15 @@ class GenContext
     // Cached shader node implementations.
     std::unordered_map<string, ShaderNodeImplPtr> _nodeImpls;
 
+    // Read-only shader node implementations, shared with worker contexts.
+    std::shared_ptr<const std::unordered_map<string, ShaderNodeImplPtr>> _sharedNodeImpls;
+
+    // Registry of shader node implementations shared with other contexts.
+    ShaderNodeImplRegistryPtr _implRegistry;
+
+    // Registry of compound node graphs shared with other contexts.
+    ShaderGraphRegistryPtr _graphRegistry;
+
     // User data
     std::unordered_map<string, vector<GenUserDataPtr>> _userData;
 
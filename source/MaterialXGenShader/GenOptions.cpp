@@ -10,6 +10,8 @@ namespace MaterialX
 
 GenOptions::GenOptions() :
     shaderInterfaceType(SHADER_INTERFACE_COMPLETE),
+    optimizationLevel(SHADER_OPTIMIZATION_BASIC),
+    specializeUniforms(false),
     fileTextureVerticalFlip(false),
     hwTransparency(false),
     hwSpecularEnvironmentMethod(SPECULAR_ENVIRONMENT_FIS),
@@ -43,6 +43,27 @@ enum HwSpecularEnvironmentMethod
     SPECULAR_ENVIRONMENT_FIS
 };
 
+/// Level of optimization applied to shader graphs
+enum ShaderOptimizationLevel
+{
+    /// Bypass constant nodes and conditional nodes with
+    /// constant selectors.
+    /// This is the default optimization level.
+    SHADER_OPTIMIZATION_BASIC,
+
+    /// In addition, evaluate arithmetic and channel nodes
+    /// whose inputs are all literal values, replacing them
+    /// with their results. Inputs that are published as
+    /// shader uniforms are never folded, so this has most
+    /// effect with a reduced shader interface.
+    SHADER_OPTIMIZATION_CONSTANT_FOLDING,
+
+    /// In addition, merge nodes that use the same implementation
+    /// with identical input values and connections, so that each
+    /// distinct expression is evaluated once.
+    SHADER_OPTIMIZATION_COMMON_SUBEXPRESSIONS
+};
+
 /// @class GenOptions 
 /// Class holding options to configure shader generation.
 class GenOptions
@@ -52,12 +73,30 @@ class GenOptions
     virtual ~GenOptions();
 
     // TODO: Add options for:
-    //  - shader gen optimization level
     //  - graph flattening or not
 
     /// Sets the type of shader interface to be generated
     int shaderInterfaceType;
 
+    /// Sets the level of optimization applied to shader graphs.
+    /// Defaults to SHADER_OPTIMIZATION_BASIC.
+    int optimizationLevel;
+
+    /// If true, the values of inputs are emitted as literals in the
+    /// generated code rather than published as uniforms, allowing them
+    /// to take part in graph optimization, so that conditional nodes
+    /// they select are bypassed and, with constant folding enabled,
+    /// arithmetic on them is evaluated during generation. The shader
+    /// must be regenerated when such values change. Filename inputs
+    /// are always published. By default this option is false.
+    bool specializeUniforms;
+
+    /// The names of uniforms that remain published when specializeUniforms
+    /// is true. Names are those of the published uniforms, i.e. the input
+    /// names of the shader interface, and <node>_<input> for node inputs
+    /// published with a complete shader interface.
+    StringSet dynamicUniforms;
+
     /// If true the y-component of texture coordinates used for sampling
     /// file textures will be flipped before sampling. This can be used if
     /// file textures need to be flipped vertically to match the target's
@@ -35,6 +35,18 @@ namespace HW
     const string USER_DATA_LIGHT_SHADERS   = "udls";
 }
 
+namespace {
+
+// Return true if the given input is an unconnected filename input of a file
+// texture node, which is published as a texture uniform.
+bool isFileTextureUniform(const ShaderInput& input)
+{
+    return !input.getConnection() && input.getType() == Type::FILENAME &&
+           input.getNode() && input.getNode()->hasClassification(ShaderNode::Classification::FILETEXTURE);
+}
+
+} // anonymous namespace
+
 //
 // HwShaderGenerator methods
 //
@@ -177,15 +189,14 @@ ShaderPtr HwShaderGenerator::createShader(const string& name, ElementPtr element
             {
                 for (ShaderInput* input : node->getInputs())
                 {
-                    if (!input->getConnection() && input->getType() == Type::FILENAME)
+                    if (isFileTextureUniform(*input))
                     {
                         // Create the uniform using the filename type to make this uniform into a texture sampler.
+                        // The uniform is named by the input variable, which getUpstreamResult returns during
+                        // code generation.  The input itself is left unchanged, as graphs of compound and
+                        // light implementations may be shared with other shaders and contexts.
                         ShaderPort* filename = psPublicUniforms->add(Type::FILENAME, input->getVariable(), input->getValue());
                         filename->setPath(input->getPath());
-
-                        // Assing the uniform name to the input value
-                        // so we can reference it during code generation.
-                        input->setValue(Value::createValue(input->getVariable()));
                     }
                 }
             }
@@ -207,6 +218,15 @@ ShaderPtr HwShaderGenerator::createShader(const string& name, ElementPtr element
     return shader;
 }
 
+string HwShaderGenerator::getUpstreamResult(const ShaderInput* input, GenContext& context) const
+{
+    if (isFileTextureUniform(*input))
+    {
+        return input->getVariable();
+    }
+    return ShaderGenerator::getUpstreamResult(input, context);
+}
+
 void HwShaderGenerator::emitFunctionCall(const ShaderNode& node, GenContext& context, ShaderStage& stage, bool checkScope) const
 {
     // Omit node if it's only used inside a conditional branch
@@ -349,18 +369,10 @@ void HwShaderGenerator::bindLightShader(const NodeDef& nodeDef, unsigned int lig
 
     ShaderNodePtr shader = ShaderNode::create(nullptr, nodeDef.getNodeString(), nodeDef, context);
 
-    // Check if this is a graph implementation.
-    // If so prepend the light struct instance name on all input socket variables,
-    // since in generated code these inputs will be members of the light struct.
-    ShaderGraph* graph = shader->getImplementation().getGraph();
-    if (graph)
-    {
-        for (ShaderGraphInputSocket* inputSockets : graph->getInputSockets())
-        {
-            inputSockets->setVariable("light." + inputSockets->getVariable());
-        }
-    }
-
+    // Graph implementations of light shaders prefix their input socket
+    // variables with the light struct instance name when their graph is
+    // created, so the implementation is used here without modification,
+    // as it may be shared with other contexts through a registry.
     lightShaders->bind(lightTypeId, shader);
 }
 
@@ -173,6 +173,11 @@ public:
     void emitFunctionCall(const ShaderNode& node, GenContext& context, ShaderStage& stage, 
                           bool checkScope = true) const override;
 
+    /// Return the result of an upstream connection or value for an input.
+    /// Unconnected filename inputs of file texture nodes resolve to the
+    /// texture uniforms created for them by createShader.
+    string getUpstreamResult(const ShaderInput* input, GenContext& context) const override;
+
     /// Emit code for all texturing nodes.
     virtual void emitTextureNodes(const ShaderGraph& graph, GenContext& context, ShaderStage& stage) const;
 
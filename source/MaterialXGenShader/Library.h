@@ -16,6 +16,7 @@ namespace MaterialX
 {
 
 class Shader;
+class ShaderInstance;
 class ShaderStage;
 class ShaderGenerator;
 class ShaderNode;
@@ -23,6 +24,7 @@ class ShaderGraph;
 class ShaderInput;
 class ShaderOutput;
 class ShaderNodeImpl;
+class ShaderGraphRegistry;
 class GenOptions;
 class GenContext;
 class TypeDesc;
@@ -38,6 +40,8 @@ using ShaderStagePtr = shared_ptr<ShaderStage>;
 using ShaderGeneratorPtr = shared_ptr<ShaderGenerator>;
 /// Shared pointer to a ShaderNodeImpl
 using ShaderNodeImplPtr = shared_ptr<ShaderNodeImpl>;
+/// Shared pointer to a ShaderGraphRegistry
+using ShaderGraphRegistryPtr = shared_ptr<ShaderGraphRegistry>;
 /// Shared pointer to a GenContext
 using GenContextPtr = shared_ptr<GenContext>;
 
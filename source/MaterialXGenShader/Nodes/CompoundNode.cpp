@@ -4,17 +4,176 @@
 //
 
 #include <MaterialXGenShader/Nodes/CompoundNode.h>
+#include <MaterialXGenShader/GenContext.h>
 #include <MaterialXGenShader/ShaderGenerator.h>
 #include <MaterialXGenShader/HwShaderGenerator.h>
+#include <MaterialXGenShader/SourceFileCache.h>
 #include <MaterialXGenShader/Util.h>
 
 #include <MaterialXCore/Library.h>
 #include <MaterialXCore/Definition.h>
 #include <MaterialXCore/Document.h>
 
+#include <unordered_set>
+
 namespace MaterialX
 {
 
+namespace {
+
+// Add the category, name and attributes of an element to a hasher.
+void addAttributes(StableHasher& hasher, ConstElementPtr elem)
+{
+    hasher.add(elem->getCategory());
+    hasher.add(elem->getName());
+    const StringVec& attribs = elem->getAttributeNames();
+    hasher.addInteger(attribs.size());
+    for (const string& attrib : attribs)
+    {
+        hasher.add(attrib);
+        hasher.add(elem->getAttribute(attrib));
+    }
+}
+
+// Hashes the content of a node graph implementation, together with the
+// nodedefs and implementations of its nodes, recursing into nested node
+// graph implementations.  The source files of implementations and the files
+// they include are identified by their resolved path and the hash of their
+// current contents, so that edited files lead to new graphs.
+class GraphContentHasher
+{
+  public:
+    GraphContentHasher(const GenContext& context, StableHasher& hasher) :
+        _context(context),
+        _shadergen(context.getShaderGenerator()),
+        _hasher(hasher)
+    {
+    }
+
+    void addGraph(ConstNodeGraphPtr graph)
+    {
+        if (!addSubtree(graph))
+        {
+            return;
+        }
+        addNodeDef(graph->getNodeDef());
+        for (NodePtr node : graph->getNodes())
+        {
+            addNodeDef(node->getNodeDef());
+        }
+    }
+
+  private:
+    void addNodeDef(ConstNodeDefPtr nodeDef)
+    {
+        for (ConstElementPtr def = nodeDef; def && addSubtree(def); def = def->getInheritsFrom())
+        {
+        }
+        if (!nodeDef)
+        {
+            return;
+        }
+        InterfaceElementPtr impl = nodeDef->getImplementation(_shadergen.getTarget(), _shadergen.getLanguage());
+        if (impl && impl->isA<NodeGraph>())
+        {
+            addGraph(impl->asA<NodeGraph>());
+        }
+        else if (impl)
+        {
+            addSubtree(impl);
+            const string& file = impl->getAttribute("file");
+            if (!file.empty())
+            {
+                addSourceFile(FilePath(file));
+            }
+        }
+    }
+
+    // Add the resolved path and contents of a source file, followed by the
+    // files that it includes.
+    void addSourceFile(const FilePath& file)
+    {
+        const FilePath path = _context.resolveSourceFile(file);
+        if (!_visitedFiles.insert(path.asString()).second)
+        {
+            return;
+        }
+        _hasher.add(path.asString());
+        SourceFilePtr sourceFile = SourceFileCache::getInstance().getFile(path);
+        _hasher.addInteger(sourceFile ? sourceFile->getContentHash() : 0);
+        if (sourceFile)
+        {
+            for (const string& include : sourceFile->getIncludes())
+            {
+                addSourceFile(FilePath(include));
+            }
+        }
+    }
+
+    // Add an element and its descendants, returning false if the element
+    // has already been added.
+    bool addSubtree(ConstElementPtr root)
+    {
+        if (!_visited.insert(root.get()).second)
+        {
+            return false;
+        }
+        TreeIterator it = root->traverseTree();
+        for (; it != TreeIterator::end(); ++it)
+        {
+            ElementPtr elem = it.getElement();
+            _hasher.addInteger(it.getElementDepth());
+            addAttributes(_hasher, elem);
+
+            // Default geometric properties are added as nodes of the graph.
+            InputPtr input = elem->asA<Input>();
+            GeomPropDefPtr geomProp = input ? input->getDefaultGeomProp() : nullptr;
+            if (geomProp)
+            {
+                addSubtree(geomProp);
+            }
+        }
+        return true;
+    }
+
+  private:
+    const GenContext& _context;
+    const ShaderGenerator& _shadergen;
+    StableHasher& _hasher;
+    std::unordered_set<const Element*> _visited;
+    std::unordered_set<string> _visitedFiles;
+};
+
+// An RAII class for the options used to create compound graphs.  For
+// compounds we do not want to publish all internal inputs, so the reduced
+// interface is always used, and the interface inputs are function arguments
+// that are never specialized.  The previous options are restored when the
+// instance is destroyed, including when graph creation throws.
+class ScopedCompoundOptions
+{
+  public:
+    explicit ScopedCompoundOptions(GenOptions& options) :
+        _options(options),
+        _shaderInterfaceType(options.shaderInterfaceType),
+        _specializeUniforms(options.specializeUniforms)
+    {
+        _options.shaderInterfaceType = SHADER_INTERFACE_REDUCED;
+        _options.specializeUniforms = false;
+    }
+    ~ScopedCompoundOptions()
+    {
+        _options.shaderInterfaceType = _shaderInterfaceType;
+        _options.specializeUniforms = _specializeUniforms;
+    }
+
+  private:
+    GenOptions& _options;
+    int _shaderInterfaceType;
+    bool _specializeUniforms;
+};
+
+} // anonymous namespace
+
 ShaderNodeImplPtr CompoundNode::create()
 {
     return std::make_shared<CompoundNode>();
@@ -34,16 +193,50 @@ void CompoundNode::initialize(const InterfaceElement& element, GenContext& conte
     _functionName = graph.getName();
     context.getShaderGenerator().getSyntax().makeValidName(_functionName);
 
-    // For compounds we do not want to publish all internal inputs
-    // so always use the reduced interface for this graph.
-    const int oldShaderInterfaceType = context.getOptions().shaderInterfaceType;
-    context.getOptions().shaderInterfaceType = SHADER_INTERFACE_REDUCED;
-    _rootGraph = ShaderGraph::create(nullptr, graph, context);
-    context.getOptions().shaderInterfaceType = oldShaderInterfaceType;
+    // If the context is attached to a graph registry, the graph is shared
+    // through it, keyed by the content of the node graph and its
+    // dependencies, so that it is built once for all contexts using the
+    // same implementation.
+    const ShaderGenerator& shadergen = context.getShaderGenerator();
+    ShaderGraphRegistryPtr registry = context.getGraphRegistry();
+    if (registry)
+    {
+        StableHasher hasher;
+        hasher.add(shadergen.getImplementationKey(graph, context));
+        addAttributes(hasher, graph.getDocument());
+        GraphContentHasher(context, hasher).addGraph(graph.getSelf()->asA<NodeGraph>());
+        const string key = hasher.getKey();
+
+        _rootGraph = registry->find(key);
+        if (!_rootGraph)
+        {
+            // Keep any graph registered concurrently by another context.
+            _rootGraph = registry->add(key, createGraph(graph, context));
+        }
+    }
+    else
+    {
+        _rootGraph = createGraph(graph, context);
+    }
 
-    // Set hash using the function name.
-    // TODO: Could be improved to include the full function signature.
-    _hash = std::hash<string>{}(_functionName);
+    // Set hash using the full function signature.
+    const Syntax& syntax = shadergen.getSyntax();
+    string signature = _functionName;
+    for (ShaderGraphInputSocket* inputSocket : _rootGraph->getInputSockets())
+    {
+        signature += "|" + syntax.getTypeName(inputSocket->getType()) + " " + inputSocket->getVariable();
+    }
+    for (ShaderGraphOutputSocket* outputSocket : _rootGraph->getOutputSockets())
+    {
+        signature += "|" + syntax.getOutputTypeName(outputSocket->getType()) + " " + outputSocket->getVariable();
+    }
+    _hash = std::hash<string>{}(signature);
+}
+
+ShaderGraphPtr CompoundNode::createGraph(const NodeGraph& graph, GenContext& context) const
+{
+    ScopedCompoundOptions options(context.getOptions());
+    return ShaderGraph::create(nullptr, graph, context);
 }
 
 void CompoundNode::createVariables(const ShaderNode&, GenContext& context, Shader& shader) const
@@ -155,4 +348,10 @@ void CompoundNode::emitFunctionCall(const ShaderNode& node, GenContext& context,
     END_SHADER_STAGE(stage, Stage::PIXEL)
 }
 
+size_t CompoundNode::getMemoryBytes() const
+{
+    return sizeof(CompoundNode) + getHeapBytes(_name) + getHeapBytes(_functionName) +
+           (_rootGraph ? _rootGraph->getMemoryBytes() : 0);
+}
+
 } // namespace MaterialX
@@ -28,7 +28,14 @@ public:
 
     ShaderGraph* getGraph() const override { return _rootGraph.get(); }
 
+    size_t getMemoryBytes() const override;
+
 protected:
+    /// Create the shader graph for the given node graph implementation.
+    /// The graph may be shared with other contexts through the graph
+    /// registry, so derived classes adapting the graph should do so here.
+    virtual ShaderGraphPtr createGraph(const NodeGraph& graph, GenContext& context) const;
+
     ShaderGraphPtr _rootGraph;
     string _functionName;
 };
@@ -18,7 +18,7 @@ ShaderNodeImplPtr ConvertNode::create()
     return std::make_shared<ConvertNode>();
 }
 
-void ConvertNode::emitFunctionCall(const ShaderNode& node, GenContext& context, ShaderStage& stage) const
+const string& ConvertNode::getSwizzle(const TypeDesc* inType, const TypeDesc* outType)
 {
     using ConvertTable = std::unordered_map<const TypeDesc*, std::unordered_map<const TypeDesc*, string> >;
 
@@ -78,6 +78,20 @@ void ConvertNode::emitFunctionCall(const ShaderNode& node, GenContext& context,
         }
     });
 
+    auto i = CONVERT_TABLE.find(inType);
+    if (i != CONVERT_TABLE.end())
+    {
+        auto j = i->second.find(outType);
+        if (j != i->second.end())
+        {
+            return j->second;
+        }
+    }
+    return EMPTY_STRING;
+}
+
+void ConvertNode::emitFunctionCall(const ShaderNode& node, GenContext& context, ShaderStage& stage) const
+{
     static const string IN_STRING("in");
 
     BEGIN_SHADER_STAGE(stage, Stage::PIXEL)
@@ -106,17 +120,8 @@ void ConvertNode::emitFunctionCall(const ShaderNode& node, GenContext& context,
         else
         {
             // Search the conversion table for a swizzle pattern to use.
-            const string* swizzle = nullptr;
-            auto i = CONVERT_TABLE.find(in->getType());
-            if (i != CONVERT_TABLE.end())
-            {
-                auto j = i->second.find(out->getType());
-                if (j != i->second.end())
-                {
-                    swizzle = &j->second;
-                }
-            }
-            if (!swizzle || swizzle->empty())
+            const string& swizzle = getSwizzle(in->getType(), out->getType());
+            if (swizzle.empty())
             {
                 throw ExceptionShaderGenError("Conversion from '" + in->getType()->getName() + "' to '" + out->getType()->getName() + "' is not supported by convert node");
             }
@@ -131,7 +136,7 @@ void ConvertNode::emitFunctionCall(const ShaderNode& node, GenContext& context,
                 shadergen.emitLine(shadergen.getSyntax().getTypeName(in->getType()) + " " + variableName + " = " + variableValue, stage);
             }
             const TypeDesc* type = in->getConnection() ? in->getConnection()->getType() : in->getType();
-            result = shadergen.getSyntax().getSwizzledVariable(variableName, type, *swizzle, node.getOutput()->getType());
+            result = shadergen.getSyntax().getSwizzledVariable(variableName, type, swizzle, node.getOutput()->getType());
         }
 
         shadergen.emitLineBegin(stage);
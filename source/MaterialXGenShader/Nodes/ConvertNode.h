@@ -18,6 +18,11 @@ class ConvertNode : public ShaderNodeImpl
     static ShaderNodeImplPtr create();
 
     void emitFunctionCall(const ShaderNode& node, GenContext& context, ShaderStage& stage) const override;
+
+    /// Return the swizzle pattern used to convert between the given
+    /// aggregate types, or an empty string if the conversion is not
+    /// supported.
+    static const string& getSwizzle(const TypeDesc* inType, const TypeDesc* outType);
 };
 
 } // namespace MaterialX
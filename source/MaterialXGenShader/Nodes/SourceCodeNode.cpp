@@ -47,7 +47,10 @@ void SourceCodeNode::initialize(const InterfaceElement& element, GenContext& con
     }
     context.getShaderGenerator().getSyntax().makeValidName(_functionName);
 
-    if (!readFile(context.resolveSourceFile(file), _functionSource))
+    // Source files are shared by all contexts, and hold their contents
+    // split into lines for emitting as function definitions.
+    _functionFile = SourceFileCache::getInstance().getFile(context.resolveSourceFile(file));
+    if (!_functionFile)
     {
         throw ExceptionShaderGenError("Can't find source file '" + file.asString() +
                                       "' used by implementation '" + impl.getName() + "'");
@@ -55,7 +58,9 @@ void SourceCodeNode::initialize(const InterfaceElement& element, GenContext& con
 
     if (_inlined)
     {
+        _functionSource = _functionFile->getContents();
         _functionSource.erase(std::remove(_functionSource.begin(), _functionSource.end(), '\n'), _functionSource.end());
+        _functionFile = nullptr;
     }
 
     // Set hash using the function name.
@@ -67,10 +72,10 @@ void SourceCodeNode::emitFunctionDefinition(const ShaderNode&, GenContext& conte
 {
     BEGIN_SHADER_STAGE(stage, Stage::PIXEL)
         // Emit function definition for non-inlined functions
-        if (!_inlined && !_functionSource.empty())
+        if (!_inlined && _functionFile)
         {
             const ShaderGenerator& shadergen = context.getShaderGenerator();
-            shadergen.emitBlock(_functionSource, context, stage);
+            shadergen.emitSourceFile(*_functionFile, context, stage);
             shadergen.emitLineBreak(stage);
         }
     END_SHADER_STAGE(stage, Stage::PIXEL)
@@ -187,4 +192,10 @@ void SourceCodeNode::emitFunctionCall(const ShaderNode& node, GenContext& contex
     END_SHADER_STAGE(stage, Stage::PIXEL)
 }
 
+size_t SourceCodeNode::getMemoryBytes() const
+{
+    return sizeof(SourceCodeNode) + getHeapBytes(_name) +
+           getHeapBytes(_functionName) + getHeapBytes(_functionSource);
+}
+
 } // namespace MaterialX
@@ -7,6 +7,7 @@
 #define MATERIALX_SOURCECODENODE_H
 
 #include <MaterialXGenShader/ShaderNodeImpl.h>
+#include <MaterialXGenShader/SourceFileCache.h>
 
 namespace MaterialX
 {
@@ -25,10 +26,13 @@ public:
 
     void emitFunctionCall(const ShaderNode& node, GenContext& context, ShaderStage& stage) const override;
 
+    size_t getMemoryBytes() const override;
+
 protected:
     bool _inlined;
     string _functionName;
     string _functionSource;
+    SourceFilePtr _functionFile;
 };
 
 } // namespace MaterialX
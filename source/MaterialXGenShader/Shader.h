@@ -105,6 +105,28 @@ class Shader
     std::unordered_map<string, ValuePtr> _attributeMap;
 
     friend class ShaderGenerator;
+    friend class DirectoryShaderCacheBackend;
+};
+
+/// @class ShaderInstance
+/// A shader shared between elements whose generated shaders differ only in
+/// the values of their uniforms, together with the uniform values of one of
+/// those elements, as returned by ShaderGenerator::generateInstanced.
+class ShaderInstance
+{
+  public:
+    /// The shared shader, generated for the first element with its
+    /// topology signature.
+    ShaderPtr shader;
+
+    /// The topology signature of the shader.
+    string signature;
+
+    /// The values of the uniforms of the element, keyed by the names of the
+    /// corresponding uniform variables of the shared shader.  These include
+    /// the public uniform block, and replace the default values of the
+    /// shared shader when the element is rendered.
+    std::unordered_map<string, ValuePtr> uniformValues;
 };
 
 } // namespace MaterialX
@@ -0,0 +1,829 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXGenShader/ShaderCache.h>
+
+#include <MaterialXGenShader/ColorManagementSystem.h>
+#include <MaterialXGenShader/GenContext.h>
+#include <MaterialXGenShader/Shader.h>
+#include <MaterialXGenShader/ShaderGenerator.h>
+#include <MaterialXGenShader/SourceFileCache.h>
+#include <MaterialXGenShader/TypeDesc.h>
+#include <MaterialXGenShader/Util.h>
+
+#include <MaterialXCore/Document.h>
+#include <MaterialXCore/Util.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <thread>
+#include <unordered_set>
+
+namespace MaterialX
+{
+
+const string DirectoryShaderCacheBackend::FILE_EXTENSION = "mxsc";
+
+namespace {
+
+const string FILE_HEADER = "MaterialXShaderCache 1";
+
+// Return a temporary file path alongside the given path, which is unique
+// across the processes and threads writing to the same cache directory.
+string getUniqueTempPath(const string& path)
+{
+    static std::atomic<size_t> tempCounter(0);
+#if defined(_WIN32)
+    const long pid = (long) _getpid();
+#else
+    const long pid = (long) getpid();
+#endif
+    return path + "." + std::to_string(pid) + "." +
+           std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + "." +
+           std::to_string(tempCounter++) + ".tmp";
+}
+
+// Move the given file over the target path, replacing any existing file
+// in a single step.
+bool replaceFile(const string& source, const string& target)
+{
+#if defined(_WIN32)
+    return MoveFileExA(source.c_str(), target.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return std::rename(source.c_str(), target.c_str()) == 0;
+#endif
+}
+
+} // anonymous namespace
+
+// The content hashes and include directives of source files, which are
+// computed once for each version of a file held by the SourceFileCache.
+class ShaderCache::SourceHashCache
+{
+  public:
+    struct SourceHash
+    {
+        SourceFilePtr file;
+        unsigned long long hash;
+        StringVec includes;
+    };
+
+    // Return the content hash and includes of the given source file.
+    SourceHash getSourceHash(const string& filename, const GenContext& context)
+    {
+        SourceFilePtr file = SourceFileCache::getInstance().getFile(context.resolveSourceFile(FilePath(filename)));
+        {
+            std::lock_guard<std::mutex> guard(_mutex);
+            auto it = _hashes.find(filename);
+            if (it != _hashes.end() && it->second.file == file)
+            {
+                return it->second;
+            }
+        }
+
+        StableHasher hasher;
+        hasher.add(file ? file->getContents() : EMPTY_STRING);
+        SourceHash sourceHash;
+        sourceHash.file = file;
+        sourceHash.hash = hasher.getValue();
+        if (file)
+        {
+            sourceHash.includes = file->getIncludes();
+        }
+
+        std::lock_guard<std::mutex> guard(_mutex);
+        _hashes[filename] = sourceHash;
+        return sourceHash;
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> guard(_mutex);
+        _hashes.clear();
+    }
+
+  private:
+    std::mutex _mutex;
+    std::unordered_map<string, SourceHash> _hashes;
+};
+
+// Hashes the content of an element and the elements that its generated
+// shader depends upon, each of which is visited once.
+class ShaderCache::DependencyHasher
+{
+  public:
+    DependencyHasher(const GenContext& context, SourceHashCache& sourceHashes, StableHasher& hasher) :
+        _context(context),
+        _sourceHashes(sourceHashes),
+        _hasher(hasher)
+    {
+    }
+
+    void hashElement(ConstElementPtr element)
+    {
+        addSubtree(element);
+
+        // Include the graph or material that holds the element, whose
+        // interface may be referenced by the element.
+        ConstElementPtr parent = element->getParent();
+        if (parent && !parent->isA<Document>())
+        {
+            addSubtree(parent);
+        }
+
+        // Include the upstream graph of the element.
+        for (Edge edge : element->traverseGraph())
+        {
+            addGraphElement(edge.getUpstreamElement());
+        }
+
+        while (!_pending.empty())
+        {
+            ConstElementPtr root = _pending.front();
+            _pending.pop_front();
+            hashSubtree(root);
+        }
+    }
+
+  private:
+    void addSubtree(ConstElementPtr elem)
+    {
+        if (elem && _visited.insert(elem.get()).second)
+        {
+            _pending.push_back(elem);
+        }
+    }
+
+    // Add the node graph that holds the given element, or the element
+    // itself if it is not held by a node graph.
+    void addGraphElement(ConstElementPtr elem)
+    {
+        if (!elem)
+        {
+            return;
+        }
+        ConstElementPtr parent = elem->getParent();
+        addSubtree(parent && parent->isA<NodeGraph>() ? parent : elem);
+    }
+
+    void addNodeDef(ConstNodeDefPtr nodeDef)
+    {
+        if (!nodeDef || _visited.count(nodeDef.get()))
+        {
+            return;
+        }
+        for (ConstElementPtr def = nodeDef; def && !_visited.count(def.get()); def = def->getInheritsFrom())
+        {
+            addSubtree(def);
+        }
+
+        const ShaderGenerator& generator = _context.getShaderGenerator();
+        InterfaceElementPtr impl = nodeDef->getImplementation(generator.getTarget(), generator.getLanguage());
+        addSubtree(impl);
+        ImplementationPtr sourceImpl = impl ? impl->asA<Implementation>() : nullptr;
+        if (sourceImpl)
+        {
+            addSourceFile(sourceImpl->getFile());
+        }
+    }
+
+    // Add the contents of a source file, and of the files that it includes.
+    void addSourceFile(const string& filename)
+    {
+        if (filename.empty() || !_files.insert(filename).second)
+        {
+            return;
+        }
+        SourceHashCache::SourceHash file = _sourceHashes.getSourceHash(filename, _context);
+        _hasher.add(filename);
+        _hasher.addInteger(file.hash);
+        for (const string& include : file.includes)
+        {
+            addSourceFile(include);
+        }
+    }
+
+    void hashAttributes(ConstElementPtr elem)
+    {
+        _hasher.add(elem->getCategory());
+        _hasher.add(elem->getName());
+        const StringVec& attribs = elem->getAttributeNames();
+        _hasher.addInteger(attribs.size());
+        for (const string& attrib : attribs)
+        {
+            _hasher.add(attrib);
+            _hasher.add(elem->getAttribute(attrib));
+        }
+    }
+
+    void hashSubtree(ConstElementPtr root)
+    {
+        // Attributes such as file prefixes and color spaces are inherited
+        // from the ancestors of the root, which are hashed once per key.
+        _hasher.add(root->getNamePath());
+        for (ConstElementPtr ancestor = root->getParent(); ancestor; ancestor = ancestor->getParent())
+        {
+            if (_hashedAncestors.insert(ancestor.get()).second)
+            {
+                hashAttributes(ancestor);
+            }
+        }
+
+        // The depth of each element identifies its position within the
+        // subtree, as elements are visited in a fixed order.
+        TreeIterator it = root->traverseTree();
+        for (; it != TreeIterator::end(); ++it)
+        {
+            ElementPtr elem = it.getElement();
+            _hasher.addInteger(it.getElementDepth());
+            hashAttributes(elem);
+            addDependencies(elem);
+        }
+    }
+
+    void addDependencies(ElementPtr elem)
+    {
+        if (NodePtr node = elem->asA<Node>())
+        {
+            addNodeDef(node->getNodeDef());
+        }
+        else if (ShaderRefPtr shaderRef = elem->asA<ShaderRef>())
+        {
+            addNodeDef(shaderRef->getNodeDef());
+        }
+        else if (BindInputPtr bindInput = elem->asA<BindInput>())
+        {
+            addGraphElement(bindInput->getConnectedOutput());
+        }
+        else if (NodeGraphPtr nodeGraph = elem->asA<NodeGraph>())
+        {
+            addNodeDef(nodeGraph->getNodeDef());
+        }
+        else if (InputPtr input = elem->asA<Input>())
+        {
+            // Default geometric properties are generated with the nodedefs
+            // of their geometric nodes.
+            GeomPropDefPtr geomProp = input->getDefaultGeomProp();
+            if (geomProp)
+            {
+                addSubtree(geomProp);
+                const string nodeDefName = "ND_" + geomProp->getGeomProp() + "_" + input->getType();
+                addNodeDef(input->getDocument()->getNodeDef(nodeDefName));
+            }
+        }
+    }
+
+  private:
+    const GenContext& _context;
+    SourceHashCache& _sourceHashes;
+    StableHasher& _hasher;
+    std::unordered_set<const Element*> _visited;
+    std::unordered_set<const Element*> _hashedAncestors;
+    std::unordered_set<string> _files;
+    std::deque<ConstElementPtr> _pending;
+};
+
+namespace {
+
+void writeString(std::ostream& stream, const string& str)
+{
+    stream << str.size() << '\n' << str << '\n';
+}
+
+bool readString(std::istream& stream, string& str)
+{
+    size_t size = 0;
+    if (!(stream >> size) || stream.get() != '\n')
+    {
+        return false;
+    }
+    str.resize(size);
+    if (size)
+    {
+        stream.read(&str[0], (std::streamsize) size);
+    }
+    return stream.get() == '\n';
+}
+
+void writeCount(std::ostream& stream, size_t count)
+{
+    stream << count << '\n';
+}
+
+bool readCount(std::istream& stream, size_t& count)
+{
+    return (stream >> count) && stream.get() == '\n';
+}
+
+void writeValue(std::ostream& stream, ConstValuePtr value)
+{
+    writeString(stream, value ? value->getTypeString() : EMPTY_STRING);
+    writeString(stream, value ? value->getValueString() : EMPTY_STRING);
+}
+
+bool readValue(std::istream& stream, ValuePtr& value)
+{
+    string type, valueString;
+    if (!readString(stream, type) || !readString(stream, valueString))
+    {
+        return false;
+    }
+    value = type.empty() ? nullptr : Value::createValueFromStrings(valueString, type);
+    return true;
+}
+
+void writeBlock(std::ostream& stream, const VariableBlock& block)
+{
+    writeString(stream, block.getName());
+    writeString(stream, block.getInstance());
+    writeCount(stream, block.size());
+    for (const ShaderPort* port : block.getVariableOrder())
+    {
+        writeString(stream, port->getType()->getName());
+        writeString(stream, port->getName());
+        writeString(stream, port->getPath());
+        writeString(stream, port->getSemantic());
+        writeString(stream, port->getVariable());
+        writeCount(stream, port->getFlags());
+        writeValue(stream, port->getValue());
+    }
+}
+
+bool readVariables(std::istream& stream, VariableBlock& block)
+{
+    size_t count = 0;
+    if (!readCount(stream, count))
+    {
+        return false;
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        string type, name, path, semantic, variable;
+        size_t flags = 0;
+        ValuePtr value;
+        if (!readString(stream, type) || !readString(stream, name) ||
+            !readString(stream, path) || !readString(stream, semantic) ||
+            !readString(stream, variable) || !readCount(stream, flags) ||
+            !readValue(stream, value))
+        {
+            return false;
+        }
+        ShaderPort* port = block.add(TypeDesc::get(type), name, value);
+        port->setPath(path);
+        port->setSemantic(semantic);
+        port->setVariable(variable);
+        port->setFlags((unsigned int) flags);
+    }
+    return true;
+}
+
+// Write a map of variable blocks in a stable order.
+void writeBlocks(std::ostream& stream, const VariableBlockMap& blocks)
+{
+    vector<const VariableBlock*> sortedBlocks;
+    for (const auto& it : blocks)
+    {
+        sortedBlocks.push_back(it.second.get());
+    }
+    std::sort(sortedBlocks.begin(), sortedBlocks.end(),
+        [](const VariableBlock* a, const VariableBlock* b) { return a->getName() < b->getName(); });
+    writeCount(stream, sortedBlocks.size());
+    for (const VariableBlock* block : sortedBlocks)
+    {
+        writeBlock(stream, *block);
+    }
+}
+
+template<class F> bool readBlock(std::istream& stream, F getBlock)
+{
+    string name, instance;
+    return readString(stream, name) && readString(stream, instance) &&
+           readVariables(stream, *getBlock(name, instance));
+}
+
+template<class F> bool readBlocks(std::istream& stream, F createBlock)
+{
+    size_t count = 0;
+    if (!readCount(stream, count))
+    {
+        return false;
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!readBlock(stream, createBlock))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+//
+// ShaderCacheBackend methods
+//
+
+ShaderCacheBackend::ShaderCacheBackend() :
+    _capacity(0),
+    _evictionCount(0)
+{
+}
+
+ShaderPtr ShaderCacheBackend::load(const string& key)
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    if (!touch(key))
+    {
+        return nullptr;
+    }
+    ShaderPtr shader = readEntry(key);
+    if (!shader)
+    {
+        // Discard entries that can no longer be read.
+        removeEntry(key);
+        _usageOrder.erase(_usageMap[key]);
+        _usageMap.erase(key);
+    }
+    return shader;
+}
+
+void ShaderCacheBackend::store(const string& key, ShaderPtr shader)
+{
+    if (!shader)
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(_mutex);
+    writeEntry(key, shader);
+    if (!touch(key))
+    {
+        _usageOrder.push_front(key);
+        _usageMap[key] = _usageOrder.begin();
+    }
+    evict();
+}
+
+void ShaderCacheBackend::clear()
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    for (const string& key : _usageOrder)
+    {
+        removeEntry(key);
+    }
+    _usageOrder.clear();
+    _usageMap.clear();
+}
+
+size_t ShaderCacheBackend::size() const
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    return _usageOrder.size();
+}
+
+void ShaderCacheBackend::setCapacity(size_t capacity)
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    _capacity = capacity;
+    evict();
+}
+
+size_t ShaderCacheBackend::getCapacity() const
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    return _capacity;
+}
+
+size_t ShaderCacheBackend::getEvictionCount() const
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    return _evictionCount;
+}
+
+void ShaderCacheBackend::addStoredEntry(const string& key)
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    if (!_usageMap.count(key))
+    {
+        _usageOrder.push_back(key);
+        _usageMap[key] = std::prev(_usageOrder.end());
+    }
+}
+
+bool ShaderCacheBackend::touch(const string& key)
+{
+    auto it = _usageMap.find(key);
+    if (it == _usageMap.end())
+    {
+        return false;
+    }
+    _usageOrder.splice(_usageOrder.begin(), _usageOrder, it->second);
+    return true;
+}
+
+void ShaderCacheBackend::evict()
+{
+    while (_capacity && _usageOrder.size() > _capacity)
+    {
+        const string& key = _usageOrder.back();
+        removeEntry(key);
+        _usageMap.erase(key);
+        _usageOrder.pop_back();
+        _evictionCount++;
+    }
+}
+
+//
+// MemoryShaderCacheBackend methods
+//
+
+ShaderPtr MemoryShaderCacheBackend::readEntry(const string& key)
+{
+    auto it = _shaders.find(key);
+    return it != _shaders.end() ? it->second : nullptr;
+}
+
+void MemoryShaderCacheBackend::writeEntry(const string& key, ShaderPtr shader)
+{
+    _shaders[key] = shader;
+}
+
+void MemoryShaderCacheBackend::removeEntry(const string& key)
+{
+    _shaders.erase(key);
+}
+
+//
+// DirectoryShaderCacheBackend methods
+//
+
+DirectoryShaderCacheBackend::DirectoryShaderCacheBackend(const FilePath& directory) :
+    _directory(directory)
+{
+    if (!_directory.exists())
+    {
+        _directory.createDirectory();
+    }
+    for (const FilePath& file : _directory.getFilesInDirectory(FILE_EXTENSION))
+    {
+        const string& filename = file.getBaseName();
+        addStoredEntry(filename.substr(0, filename.size() - FILE_EXTENSION.size() - 1));
+    }
+}
+
+FilePath DirectoryShaderCacheBackend::getEntryPath(const string& key) const
+{
+    return _directory / FilePath(key + "." + FILE_EXTENSION);
+}
+
+ShaderPtr DirectoryShaderCacheBackend::readEntry(const string& key)
+{
+    std::ifstream stream(getEntryPath(key).asString(), std::ios::in | std::ios::binary);
+    string header, name;
+    if (!stream || !std::getline(stream, header) || header != FILE_HEADER || !readString(stream, name))
+    {
+        return nullptr;
+    }
+
+    ShaderPtr shader = std::make_shared<Shader>(name, std::make_shared<ShaderGraph>(nullptr, name, nullptr));
+    size_t attributeCount = 0;
+    if (!readCount(stream, attributeCount))
+    {
+        return nullptr;
+    }
+    for (size_t i = 0; i < attributeCount; i++)
+    {
+        string attrib;
+        ValuePtr value;
+        if (!readString(stream, attrib) || !readValue(stream, value))
+        {
+            return nullptr;
+        }
+        shader->setAttribute(attrib, value);
+    }
+
+    size_t stageCount = 0;
+    if (!readCount(stream, stageCount))
+    {
+        return nullptr;
+    }
+    for (size_t i = 0; i < stageCount; i++)
+    {
+        string stageName;
+        if (!readString(stream, stageName) ||
+            !readStage(stream, *shader->createStage(stageName, nullptr)))
+        {
+            return nullptr;
+        }
+    }
+    return shader;
+}
+
+void DirectoryShaderCacheBackend::writeEntry(const string& key, ShaderPtr shader)
+{
+    // Write to a uniquely named temporary file, which is then moved over
+    // the entry in a single step, so that concurrent writers never share a
+    // file and readers observe either the previous or the new entry.
+    const string path = getEntryPath(key).asString();
+    const string tempPath = getUniqueTempPath(path);
+    {
+        std::ofstream stream(tempPath, std::ios::out | std::ios::binary);
+        if (!stream)
+        {
+            throw ExceptionShaderGenError("Unable to write shader cache file: " + tempPath);
+        }
+        stream << FILE_HEADER << '\n';
+        writeString(stream, shader->getName());
+
+        vector<string> attribs;
+        for (const auto& it : shader->_attributeMap)
+        {
+            attribs.push_back(it.first);
+        }
+        std::sort(attribs.begin(), attribs.end());
+        writeCount(stream, attribs.size());
+        for (const string& attrib : attribs)
+        {
+            writeString(stream, attrib);
+            writeValue(stream, shader->getAttribute(attrib));
+        }
+
+        writeCount(stream, shader->numStages());
+        for (size_t i = 0; i < shader->numStages(); i++)
+        {
+            const ShaderStage& stage = shader->getStage(i);
+            writeString(stream, stage.getName());
+            writeStage(stream, stage);
+        }
+    }
+    if (!replaceFile(tempPath, path))
+    {
+        std::remove(tempPath.c_str());
+        throw ExceptionShaderGenError("Unable to write shader cache file: " + path);
+    }
+}
+
+void DirectoryShaderCacheBackend::removeEntry(const string& key)
+{
+    std::remove(getEntryPath(key).asString().c_str());
+}
+
+void DirectoryShaderCacheBackend::writeStage(std::ostream& stream, const ShaderStage& stage)
+{
+    writeString(stream, stage.getSourceCode());
+    writeBlocks(stream, stage.getUniformBlocks());
+    writeBlocks(stream, stage.getInputBlocks());
+    writeBlocks(stream, stage.getOutputBlocks());
+    writeBlock(stream, stage.getConstantBlock());
+}
+
+bool DirectoryShaderCacheBackend::readStage(std::istream& stream, ShaderStage& stage)
+{
+    return readString(stream, stage._code) &&
+           readBlocks(stream, [&stage](const string& name, const string& instance) { return stage.createUniformBlock(name, instance); }) &&
+           readBlocks(stream, [&stage](const string& name, const string& instance) { return stage.createInputBlock(name, instance); }) &&
+           readBlocks(stream, [&stage](const string& name, const string& instance) { return stage.createOutputBlock(name, instance); }) &&
+           readBlock(stream, [&stage](const string&, const string&) { return &stage.getConstantBlock(); });
+}
+
+//
+// ShaderCache methods
+//
+
+ShaderCache::ShaderCache() :
+    _sourceHashes(new SourceHashCache()),
+    _hits(0),
+    _misses(0)
+{
+}
+
+ShaderCache::~ShaderCache()
+{
+}
+
+void ShaderCache::addBackend(ShaderCacheBackendPtr backend)
+{
+    if (!backend)
+    {
+        throw ExceptionShaderGenError("Invalid backend for shader cache");
+    }
+    _backends.push_back(backend);
+}
+
+ShaderPtr ShaderCache::generate(const string& name, ElementPtr element, GenContext& context)
+{
+    const string key = computeKey(name, element, context);
+    for (size_t i = 0; i < _backends.size(); i++)
+    {
+        ShaderPtr shader = _backends[i]->load(key);
+        if (shader)
+        {
+            // Copy the shader into the earlier backends.
+            for (size_t j = 0; j < i; j++)
+            {
+                _backends[j]->store(key, shader);
+            }
+            std::lock_guard<std::mutex> guard(_mutex);
+            _hits++;
+            return shader;
+        }
+    }
+
+    ShaderPtr shader = context.getShaderGenerator().generate(name, element, context);
+    for (ShaderCacheBackendPtr backend : _backends)
+    {
+        backend->store(key, shader);
+    }
+    std::lock_guard<std::mutex> guard(_mutex);
+    _misses++;
+    return shader;
+}
+
+string ShaderCache::computeKey(const string& name, ConstElementPtr element, const GenContext& context)
+{
+    if (!element)
+    {
+        throw ExceptionShaderGenError("Invalid element for shader cache key");
+    }
+
+    StableHasher hasher;
+    hasher.add(FILE_HEADER);
+    hasher.add(getVersionString());
+    hasher.add(name);
+
+    // Add the generator and its options.
+    const ShaderGenerator& generator = context.getShaderGenerator();
+    hasher.add(generator.getTarget());
+    hasher.add(generator.getLanguage());
+    ColorManagementSystemPtr cms = generator.getColorManagementSystem();
+    hasher.add(cms ? cms->getName() : EMPTY_STRING);
+    const GenOptions& options = context.getOptions();
+    hasher.addInteger((unsigned long long) options.shaderInterfaceType);
+    hasher.addInteger((unsigned long long) options.optimizationLevel);
+    hasher.addInteger(options.specializeUniforms ? 1 : 0);
+    hasher.addInteger(options.dynamicUniforms.size());
+    for (const string& uniform : options.dynamicUniforms)
+    {
+        hasher.add(uniform);
+    }
+    hasher.addInteger(options.fileTextureVerticalFlip ? 1 : 0);
+    hasher.add(options.targetColorSpaceOverride);
+    hasher.addInteger(options.hwTransparency ? 1 : 0);
+    hasher.addInteger((unsigned long long) options.hwSpecularEnvironmentMethod);
+    hasher.addInteger(options.hwMaxActiveLightSources);
+
+    // Add the element and its dependencies.
+    DependencyHasher dependencies(context, *_sourceHashes, hasher);
+    dependencies.hashElement(element);
+
+    return hasher.getKey();
+}
+
+void ShaderCache::clear()
+{
+    for (ShaderCacheBackendPtr backend : _backends)
+    {
+        backend->clear();
+    }
+}
+
+void ShaderCache::clearSourceFileHashes()
+{
+    _sourceHashes->clear();
+}
+
+ShaderCacheStats ShaderCache::getStats() const
+{
+    ShaderCacheStats stats;
+    {
+        std::lock_guard<std::mutex> guard(_mutex);
+        stats.hits = _hits;
+        stats.misses = _misses;
+    }
+    for (ShaderCacheBackendPtr backend : _backends)
+    {
+        stats.evictions += backend->getEvictionCount();
+    }
+    return stats;
+}
+
+void ShaderCache::resetStats()
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    _hits = 0;
+    _misses = 0;
+}
+
+} // namespace MaterialX
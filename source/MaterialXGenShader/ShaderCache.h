@@ -0,0 +1,295 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#ifndef MATERIALX_SHADERCACHE_H
+#define MATERIALX_SHADERCACHE_H
+
+/// @file
+/// Content-addressed caching of generated shaders
+
+#include <MaterialXGenShader/Library.h>
+
+#include <MaterialXFormat/File.h>
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace MaterialX
+{
+
+class GenContext;
+class ShaderStage;
+
+/// A shared pointer to a ShaderCacheBackend
+using ShaderCacheBackendPtr = shared_ptr<class ShaderCacheBackend>;
+
+/// A shared pointer to a MemoryShaderCacheBackend
+using MemoryShaderCacheBackendPtr = shared_ptr<class MemoryShaderCacheBackend>;
+
+/// A shared pointer to a DirectoryShaderCacheBackend
+using DirectoryShaderCacheBackendPtr = shared_ptr<class DirectoryShaderCacheBackend>;
+
+/// A shared pointer to a ShaderCache
+using ShaderCachePtr = shared_ptr<class ShaderCache>;
+
+/// @class ShaderCacheBackend
+/// Abstract base class for the storage of a ShaderCache, holding generated
+/// shaders by key.
+///
+/// Each backend may be given a capacity, in which case the least recently
+/// used entries are evicted to keep the backend within its capacity.
+/// Backends are safe to share between threads.
+///
+class ShaderCacheBackend
+{
+  public:
+    virtual ~ShaderCacheBackend() { }
+
+    /// Return the shader stored with the given key, or nullptr if no
+    /// such shader is stored.
+    ShaderPtr load(const string& key);
+
+    /// Store a shader with the given key, replacing any shader previously
+    /// stored with the key, and evicting entries as needed.
+    void store(const string& key, ShaderPtr shader);
+
+    /// Remove all entries from the backend.
+    void clear();
+
+    /// Return the number of entries in the backend.
+    size_t size() const;
+
+    /// Set the maximum number of entries in the backend.  A capacity of
+    /// zero, the default, allows an unlimited number of entries.
+    void setCapacity(size_t capacity);
+
+    /// Return the maximum number of entries in the backend.
+    size_t getCapacity() const;
+
+    /// Return the number of entries that have been evicted from the backend.
+    size_t getEvictionCount() const;
+
+  protected:
+    ShaderCacheBackend();
+
+    /// Read the entry with the given key from storage, returning nullptr
+    /// if the entry cannot be read.
+    virtual ShaderPtr readEntry(const string& key) = 0;
+
+    /// Write an entry to storage.
+    virtual void writeEntry(const string& key, ShaderPtr shader) = 0;
+
+    /// Remove an entry from storage.
+    virtual void removeEntry(const string& key) = 0;
+
+    /// Add an existing entry in storage to the usage order of the backend,
+    /// as its least recently used entry.
+    void addStoredEntry(const string& key);
+
+  private:
+    // Move the given key to the front of the usage order, returning false
+    // if the key is not present.
+    bool touch(const string& key);
+
+    // Evict entries until the backend is within its capacity.
+    void evict();
+
+  private:
+    mutable std::mutex _mutex;
+    std::list<string> _usageOrder;
+    std::unordered_map<string, std::list<string>::iterator> _usageMap;
+    size_t _capacity;
+    size_t _evictionCount;
+};
+
+/// @class MemoryShaderCacheBackend
+/// A shader cache backend that holds generated shaders in memory.  Shaders
+/// loaded from this backend are shared with all callers, and should be
+/// treated as read-only.
+///
+class MemoryShaderCacheBackend : public ShaderCacheBackend
+{
+  public:
+    /// Create a new MemoryShaderCacheBackend
+    static MemoryShaderCacheBackendPtr create()
+    {
+        return MemoryShaderCacheBackendPtr(new MemoryShaderCacheBackend());
+    }
+
+  protected:
+    MemoryShaderCacheBackend() { }
+
+    ShaderPtr readEntry(const string& key) override;
+    void writeEntry(const string& key, ShaderPtr shader) override;
+    void removeEntry(const string& key) override;
+
+  private:
+    std::unordered_map<string, ShaderPtr> _shaders;
+};
+
+/// @class DirectoryShaderCacheBackend
+/// A shader cache backend that stores generated shaders as files in a
+/// directory, allowing results to be shared between processes and sessions.
+///
+/// Each entry holds the name, attributes and stages of a shader, including
+/// the source code and variable blocks of each stage.  Shaders loaded from
+/// this backend have an empty shader graph, as the graph used during their
+/// generation is not stored.
+///
+class DirectoryShaderCacheBackend : public ShaderCacheBackend
+{
+  public:
+    /// Create a new DirectoryShaderCacheBackend, storing entries in the
+    /// given directory.  The directory is created if it does not exist, and
+    /// entries already present in the directory are available for loading.
+    static DirectoryShaderCacheBackendPtr create(const FilePath& directory)
+    {
+        return DirectoryShaderCacheBackendPtr(new DirectoryShaderCacheBackend(directory));
+    }
+
+    /// Return the directory in which entries are stored.
+    const FilePath& getDirectory() const
+    {
+        return _directory;
+    }
+
+    /// The file extension of entries in a directory backend.
+    static const string FILE_EXTENSION;
+
+  protected:
+    DirectoryShaderCacheBackend(const FilePath& directory);
+
+    ShaderPtr readEntry(const string& key) override;
+    void writeEntry(const string& key, ShaderPtr shader) override;
+    void removeEntry(const string& key) override;
+
+    /// Return the path of the file holding the given entry.
+    FilePath getEntryPath(const string& key) const;
+
+  private:
+    static void writeStage(std::ostream& stream, const ShaderStage& stage);
+    static bool readStage(std::istream& stream, ShaderStage& stage);
+
+  private:
+    FilePath _directory;
+};
+
+/// @class ShaderCacheStats
+/// Statistics on the lookups of a ShaderCache, as returned by
+/// ShaderCache::getStats.
+class ShaderCacheStats
+{
+  public:
+    ShaderCacheStats() :
+        hits(0),
+        misses(0),
+        evictions(0)
+    {
+    }
+
+    /// Return the fraction of lookups that were hits.
+    double getHitRate() const
+    {
+        return (hits + misses) ? (double) hits / (double) (hits + misses) : 0.0;
+    }
+
+  public:
+    /// The number of lookups answered by a backend of the cache.
+    size_t hits;
+
+    /// The number of lookups that required shader generation.
+    size_t misses;
+
+    /// The number of entries evicted from the backends of the cache over
+    /// their lifetimes.
+    size_t evictions;
+};
+
+/// @class ShaderCache
+/// A content-addressed cache of generated shaders.
+///
+/// Shaders are keyed on a stable hash of everything that their generation
+/// depends upon: the shader name, the generator target and language, the
+/// generation options and color management system of the context, the
+/// content of the element and its upstream dependencies, the nodedefs and
+/// implementations of the nodes involved, and the contents of implementation
+/// source files and the files that they include.  Keys are independent of
+/// the process and platform, so directory backends may be shared between
+/// machines.
+///
+/// A cache holds one or more backends, which are searched in order, with
+/// shaders found in a later backend copied into the earlier ones.  A typical
+/// configuration places a memory backend in front of a directory backend.
+///
+/// Context state other than its options, such as user data and bound light
+/// shaders, is not included in keys, and callers that vary such state
+/// between generations should use separate caches.  The source code of the
+/// generators themselves is also not included, so directory backends should
+/// be cleared when generators are updated.
+///
+class ShaderCache
+{
+  public:
+    /// Create a new ShaderCache with the given backend.
+    static ShaderCachePtr create(ShaderCacheBackendPtr backend)
+    {
+        ShaderCachePtr cache(new ShaderCache());
+        cache->addBackend(backend);
+        return cache;
+    }
+
+    ~ShaderCache();
+
+    /// Add a backend to the cache, to be searched after existing backends.
+    void addBackend(ShaderCacheBackendPtr backend);
+
+    /// Return the backends of the cache.
+    const vector<ShaderCacheBackendPtr>& getBackends() const
+    {
+        return _backends;
+    }
+
+    /// Return the shader generated for the given element by the generator
+    /// of the context, generating and storing the shader if it is not
+    /// present in the cache.
+    ShaderPtr generate(const string& name, ElementPtr element, GenContext& context);
+
+    /// Compute the key identifying the shader generated for the given
+    /// element in the given context.
+    string computeKey(const string& name, ConstElementPtr element, const GenContext& context);
+
+    /// Remove all entries from the backends of the cache.
+    void clear();
+
+    /// Discard the hashes of source files held by the cache.  The hash of
+    /// each source file is computed once for each version of the file held
+    /// by the SourceFileCache, which reloads files when they are modified.
+    void clearSourceFileHashes();
+
+    /// Return statistics on the lookups of the cache.
+    ShaderCacheStats getStats() const;
+
+    /// Reset the hit and miss counts of the cache.
+    void resetStats();
+
+  protected:
+    ShaderCache();
+
+  private:
+    class SourceHashCache;
+    class DependencyHasher;
+
+    vector<ShaderCacheBackendPtr> _backends;
+    std::unique_ptr<SourceHashCache> _sourceHashes;
+    mutable std::mutex _mutex;
+    size_t _hits;
+    size_t _misses;
+};
+
+} // namespace MaterialX
+
+#endif
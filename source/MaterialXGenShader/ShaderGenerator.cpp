@@ -6,17 +6,27 @@
 #include <MaterialXGenShader/ShaderGenerator.h>
 
 #include <MaterialXGenShader/GenContext.h>
+#include <MaterialXGenShader/Shader.h>
 #include <MaterialXGenShader/ShaderNodeImpl.h>
+#include <MaterialXGenShader/Util.h>
 #include <MaterialXGenShader/Nodes/CompoundNode.h>
 #include <MaterialXGenShader/Nodes/SourceCodeNode.h>
 
 #include <MaterialXFormat/File.h>
 
 #include <MaterialXCore/Document.h>
+#include <MaterialXCore/Material.h>
 #include <MaterialXCore/Node.h>
+#include <MaterialXCore/Util.h>
 #include <MaterialXCore/Value.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <map>
+#include <set>
 #include <sstream>
+#include <thread>
 
 namespace MaterialX
 {
@@ -24,15 +34,321 @@ namespace MaterialX
 const string ShaderGenerator::SEMICOLON = ";";
 const string ShaderGenerator::COMMA = ",";
 
+namespace {
+
+bool isIdentifierChar(char c)
+{
+    return std::isalnum((unsigned char) c) || c == '_';
+}
+
+// Remove the value assigned in the declaration of the given variable from
+// the source code, up to the end of the line, if the declaration is found.
+void removeDeclaredValue(string& code, const string& variable)
+{
+    const string name = " " + variable;
+    const string assignment = " = ";
+    for (size_t pos = code.find(name); pos != string::npos; pos = code.find(name, pos + 1))
+    {
+        size_t end = pos + name.size();
+        if (end < code.size() && isIdentifierChar(code[end]))
+        {
+            continue;
+        }
+        size_t lineEnd = std::min(code.find('\n', end), code.size());
+        size_t valuePos = code.find(assignment, end);
+        if (valuePos < lineEnd)
+        {
+            valuePos += assignment.size();
+            code.erase(valuePos, lineEnd - valuePos);
+        }
+        return;
+    }
+}
+
+// Replace each identifier of the source code found in the given map with
+// its mapped name.
+string renameIdentifiers(const string& code, const std::unordered_map<string, string>& names)
+{
+    string result;
+    result.reserve(code.size());
+    for (size_t i = 0; i < code.size(); )
+    {
+        if (!isIdentifierChar(code[i]))
+        {
+            result += code[i++];
+            continue;
+        }
+        size_t end = i;
+        while (end < code.size() && isIdentifierChar(code[end]))
+        {
+            end++;
+        }
+        const string token = code.substr(i, end - i);
+        auto it = names.find(token);
+        result += it != names.end() ? it->second : token;
+        i = end;
+    }
+    return result;
+}
+
+// Return the uniform blocks of a stage, ordered by name.
+vector<const VariableBlock*> getOrderedUniformBlocks(const ShaderStage& stage)
+{
+    std::map<string, const VariableBlock*> blocks;
+    for (const auto& it : stage.getUniformBlocks())
+    {
+        blocks[it.first] = it.second.get();
+    }
+    vector<const VariableBlock*> result;
+    for (const auto& it : blocks)
+    {
+        result.push_back(it.second);
+    }
+    return result;
+}
+
+} // anonymous namespace
+
 //
 // ShaderGenerator methods
 //
 
 ShaderGenerator::ShaderGenerator(SyntaxPtr syntax) :
-     _syntax(syntax)
+     _syntax(syntax),
+     _implRegistry(ShaderNodeImplRegistry::create()),
+     _graphRegistry(ShaderGraphRegistry::create())
 {
 }
 
+vector<ShaderPtr> ShaderGenerator::generateAll(const vector<ElementPtr>& elements, GenContext& context,
+                                              unsigned int threadCount) const
+{
+    // Create the implementations of all nodes upstream of the elements, so
+    // that they are shared by the workers rather than created by each.
+    // A failure is recorded for its element, which is then not generated.
+    vector<std::exception_ptr> exceptions(elements.size());
+    for (size_t i = 0; i < elements.size(); i++)
+    {
+        ElementPtr element = elements[i];
+        vector<NodeDefPtr> nodeDefs;
+        if (NodePtr node = element->asA<Node>())
+        {
+            nodeDefs.push_back(node->getNodeDef());
+        }
+        else if (ShaderRefPtr shaderRef = element->asA<ShaderRef>())
+        {
+            nodeDefs.push_back(shaderRef->getNodeDef());
+        }
+        for (Edge edge : element->traverseGraph())
+        {
+            NodePtr node = edge.getUpstreamElement() ? edge.getUpstreamElement()->asA<Node>() : nullptr;
+            if (node)
+            {
+                nodeDefs.push_back(node->getNodeDef());
+            }
+        }
+        try
+        {
+            for (NodeDefPtr nodeDef : nodeDefs)
+            {
+                InterfaceElementPtr impl = nodeDef ? nodeDef->getImplementation(getTarget(), getLanguage()) : nullptr;
+                if (impl)
+                {
+                    getImplementation(*impl, context);
+                }
+            }
+        }
+        catch (...)
+        {
+            exceptions[i] = std::current_exception();
+        }
+    }
+
+    if (!threadCount)
+    {
+        threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    size_t workerCount = std::max(std::min((size_t) threadCount, elements.size()), (size_t) 1);
+    vector<GenContext> workerContexts;
+    workerContexts.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; i++)
+    {
+        workerContexts.push_back(context.createWorkerContext());
+    }
+
+    // Each worker generates the next unclaimed element with its own context.
+    vector<ShaderPtr> shaders(elements.size());
+    std::atomic<size_t> nextIndex(0);
+    parallelFor(workerCount, [&](size_t workerIndex)
+    {
+        GenContext& workerContext = workerContexts[workerIndex];
+        for (size_t i = nextIndex++; i < elements.size(); i = nextIndex++)
+        {
+            if (exceptions[i])
+            {
+                continue;
+            }
+            try
+            {
+                shaders[i] = generate(elements[i]->getName(), elements[i], workerContext);
+            }
+            catch (...)
+            {
+                exceptions[i] = std::current_exception();
+            }
+        }
+    }, (unsigned int) workerCount);
+
+    for (const std::exception_ptr& exception : exceptions)
+    {
+        if (exception)
+        {
+            std::rethrow_exception(exception);
+        }
+    }
+    return shaders;
+}
+
+string ShaderGenerator::getTopologySignature(const Shader& shader) const
+{
+    StableHasher hasher;
+    hasher.add(getTarget());
+    hasher.add(getLanguage());
+
+    std::set<string> attributes;
+    for (const auto& it : shader._attributeMap)
+    {
+        attributes.insert(it.first + "=" + (it.second ? it.second->getValueString() : EMPTY_STRING));
+    }
+    for (const string& attribute : attributes)
+    {
+        hasher.add(attribute);
+    }
+
+    // Give the variables of the graph and the uniforms of each stage names
+    // based on their positions, so that shaders whose nodes are named
+    // differently share a signature.
+    std::unordered_map<string, string> names;
+    auto addName = [&names](const string& variable)
+    {
+        if (!names.count(variable))
+        {
+            const string name = "$" + std::to_string(names.size());
+            names[variable] = name;
+        }
+    };
+    const ShaderGraph& graph = shader.getGraph();
+    for (const ShaderGraphInputSocket* socket : graph.getInputSockets())
+    {
+        addName(socket->getVariable());
+    }
+    for (const ShaderNode* node : graph.getNodes())
+    {
+        for (const ShaderOutput* output : node->getOutputs())
+        {
+            addName(output->getVariable());
+        }
+    }
+    for (const ShaderGraphOutputSocket* socket : graph.getOutputSockets())
+    {
+        addName(socket->getVariable());
+    }
+    for (size_t i = 0; i < shader.numStages(); i++)
+    {
+        for (const VariableBlock* block : getOrderedUniformBlocks(shader.getStage(i)))
+        {
+            for (const ShaderPort* variable : block->getVariableOrder())
+            {
+                addName(variable->getVariable());
+            }
+        }
+    }
+
+    for (size_t i = 0; i < shader.numStages(); i++)
+    {
+        const ShaderStage& stage = shader.getStage(i);
+        string code = stage.getSourceCode();
+        for (const VariableBlock* block : getOrderedUniformBlocks(stage))
+        {
+            for (const ShaderPort* variable : block->getVariableOrder())
+            {
+                removeDeclaredValue(code, variable->getVariable());
+            }
+        }
+        hasher.add(stage.getName());
+        hasher.add(renameIdentifiers(code, names));
+    }
+    return hasher.getKey();
+}
+
+vector<ShaderInstance> ShaderGenerator::generateInstanced(const vector<ElementPtr>& elements, GenContext& context,
+                                                          unsigned int threadCount) const
+{
+    vector<ShaderPtr> shaders = generateAll(elements, context, threadCount);
+
+    vector<ShaderInstance> instances(shaders.size());
+    std::unordered_map<string, ShaderPtr> sharedShaders;
+    for (size_t i = 0; i < shaders.size(); i++)
+    {
+        // The first shader generated with each signature is shared.
+        ShaderInstance& instance = instances[i];
+        instance.signature = getTopologySignature(*shaders[i]);
+        ShaderPtr& sharedShader = sharedShaders[instance.signature];
+        if (!sharedShader)
+        {
+            sharedShader = shaders[i];
+        }
+        instance.shader = sharedShader;
+
+        // Record the uniform values of the element under the names of the
+        // uniforms at the same positions in the shared shader, which must
+        // have the same types in the generated code.  Uniforms are not matched by name, as the
+        // topology signature renames them by position, so a name may
+        // belong to a different uniform in the shared shader.
+        if (sharedShader->numStages() != shaders[i]->numStages())
+        {
+            throw ExceptionShaderGenError("Stages of shader '" + shaders[i]->getName() +
+                                          "' do not match shared shader '" + sharedShader->getName() + "'");
+        }
+        for (size_t j = 0; j < shaders[i]->numStages(); j++)
+        {
+            const ShaderStage& stage = shaders[i]->getStage(j);
+            vector<const VariableBlock*> blocks = getOrderedUniformBlocks(stage);
+            vector<const VariableBlock*> sharedBlocks = getOrderedUniformBlocks(sharedShader->getStage(j));
+            if (sharedBlocks.size() != blocks.size())
+            {
+                throw ExceptionShaderGenError("Uniform blocks of stage '" + stage.getName() + "' in shader '" +
+                                              shaders[i]->getName() + "' do not match shared shader '" + sharedShader->getName() + "'");
+            }
+            for (size_t k = 0; k < blocks.size(); k++)
+            {
+                const VariableBlock& block = *blocks[k];
+                const VariableBlock& sharedBlock = *sharedBlocks[k];
+                if (sharedBlock.getName() != block.getName() || sharedBlock.size() != block.size())
+                {
+                    throw ExceptionShaderGenError("Uniform block '" + block.getName() + "' in shader '" +
+                                                  shaders[i]->getName() + "' does not match shared shader '" + sharedShader->getName() + "'");
+                }
+                for (size_t n = 0; n < block.size(); n++)
+                {
+                    const ShaderPort* variable = block[n];
+                    const ShaderPort* sharedVariable = sharedBlock[n];
+                    if (_syntax->getTypeName(sharedVariable->getType()) != _syntax->getTypeName(variable->getType()))
+                    {
+                        throw ExceptionShaderGenError("Uniform '" + variable->getVariable() + "' in shader '" +
+                                                      shaders[i]->getName() + "' does not match shared shader '" + sharedShader->getName() + "'");
+                    }
+                    if (variable->getValue())
+                    {
+                        instance.uniformValues[sharedVariable->getVariable()] = variable->getValue();
+                    }
+                }
+            }
+        }
+    }
+    return instances;
+}
+
 void ShaderGenerator::emitScopeBegin(ShaderStage& stage, Syntax::Punctuation punc) const
 {
     stage.beginScope(punc);
@@ -83,6 +399,11 @@ void ShaderGenerator::emitInclude(const string& file, GenContext& context, Shade
     stage.addInclude(file, context);
 }
 
+void ShaderGenerator::emitSourceFile(const SourceFile& file, GenContext& context, ShaderStage& stage) const
+{
+    stage.addSourceFile(file, context);
+}
+
 void ShaderGenerator::emitFunctionDefinition(const ShaderNode& node, GenContext& context, ShaderStage& stage) const
 {
     stage.addFunctionDefinition(node, context);
@@ -247,6 +568,20 @@ ShaderNodeImplPtr ShaderGenerator::getImplementation(const InterfaceElement& ele
         return impl;
     }
 
+    // Check if it's created by another context sharing a registry.
+    ShaderNodeImplRegistryPtr registry = context.getImplementationRegistry();
+    string key;
+    if (registry)
+    {
+        key = getImplementationKey(element, context);
+        impl = registry->find(key);
+        if (impl)
+        {
+            context.addNodeImplementation(name, impl);
+            return impl;
+        }
+    }
+
     if (element.isA<NodeGraph>())
     {
         // Use a compound implementation.
@@ -268,12 +603,36 @@ ShaderNodeImplPtr ShaderGenerator::getImplementation(const InterfaceElement& ele
     }
     impl->initialize(element, context);
 
-    // Cache it.
+    // Cache it, keeping any implementation registered concurrently by
+    // another context.
+    if (registry)
+    {
+        impl = registry->add(key, impl);
+    }
     context.addNodeImplementation(name, impl);
 
     return impl;
 }
 
+string ShaderGenerator::getImplementationKey(const InterfaceElement& element, const GenContext& context) const
+{
+    // The target color space falls back to the active color space of the
+    // source document when no override is given.
+    const GenOptions& options = context.getOptions();
+    ConstDocumentPtr doc = element.getDocument();
+    const string targetColorSpace = !options.targetColorSpaceOverride.empty() ? options.targetColorSpaceOverride :
+                                    (doc ? doc->getActiveColorSpace() : EMPTY_STRING);
+    string key = element.getName() + "|" + getTarget() + "|" + getLanguage() + "|" +
+                 std::to_string(options.optimizationLevel) + "|" +
+                 targetColorSpace + "|" +
+                 (_colorManagementSystem ? _colorManagementSystem->getName() : EMPTY_STRING);
+    for (const FilePath& path : context.getSourceCodeSearchPath().paths())
+    {
+        key += "|" + path.asString();
+    }
+    return key;
+}
+
 bool ShaderGenerator::remapEnumeration(const ValueElement&, const string&, std::pair<const TypeDesc*, ValuePtr>&) const
 {
     return false;
@@ -42,6 +42,45 @@ class ShaderGenerator
     /// the element and all dependencies upstream into shader code.
     virtual ShaderPtr generate(const string& name, ElementPtr element, GenContext& context) const = 0;
 
+    /// Generate shaders for the given elements in parallel, returning the
+    /// shaders in the order of the elements.  Each shader is named after its
+    /// element.
+    ///
+    /// The node implementations needed by the elements are created up front
+    /// in the given context, and shared by lightweight worker contexts
+    /// created with GenContext::createWorkerContext, one for each thread.
+    /// The generator and documents involved must not be edited while the
+    /// shaders are generated.
+    /// @param elements The elements for which shaders are generated.
+    /// @param context The context whose options, search path and cached
+    ///    implementations are used for generation.
+    /// @param threadCount The number of threads to use.  If zero, the
+    ///    number of hardware threads is used.
+    /// @throws The exception thrown for the first element, in the order of
+    ///    the elements, whose generation failed.
+    vector<ShaderPtr> generateAll(const vector<ElementPtr>& elements, GenContext& context,
+                                  unsigned int threadCount = 0) const;
+
+    /// Return the topology signature of a generated shader: a stable hash
+    /// of the generator target and language, the shader attributes, and the
+    /// source code of each stage with the values of uniforms excluded and
+    /// the variables of the shader graph and uniform blocks renamed by
+    /// position.  Shaders with the same signature differ only in uniform
+    /// values and variable names, and may share one program.
+    string getTopologySignature(const Shader& shader) const;
+
+    /// Generate shaders for the given elements in parallel, as generateAll
+    /// does, and share one shader between all elements with the same
+    /// topology signature.  Returns an instance for each element, in the
+    /// order of the elements, holding the shared shader and the uniform
+    /// values of the element.
+    /// @throws The exception thrown for the first element, in the order of
+    ///    the elements, whose generation failed, or ExceptionShaderGenError
+    ///    if the uniforms of an element do not match those of its shared
+    ///    shader.
+    vector<ShaderInstance> generateInstanced(const vector<ElementPtr>& elements, GenContext& context,
+                                             unsigned int threadCount = 0) const;
+
     /// Start a new scope using the given bracket type.
     virtual void emitScopeBegin(ShaderStage& stage, Syntax::Punctuation punc = Syntax::CURLY_BRACKETS) const;
 
@@ -73,6 +112,12 @@ class ShaderGenerator
     /// only included once for the shader stage.
     virtual void emitInclude(const string& file, GenContext& context, ShaderStage& stage) const;
 
+    /// Add the contents of a source file as a block of code.  This is used
+    /// for the function definitions of source code implementations, so
+    /// generators that transform code passed to emitBlock should override
+    /// this method as well.
+    virtual void emitSourceFile(const SourceFile& file, GenContext& context, ShaderStage& stage) const;
+
     /// Add a value.
     template<typename T>
     void emitValue(const T& value, ShaderStage& stage) const
@@ -153,6 +198,32 @@ class ShaderGenerator
     /// will be returned, as defined by the createDefaultImplementation method.
     ShaderNodeImplPtr getImplementation(const InterfaceElement& element, GenContext& context) const;
 
+    /// Return the registry of node implementations owned by this generator,
+    /// to which generation contexts may be attached in order to share node
+    /// implementations between them.
+    ShaderNodeImplRegistryPtr getImplementationRegistry() const
+    {
+        return _implRegistry;
+    }
+
+    /// Return the registry of compound node graphs owned by this generator,
+    /// to which generation contexts may be attached in order to share the
+    /// graphs of compound node implementations between them.
+    ShaderGraphRegistryPtr getGraphRegistry() const
+    {
+        return _graphRegistry;
+    }
+
+    /// Return the key identifying the node implementation created for the
+    /// given implementation element in an implementation registry.  The key
+    /// holds the name of the element, the target and language of the
+    /// generator, and the state of the context that affects the
+    /// initialization of implementations: the source code search path, the
+    /// optimization level, the target color space, given by the override
+    /// of the context or the active color space of the source document,
+    /// and the color management system.
+    virtual string getImplementationKey(const InterfaceElement& element, const GenContext& context) const;
+
     /// Given an input specification attempt to remap this to an enumeration which is accepted by
     /// the shader generator. The enumeration may be converted to a different type than the input.
     /// @param input Nodedef input potentially holding an enum definition.
@@ -185,6 +256,8 @@ class ShaderGenerator
 
     SyntaxPtr _syntax;
     Factory<ShaderNodeImpl> _implFactory;
+    ShaderNodeImplRegistryPtr _implRegistry;
+    ShaderGraphRegistryPtr _graphRegistry;
     ColorManagementSystemPtr _colorManagementSystem;
 };
 
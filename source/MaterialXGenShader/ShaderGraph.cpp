@@ -10,12 +10,304 @@
 #include <MaterialXGenShader/ShaderGenerator.h>
 #include <MaterialXGenShader/TypeDesc.h>
 #include <MaterialXGenShader/Util.h>
+#include <MaterialXGenShader/Nodes/ConvertNode.h>
 
 #include <MaterialXCore/Document.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <unordered_set>
+
 namespace MaterialX
 {
 
+namespace {
+
+template <class T> void appendComponents(ValuePtr value, vector<float>& components)
+{
+    const T& v = value->asA<T>();
+    components.insert(components.end(), v.begin(), v.end());
+}
+
+template <class T> ValuePtr createAggregate(const vector<float>& components)
+{
+    return Value::createValue<T>(T(components));
+}
+
+// Return the components of a literal value of the given type, or false if
+// the type is not supported by constant folding.
+bool getComponents(const TypeDesc* type, ValuePtr value, vector<float>& components)
+{
+    components.clear();
+    if (!value)
+    {
+        return false;
+    }
+    if (type == Type::FLOAT && value->isA<float>())
+    {
+        components.push_back(value->asA<float>());
+    }
+    else if (type == Type::INTEGER && value->isA<int>())
+    {
+        components.push_back((float) value->asA<int>());
+    }
+    else if (type == Type::BOOLEAN && value->isA<bool>())
+    {
+        components.push_back(value->asA<bool>() ? 1.0f : 0.0f);
+    }
+    else if (type == Type::COLOR2 && value->isA<Color2>())
+    {
+        appendComponents<Color2>(value, components);
+    }
+    else if (type == Type::COLOR3 && value->isA<Color3>())
+    {
+        appendComponents<Color3>(value, components);
+    }
+    else if (type == Type::COLOR4 && value->isA<Color4>())
+    {
+        appendComponents<Color4>(value, components);
+    }
+    else if (type == Type::VECTOR2 && value->isA<Vector2>())
+    {
+        appendComponents<Vector2>(value, components);
+    }
+    else if (type == Type::VECTOR3 && value->isA<Vector3>())
+    {
+        appendComponents<Vector3>(value, components);
+    }
+    else if (type == Type::VECTOR4 && value->isA<Vector4>())
+    {
+        appendComponents<Vector4>(value, components);
+    }
+    return !components.empty();
+}
+
+// Create a value of the given float-based type from its components, or
+// return nullptr if the type is not supported or a component is not finite.
+ValuePtr createValue(const TypeDesc* type, const vector<float>& components)
+{
+    if (components.size() != type->getSize())
+    {
+        return nullptr;
+    }
+    for (float component : components)
+    {
+        if (!std::isfinite(component))
+        {
+            return nullptr;
+        }
+    }
+    if (type == Type::FLOAT)
+    {
+        return Value::createValue<float>(components[0]);
+    }
+    if (type == Type::COLOR2)
+    {
+        return createAggregate<Color2>(components);
+    }
+    if (type == Type::COLOR3)
+    {
+        return createAggregate<Color3>(components);
+    }
+    if (type == Type::COLOR4)
+    {
+        return createAggregate<Color4>(components);
+    }
+    if (type == Type::VECTOR2)
+    {
+        return createAggregate<Vector2>(components);
+    }
+    if (type == Type::VECTOR3)
+    {
+        return createAggregate<Vector3>(components);
+    }
+    if (type == Type::VECTOR4)
+    {
+        return createAggregate<Vector4>(components);
+    }
+    return nullptr;
+}
+
+// Apply a swizzle pattern to the components of a value of the given type.
+// Scalar values are broadcast, and the characters '0' and '1' give constant
+// components, matching Syntax::getSwizzledVariable.
+bool swizzleComponents(const vector<float>& components, const TypeDesc* type, const string& channels, vector<float>& result)
+{
+    result.clear();
+    for (char ch : channels)
+    {
+        if (ch == '0' || ch == '1')
+        {
+            result.push_back(ch == '1' ? 1.0f : 0.0f);
+        }
+        else if (type->isScalar())
+        {
+            result.push_back(components[0]);
+        }
+        else
+        {
+            int index = type->getChannelIndex(ch);
+            if (index < 0 || index >= (int) components.size())
+            {
+                return false;
+            }
+            result.push_back(components[index]);
+        }
+    }
+    return true;
+}
+
+// Return the components of the named input of a node, or false if the input
+// is missing or its value is not supported by constant folding.
+bool getInputComponents(const ShaderNode& node, const string& name, vector<float>& components)
+{
+    const ShaderInput* input = node.getInput(name);
+    return input && getComponents(input->getType(), input->getValue(), components);
+}
+
+// Combine the components of two operands component-wise, broadcasting a
+// scalar second operand.
+template <class F> bool combineComponents(vector<float>& a, const vector<float>& b, F func)
+{
+    if (b.size() != a.size() && b.size() != 1)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        a[i] = func(a[i], b[b.size() == 1 ? 0 : i]);
+    }
+    return true;
+}
+
+// Evaluate a node of the standard library whose inputs are all literal
+// values, returning its result, or nullptr if the node cannot be folded.
+ValuePtr evaluateNode(const ShaderNode& node)
+{
+    static const string IN1("in1");
+    static const string IN2("in2");
+    static const string IN("in");
+
+    const string& category = node.getCategory();
+    const TypeDesc* outType = node.getOutput()->getType();
+    vector<float> result, operand;
+
+    if (category == "add" || category == "subtract" || category == "multiply" ||
+        category == "divide" || category == "min" || category == "max")
+    {
+        if (!getInputComponents(node, IN1, result) || !getInputComponents(node, IN2, operand))
+        {
+            return nullptr;
+        }
+        bool valid =
+            category == "add" ? combineComponents(result, operand, [](float a, float b) { return a + b; }) :
+            category == "subtract" ? combineComponents(result, operand, [](float a, float b) { return a - b; }) :
+            category == "multiply" ? combineComponents(result, operand, [](float a, float b) { return a * b; }) :
+            category == "divide" ? combineComponents(result, operand, [](float a, float b) { return a / b; }) :
+            category == "min" ? combineComponents(result, operand, [](float a, float b) { return std::min(a, b); }) :
+                                combineComponents(result, operand, [](float a, float b) { return std::max(a, b); });
+        if (!valid)
+        {
+            return nullptr;
+        }
+    }
+    else if (category == "invert")
+    {
+        if (!getInputComponents(node, IN, result) || !getInputComponents(node, "amount", operand) ||
+            !combineComponents(result, operand, [](float a, float b) { return b - a; }))
+        {
+            return nullptr;
+        }
+    }
+    else if (category == "absval")
+    {
+        if (!getInputComponents(node, IN, result))
+        {
+            return nullptr;
+        }
+        for (float& component : result)
+        {
+            component = std::abs(component);
+        }
+    }
+    else if (category == "clamp")
+    {
+        vector<float> high;
+        if (!getInputComponents(node, IN, result) || !getInputComponents(node, "low", operand) ||
+            !getInputComponents(node, "high", high) ||
+            !combineComponents(result, operand, [](float a, float b) { return std::max(a, b); }) ||
+            !combineComponents(result, high, [](float a, float b) { return std::min(a, b); }))
+        {
+            return nullptr;
+        }
+    }
+    else if (category == "convert")
+    {
+        const ShaderInput* input = node.getInput(IN);
+        if (!input || !getComponents(input->getType(), input->getValue(), operand))
+        {
+            return nullptr;
+        }
+        if (input->getType()->isScalar() && outType->isScalar())
+        {
+            result = operand;
+        }
+        else if (!swizzleComponents(operand, input->getType(), ConvertNode::getSwizzle(input->getType(), outType), result))
+        {
+            return nullptr;
+        }
+    }
+    else if (category == "swizzle")
+    {
+        const ShaderInput* input = node.getInput(IN);
+        const ShaderInput* channels = node.getInput("channels");
+        if (!input || !channels || !channels->getValue() ||
+            !getComponents(input->getType(), input->getValue(), operand) ||
+            !swizzleComponents(operand, input->getType(), channels->getValue()->getValueString(), result))
+        {
+            return nullptr;
+        }
+    }
+    else if (category == "combine")
+    {
+        for (const ShaderInput* input : node.getInputs())
+        {
+            if (!getComponents(input->getType(), input->getValue(), operand))
+            {
+                return nullptr;
+            }
+            result.insert(result.end(), operand.begin(), operand.end());
+        }
+    }
+    else
+    {
+        return nullptr;
+    }
+
+    return createValue(outType, result);
+}
+
+// Return true if a uniform of the given name and type keeps its value
+// dynamic, rather than having it specialized into the generated code.
+bool isDynamicUniform(const string& name, const TypeDesc* type, const GenOptions& options)
+{
+    return !options.specializeUniforms || type == Type::FILENAME || options.dynamicUniforms.count(name);
+}
+
+// Return true if the given unconnected input of a node will be published
+// as a uniform when its graph is finalized.
+bool isPublishedInput(const ShaderNode& node, const ShaderInput& input, const GenOptions& options)
+{
+    return options.shaderInterfaceType == SHADER_INTERFACE_COMPLETE &&
+           input.getType()->isEditable() && node.isEditable(input) &&
+           isDynamicUniform(node.getName() + "_" + input.getName(), input.getType(), options);
+}
+
+} // anonymous namespace
+
 //
 // ShaderGraph methods
 //
@@ -675,6 +967,20 @@ ShaderGraphOutputSocket* ShaderGraph::addOutputSocket(const string& name, const
     return ShaderNode::addInput(name, type);
 }
 
+size_t ShaderGraph::getMemoryBytes() const
+{
+    size_t bytes = ShaderNode::getMemoryBytes() - sizeof(ShaderNode) + sizeof(ShaderGraph) +
+                   getHashedHeapBytes(_nodeMap) + getHeapBytes(_nodeOrder) +
+                   getHashedHeapBytes(_inputColorTransformMap) +
+                   getHashedHeapBytes(_outputColorTransformMap);
+    for (const ShaderNode* node : _nodeOrder)
+    {
+        // Node names are also held as keys in the node map.
+        bytes += getHeapBytes(node->getName()) + node->getMemoryBytes();
+    }
+    return bytes;
+}
+
 ShaderGraphEdgeIterator ShaderGraph::traverseUpstream(ShaderOutput* output)
 {
     return ShaderGraphEdgeIterator(output);
@@ -705,6 +1011,13 @@ void ShaderGraph::finalize(GenContext& context)
     _inputColorTransformMap.clear();
     _outputColorTransformMap.clear();
 
+    // Bake the values of interface inputs into the graph,
+    // so that they take part in optimization.
+    if (context.getOptions().specializeUniforms)
+    {
+        specializeInputSockets(context);
+    }
+
     // Optimize the graph, removing redundant paths.
     optimize(context);
 
@@ -718,8 +1031,9 @@ void ShaderGraph::finalize(GenContext& context)
                 if (!input->getConnection())
                 {
                     // Check if the type is editable otherwise we can't
-                    // publish the input as an editable uniform.
-                    if (input->getType()->isEditable() && node->isEditable(*input))
+                    // publish the input as an editable uniform, and
+                    // if the input has been specialized.
+                    if (isPublishedInput(*node, *input, context.getOptions()))
                     {
                         // Use a consistent naming convention: <nodename>_<inputname>
                         // so application side can figure out what uniforms to set
@@ -801,47 +1115,43 @@ void ShaderGraph::optimize(GenContext& context)
                 ++numEdits;
             }
         }
-        else if (node->hasClassification(ShaderNode::Classification::IFELSE))
+        else if (bypassConditional(context, node))
         {
-            // Check if we have a constant conditional expression
-            ShaderInput* intest = node->getInput("intest");
-            if (!intest->getConnection() || intest->getConnection()->getNode()->hasClassification(ShaderNode::Classification::CONSTANT))
-            {
-                // Find which branch should be taken
-                ShaderInput* cutoff = node->getInput("cutoff");
-                ValuePtr value = intest->getConnection() ? intest->getConnection()->getNode()->getInput(0)->getValue() : intest->getValue();
-                const float intestValue = value ? value->asA<float>() : 0.0f;
-                const int branch = (intestValue <= cutoff->getValue()->asA<float>() ? 2 : 3);
-
-                // Bypass the conditional using the taken branch
-                bypass(context, node, branch);
-
-                ++numEdits;
-            }
+            ++numEdits;
         }
-        else if (node->hasClassification(ShaderNode::Classification::SWITCH))
+    }
+
+    if (context.getOptions().optimizationLevel >= SHADER_OPTIMIZATION_CONSTANT_FOLDING)
+    {
+        // Folding may leave literal selectors on conditional nodes still in use,
+        // so alternate folding and bypassing until neither applies.
+        size_t numPassEdits = foldConstants(context);
+        while (numPassEdits > 0)
         {
-            // Check if we have a constant conditional expression
-            ShaderInput* which = node->getInput("which");
-            if (!which->getConnection() || which->getConnection()->getNode()->hasClassification(ShaderNode::Classification::CONSTANT))
+            numEdits += numPassEdits;
+            numPassEdits = 0;
+            for (ShaderNode* node : _nodeOrder)
             {
-                // Find which branch should be taken
-                ValuePtr value = which->getConnection() ? which->getConnection()->getNode()->getInput(0)->getValue() : which->getValue();
-                const int branch = int(value==nullptr ? 0 :
-                    (which->getType() == Type::BOOLEAN ? value->asA<bool>() :
-                    (which->getType() == Type::FLOAT ? value->asA<float>() : value->asA<int>())));
-
-                // Bypass the conditional using the taken branch
-                bypass(context, node, branch);
-
-                ++numEdits;
+                if (node->numOutputs() == 1 && !node->getOutput()->getConnections().empty() &&
+                    bypassConditional(context, node))
+                {
+                    ++numPassEdits;
+                }
+            }
+            if (numPassEdits > 0)
+            {
+                numPassEdits += foldConstants(context);
             }
         }
     }
+    if (context.getOptions().optimizationLevel >= SHADER_OPTIMIZATION_COMMON_SUBEXPRESSIONS)
+    {
+        numEdits += eliminateCommonSubexpressions(context);
+    }
 
     if (numEdits > 0)
     {
-        std::set<ShaderNode*> usedNodes;
+        std::unordered_set<ShaderNode*> usedNodes;
 
         // Travers the graph to find nodes still in use
         for (ShaderGraphOutputSocket* outputSocket : getOutputSockets())
@@ -855,7 +1165,10 @@ void ShaderGraph::optimize(GenContext& context)
             }
         }
 
-        // Remove any unused nodes
+        // Remove any unused nodes, preserving the order of the nodes
+        // still in use so that generated code is stable between runs.
+        vector<ShaderNode*> usedNodeOrder;
+        usedNodeOrder.reserve(usedNodes.size());
         for (ShaderNode* node : _nodeOrder)
         {
             if (usedNodes.count(node) == 0)
@@ -866,11 +1179,272 @@ void ShaderGraph::optimize(GenContext& context)
                 // Erase from storage
                 _nodeMap.erase(node->getName());
             }
+            else
+            {
+                usedNodeOrder.push_back(node);
+            }
+        }
+
+        _nodeOrder = usedNodeOrder;
+    }
+}
+
+bool ShaderGraph::bypassConditional(GenContext& context, ShaderNode* node)
+{
+    if (node->hasClassification(ShaderNode::Classification::IFELSE))
+    {
+        // Check if we have a constant conditional expression
+        ShaderInput* intest = node->getInput("intest");
+        if (!intest->getConnection() || intest->getConnection()->getNode()->hasClassification(ShaderNode::Classification::CONSTANT))
+        {
+            // Find which branch should be taken
+            ShaderInput* cutoff = node->getInput("cutoff");
+            ValuePtr value = intest->getConnection() ? intest->getConnection()->getNode()->getInput(0)->getValue() : intest->getValue();
+            const float intestValue = value ? value->asA<float>() : 0.0f;
+            const int branch = (intestValue <= cutoff->getValue()->asA<float>() ? 2 : 3);
+
+            // Bypass the conditional using the taken branch
+            bypass(context, node, branch);
+            return true;
+        }
+    }
+    else if (node->hasClassification(ShaderNode::Classification::SWITCH))
+    {
+        // Check if we have a constant conditional expression
+        ShaderInput* which = node->getInput("which");
+        if (!which->getConnection() || which->getConnection()->getNode()->hasClassification(ShaderNode::Classification::CONSTANT))
+        {
+            // Find which branch should be taken
+            ValuePtr value = which->getConnection() ? which->getConnection()->getNode()->getInput(0)->getValue() : which->getValue();
+            const int branch = int(value==nullptr ? 0 :
+                (which->getType() == Type::BOOLEAN ? value->asA<bool>() :
+                (which->getType() == Type::FLOAT ? value->asA<float>() : value->asA<int>())));
+
+            // Bypass the conditional using the taken branch
+            bypass(context, node, branch);
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t ShaderGraph::foldConstants(GenContext& context)
+{
+    // Inputs that will be published as uniforms must remain editable,
+    // so nodes using them are never folded.
+    const GenOptions& options = context.getOptions();
+
+    size_t numFolded = 0;
+    bool folded = true;
+    while (folded)
+    {
+        // Folding a node assigns literal values downstream, which may
+        // allow further nodes to be folded on the next pass.
+        folded = false;
+        for (ShaderNode* node : _nodeOrder)
+        {
+            if (node->hasClassification(ShaderNode::Classification::DO_NOT_OPTIMIZE) ||
+                node->getCategory().empty() || node->numOutputs() != 1 ||
+                !node->hasStandardNodeDef())
+            {
+                continue;
+            }
+            ShaderOutput* output = node->getOutput();
+            if (output->getConnections().empty())
+            {
+                continue;
+            }
+
+            bool literal = true;
+            for (ShaderInput* input : node->getInputs())
+            {
+                if (input->getConnection() || isPublishedInput(*node, *input, options))
+                {
+                    literal = false;
+                    break;
+                }
+            }
+            if (!literal)
+            {
+                continue;
+            }
+
+            ValuePtr value = evaluateNode(*node);
+            if (!value)
+            {
+                continue;
+            }
+
+            // Compute the value assigned to each downstream input, applying
+            // any channel swizzles. Graph outputs are left connected.
+            vector<float> components;
+            getComponents(output->getType(), value, components);
+            vector<std::pair<ShaderInput*, ValuePtr>> assignments;
+            for (ShaderInput* downstream : output->getConnections())
+            {
+                ValuePtr downstreamValue = value;
+                const string& channels = downstream->getChannels();
+                if (!channels.empty())
+                {
+                    vector<float> swizzled;
+                    downstreamValue = swizzleComponents(components, output->getType(), channels, swizzled) ?
+                                      createValue(downstream->getType(), swizzled) : nullptr;
+                }
+                if (downstream->getNode() == this || !downstreamValue)
+                {
+                    assignments.clear();
+                    break;
+                }
+                assignments.push_back(std::make_pair(downstream, downstreamValue));
+            }
+            if (assignments.empty())
+            {
+                continue;
+            }
+
+            for (const auto& assignment : assignments)
+            {
+                output->breakConnection(assignment.first);
+                assignment.first->setValue(assignment.second);
+                assignment.first->setChannels(EMPTY_STRING);
+            }
+            folded = true;
+            ++numFolded;
+        }
+    }
+    return numFolded;
+}
+
+size_t ShaderGraph::eliminateCommonSubexpressions(GenContext& context)
+{
+    // Inputs that will be published as uniforms must remain editable
+    // per node, so nodes using them are never merged.
+    const GenOptions& options = context.getOptions();
+    const Syntax& syntax = context.getShaderGenerator().getSyntax();
+
+    size_t numMerged = 0;
+    bool merged = true;
+    while (merged)
+    {
+        // Merging a node reroutes its downstream connections, which may
+        // make further nodes identical on the next pass.
+        merged = false;
+        std::unordered_map<string, ShaderNode*> expressions;
+        for (ShaderNode* node : _nodeOrder)
+        {
+            if (node->hasClassification(ShaderNode::Classification::DO_NOT_OPTIMIZE) ||
+                node->hasClassification(ShaderNode::Classification::CLOSURE) ||
+                node->hasClassification(ShaderNode::Classification::SHADER))
+            {
+                continue;
+            }
+
+            // Build a key from the implementation, outputs and inputs of the
+            // node. Literal values are keyed by their emitted form.
+            bool used = false;
+            string key = std::to_string(reinterpret_cast<uintptr_t>(&node->getImplementation()));
+            for (ShaderOutput* output : node->getOutputs())
+            {
+                used = used || !output->getConnections().empty();
+                key += "|" + output->getName() + ":" + output->getType()->getName();
+            }
+            bool eligible = used;
+            for (ShaderInput* input : node->getInputs())
+            {
+                if (!eligible)
+                {
+                    break;
+                }
+                key += "|" + input->getName() + ":" + input->getType()->getName() + ":" + input->getChannels() + ":";
+                ShaderOutput* upstream = input->getConnection();
+                if (upstream)
+                {
+                    key += "@" + std::to_string(reinterpret_cast<uintptr_t>(upstream));
+                }
+                else if (isPublishedInput(*node, *input, options))
+                {
+                    eligible = false;
+                }
+                else if (input->getValue())
+                {
+                    key += syntax.getValue(input->getType(), *input->getValue());
+                }
+            }
+            if (!eligible)
+            {
+                continue;
+            }
+
+            auto it = expressions.find(key);
+            if (it == expressions.end())
+            {
+                expressions[key] = node;
+                continue;
+            }
+
+            // Reroute the downstream connections of the duplicate.
+            // Iterate copies of the connection sets since the
+            // original sets will change when breaking connections.
+            ShaderNode* original = it->second;
+            for (size_t i = 0; i < node->numOutputs(); ++i)
+            {
+                ShaderOutput* output = node->getOutput(i);
+                ShaderInputSet downstreamConnections = output->getConnections();
+                for (ShaderInput* downstream : downstreamConnections)
+                {
+                    output->breakConnection(downstream);
+                    downstream->makeConnection(original->getOutput(i));
+                }
+            }
+            merged = true;
+            ++numMerged;
+        }
+    }
+    return numMerged;
+}
+
+size_t ShaderGraph::specializeInputSockets(GenContext& context)
+{
+    const GenOptions& options = context.getOptions();
+    const Syntax& syntax = context.getShaderGenerator().getSyntax();
+
+    size_t numSpecialized = 0;
+    for (ShaderGraphInputSocket* inputSocket : getInputSockets())
+    {
+        // Sockets without a value, or of types that cannot be published,
+        // are left connected.
+        if (!inputSocket->getValue() || !inputSocket->getType()->isEditable() || !isEditable(*inputSocket) ||
+            isDynamicUniform(inputSocket->getName(), inputSocket->getType(), options))
+        {
+            continue;
         }
 
-        _nodeOrder.resize(usedNodes.size());
-        _nodeOrder.assign(usedNodes.begin(), usedNodes.end());
+        // Push the socket's value and element path downstream.
+        // Iterate a copy of the connection set since the
+        // original set will change when breaking connections.
+        ShaderInputSet downstreamConnections = inputSocket->getConnections();
+        for (ShaderInput* downstream : downstreamConnections)
+        {
+            inputSocket->breakConnection(downstream);
+            downstream->setValue(inputSocket->getValue());
+            downstream->setPath(inputSocket->getPath());
+
+            const string& channels = downstream->getChannels();
+            if (!channels.empty())
+            {
+                downstream->setValue(syntax.getSwizzledValue(inputSocket->getValue(),
+                                                             inputSocket->getType(),
+                                                             channels,
+                                                             downstream->getType()));
+                downstream->setChannels(EMPTY_STRING);
+            }
+        }
+        if (!downstreamConnections.empty())
+        {
+            numSpecialized++;
+        }
     }
+    return numSpecialized;
 }
 
 void ShaderGraph::bypass(GenContext& context, ShaderNode* node, size_t inputIndex, size_t outputIndex)
@@ -923,16 +1497,19 @@ void ShaderGraph::bypass(GenContext& context, ShaderNode* node, size_t inputInde
 void ShaderGraph::topologicalSort()
 {
     // Calculate a topological order of the children, using Kahn's algorithm
-    // to avoid recursion.
+    // to avoid recursion.  Among the nodes whose inputs are ready, the node
+    // that comes first in the current order is always taken next, so the
+    // result is independent of the addresses of nodes and connections.
     //
-    // Running time: O(numNodes + numEdges).
+    // Running time: O((numNodes + numEdges) * log(numNodes)).
 
     // Calculate in-degrees for all nodes, and enqueue those with degree 0.
-    std::unordered_map<ShaderNode*, int> inDegree(_nodeMap.size());
-    std::deque<ShaderNode*> nodeQueue;
-    for (auto it : _nodeMap)
+    std::unordered_map<ShaderNode*, std::pair<size_t, int>> nodeInfo(_nodeOrder.size());
+    using QueueEntry = std::pair<size_t, ShaderNode*>;
+    std::priority_queue<QueueEntry, vector<QueueEntry>, std::greater<QueueEntry>> nodeQueue;
+    for (size_t i = 0; i < _nodeOrder.size(); i++)
     {
-        ShaderNode* node = it.second.get();
+        ShaderNode* node = _nodeOrder[i];
 
         int connectionCount = 0;
         for (const ShaderInput* input : node->getInputs())
@@ -943,23 +1520,23 @@ void ShaderGraph::topologicalSort()
             }
         }
 
-        inDegree[node] = connectionCount;
+        nodeInfo[node] = std::make_pair(i, connectionCount);
 
         if (connectionCount == 0)
         {
-            nodeQueue.push_back(node);
+            nodeQueue.push(QueueEntry(i, node));
         }
     }
 
-    _nodeOrder.resize(_nodeMap.size(), nullptr);
-    size_t count = 0;
+    vector<ShaderNode*> nodeOrder;
+    nodeOrder.reserve(_nodeOrder.size());
 
     while (!nodeQueue.empty())
     {
         // Pop the queue and add to topological order.
-        ShaderNode* node = nodeQueue.front();
-        nodeQueue.pop_front();
-        _nodeOrder[count++] = node;
+        ShaderNode* node = nodeQueue.top().second;
+        nodeQueue.pop();
+        nodeOrder.push_back(node);
 
         // Find connected nodes and decrease their in-degree,
         // adding node to the queue if in-degrees becomes 0.
@@ -969,9 +1546,10 @@ void ShaderGraph::topologicalSort()
             {
                 if (input->getNode() != this)
                 {
-                    if (--inDegree[input->getNode()] <= 0)
+                    std::pair<size_t, int>& info = nodeInfo[input->getNode()];
+                    if (--info.second == 0)
                     {
-                        nodeQueue.push_back(input->getNode());
+                        nodeQueue.push(QueueEntry(info.first, input->getNode()));
                     }
                 }
             }
@@ -979,10 +1557,12 @@ void ShaderGraph::topologicalSort()
     }
 
     // Check if there was a cycle.
-    if (count != _nodeMap.size())
+    if (nodeOrder.size() != _nodeMap.size())
     {
         throw ExceptionFoundCycle("Encountered a cycle in graph: " + getName());
     }
+
+    _nodeOrder = nodeOrder;
 }
 
 void ShaderGraph::calculateScopes()
@@ -1112,6 +1692,36 @@ void ShaderGraph::populateInputColorTransformMap(ColorManagementSystemPtr colorM
     }
 }
 
+//
+// ShaderGraphRegistry methods
+//
+
+ShaderGraphPtr ShaderGraphRegistry::find(const string& key) const
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    auto it = _graphs.find(key);
+    return it != _graphs.end() ? it->second : nullptr;
+}
+
+ShaderGraphPtr ShaderGraphRegistry::add(const string& key, ShaderGraphPtr graph)
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    auto it = _graphs.emplace(key, graph).first;
+    return it->second;
+}
+
+void ShaderGraphRegistry::clear()
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    _graphs.clear();
+}
+
+size_t ShaderGraphRegistry::size() const
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    return _graphs.size();
+}
+
 namespace
 {
     static const ShaderGraphEdgeIterator NULL_EDGE_ITERATOR(nullptr);
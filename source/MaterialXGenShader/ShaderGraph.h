@@ -18,6 +18,9 @@
 #include <MaterialXCore/Document.h>
 #include <MaterialXCore/Node.h>
 
+#include <mutex>
+#include <unordered_map>
+
 namespace MaterialX
 {
 
@@ -69,6 +72,10 @@ class ShaderGraph : public ShaderNode
     /// Get a vector of all nodes in order
     const vector<ShaderNode*>& getNodes() const { return _nodeOrder; }
 
+    /// Return an estimate of the number of bytes held by this graph,
+    /// including its nodes and their inputs and outputs.
+    size_t getMemoryBytes() const override;
+
     /// Get number of input sockets
     size_t numInputSockets() const { return numOutputs(); }
 
@@ -128,6 +135,27 @@ class ShaderGraph : public ShaderNode
     /// Optimize the graph, removing redundant paths.
     void optimize(GenContext& context);
 
+    /// Bypass a conditional node whose selector is a literal value,
+    /// using the branch it selects.  Returns true if the node was bypassed.
+    bool bypassConditional(GenContext& context, ShaderNode* node);
+
+    /// Evaluate standard library math and channel nodes whose inputs are
+    /// all unpublished literal values, assigning their results to the
+    /// downstream inputs.  Returns the number of nodes folded.
+    size_t foldConstants(GenContext& context);
+
+    /// Merge nodes that use the same implementation with identical
+    /// outputs, input values, connections and channels, rerouting the
+    /// downstream connections of each duplicate to the first such node.
+    /// Returns the number of nodes merged.
+    size_t eliminateCommonSubexpressions(GenContext& context);
+
+    /// Assign the values of input sockets to the inputs connected to them,
+    /// removing the connections, so that no uniforms are published for the
+    /// sockets.  Sockets kept dynamic by the specialization options of the
+    /// context are left unchanged.  Returns the number of sockets specialized.
+    size_t specializeInputSockets(GenContext& context);
+
     /// Bypass a node for a particular input and output,
     /// effectively connecting the input's upstream connection
     /// with the output's downstream connections.
@@ -163,6 +191,56 @@ class ShaderGraph : public ShaderNode
     std::unordered_map<ShaderOutput*, ColorSpaceTransform> _outputColorTransformMap;
 };
 
+/// @class ShaderGraphRegistry
+/// A thread-safe registry of the finalized graphs of compound node
+/// implementations, which may be shared by any number of implementations
+/// and generation contexts.
+///
+/// Each shader generator owns a registry, returned by
+/// ShaderGenerator::getGraphRegistry, and contexts attach to a registry with
+/// GenContext::setGraphRegistry.  Graphs are keyed by the implementation key
+/// of their node graph and a hash of the content of the node graph, of the
+/// nodedefs and implementations that it depends upon, and of the source
+/// files of those implementations, so that node graphs of the same name
+/// with different content are built separately.  Registered graphs are
+/// shared, and must be treated as read-only.
+///
+/// Graphs are held until the registry is cleared, along with the node
+/// implementations and documents that they reference, so a registry should
+/// be cleared when its libraries are reloaded, for example through
+/// GenContext::clearSharedImplementations.
+class ShaderGraphRegistry
+{
+  public:
+    /// Create a new, empty registry.
+    static ShaderGraphRegistryPtr create()
+    {
+        return ShaderGraphRegistryPtr(new ShaderGraphRegistry());
+    }
+
+    /// Return the graph registered with the given key, or nullptr if no
+    /// such graph is registered.
+    ShaderGraphPtr find(const string& key) const;
+
+    /// Register a finalized graph with the given key.  If a graph was
+    /// registered with the key by another thread in the meantime, that
+    /// graph is kept and returned instead.
+    ShaderGraphPtr add(const string& key, ShaderGraphPtr graph);
+
+    /// Remove all graphs from the registry.
+    void clear();
+
+    /// Return the number of registered graphs.
+    size_t size() const;
+
+  protected:
+    ShaderGraphRegistry() { }
+
+  private:
+    mutable std::mutex _mutex;
+    std::unordered_map<string, ShaderGraphPtr> _graphs;
+};
+
 /// @class ShaderGraphEdge
 /// An edge returned during shader graph traversal.
 class ShaderGraphEdge
@@ -14,6 +14,21 @@
 namespace MaterialX
 {
 
+namespace {
+
+// Return the number of bytes held by the reference count and strings of the
+// given port.  Port names are also held as keys in the port maps of nodes.
+size_t getPortBytes(const ShaderPort& port)
+{
+    return 3 * sizeof(void*) +
+           2 * getHeapBytes(port.getName()) +
+           getHeapBytes(port.getPath()) +
+           getHeapBytes(port.getSemantic()) +
+           getHeapBytes(port.getVariable());
+}
+
+} // anonymous namespace
+
 //
 // ShaderPort methods
 //
@@ -118,6 +133,7 @@ const string ShaderNode::TEXTURE3D_GROUPNAME = "texture3d";
 const string ShaderNode::PROCEDURAL2D_GROUPNAME = "procedural2d";
 const string ShaderNode::PROCEDURAL3D_GROUPNAME = "procedural3d";
 const string ShaderNode::CONVOLUTION2D_GROUPNAME = "convolution2d";
+const string ShaderNode::STDLIB_DEFS_FILENAME = "stdlib_defs.mtlx";
 
 //
 // ShaderNode methods
@@ -126,6 +142,7 @@ const string ShaderNode::CONVOLUTION2D_GROUPNAME = "convolution2d";
 ShaderNode::ShaderNode(const ShaderGraph* parent, const string& name) :
     _parent(parent),
     _name(name),
+    _standardNodeDef(false),
     _classification(0),
     _impl(nullptr)
 {
@@ -197,6 +214,11 @@ void ShaderNode::ScopeInfo::merge(const ScopeInfo &fromScope)
 ShaderNodePtr ShaderNode::create(const ShaderGraph* parent, const string& name, const NodeDef& nodeDef, GenContext& context)
 {
     ShaderNodePtr newNode = std::make_shared<ShaderNode>(parent, name);
+    newNode->_category = nodeDef.getNodeString();
+
+    // Nodedefs of the standard library are identified by the document they
+    // were read from.
+    newNode->_standardNodeDef = FilePath(nodeDef.getActiveSourceUri()).getBaseName() == STDLIB_DEFS_FILENAME;
 
     const ShaderGenerator& shadergen = context.getShaderGenerator();
 
@@ -458,6 +480,23 @@ ShaderInput* ShaderNode::addInput(const string& name, const TypeDesc* type)
     return input.get();
 }
 
+size_t ShaderNode::getMemoryBytes() const
+{
+    size_t bytes = sizeof(ShaderNode) + getHeapBytes(_name) + getHeapBytes(_category) +
+                   getHashedHeapBytes(_inputMap) + getHeapBytes(_inputOrder) +
+                   getHashedHeapBytes(_outputMap) + getHeapBytes(_outputOrder) +
+                   getOrderedHeapBytes(_usedClosures);
+    for (const ShaderInput* input : _inputOrder)
+    {
+        bytes += sizeof(ShaderInput) + getPortBytes(*input) + getHeapBytes(input->getChannels());
+    }
+    for (const ShaderOutput* output : _outputOrder)
+    {
+        bytes += sizeof(ShaderOutput) + getPortBytes(*output) + getOrderedHeapBytes(output->getConnections());
+    }
+    return bytes;
+}
+
 ShaderOutput* ShaderNode::addOutput(const string& name, const TypeDesc* type)
 {
     if (getOutput(name))
@@ -268,6 +268,7 @@ class ShaderNode
     static const string PROCEDURAL2D_GROUPNAME;
     static const string PROCEDURAL3D_GROUPNAME;
     static const string CONVOLUTION2D_GROUPNAME;
+    static const string STDLIB_DEFS_FILENAME;
 
   public:
     /// Constructor.
@@ -304,6 +305,20 @@ class ShaderNode
         return _name;
     }
 
+    /// Return the category of the nodedef this node was created from,
+    /// or an empty string if the node was not created from a nodedef.
+    const string& getCategory() const
+    {
+        return _category;
+    }
+
+    /// Return true if this node was created from a nodedef of the standard
+    /// library, whose semantics are known to graph optimizations.
+    bool hasStandardNodeDef() const
+    {
+        return _standardNodeDef;
+    }
+
     /// Return the implementation used for this node.
     const ShaderNodeImpl& getImplementation() const
     {
@@ -377,9 +392,15 @@ class ShaderNode
         return (!_impl || _impl->isEditable(input));
     }
 
+    /// Return an estimate of the number of bytes held by this node,
+    /// including its inputs and outputs.
+    virtual size_t getMemoryBytes() const;
+
   protected:
     const ShaderGraph* _parent;
     string _name;
+    string _category;
+    bool _standardNodeDef;
     unsigned int _classification;
 
     std::unordered_map<string, ShaderInputPtr> _inputMap;
@@ -51,4 +51,39 @@ ShaderGraph* ShaderNodeImpl::getGraph() const
     return nullptr;
 }
 
+size_t ShaderNodeImpl::getMemoryBytes() const
+{
+    return sizeof(ShaderNodeImpl) + getHeapBytes(_name);
+}
+
+//
+// ShaderNodeImplRegistry methods
+//
+
+ShaderNodeImplPtr ShaderNodeImplRegistry::find(const string& key) const
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    auto it = _impls.find(key);
+    return it != _impls.end() ? it->second : nullptr;
+}
+
+ShaderNodeImplPtr ShaderNodeImplRegistry::add(const string& key, ShaderNodeImplPtr impl)
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    auto it = _impls.emplace(key, impl).first;
+    return it->second;
+}
+
+void ShaderNodeImplRegistry::clear()
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    _impls.clear();
+}
+
+size_t ShaderNodeImplRegistry::size() const
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    return _impls.size();
+}
+
 } // namespace MaterialX
@@ -13,6 +13,9 @@
 
 #include <MaterialXCore/Util.h>
 
+#include <mutex>
+#include <unordered_map>
+
 namespace MaterialX
 {
 
@@ -22,6 +25,9 @@ using ShaderGraphInputSocket = ShaderOutput;
 /// Shared pointer to a ShaderNodeImpl
 using ShaderNodeImplPtr = shared_ptr<class ShaderNodeImpl>;
 
+/// Shared pointer to a ShaderNodeImplRegistry
+using ShaderNodeImplRegistryPtr = shared_ptr<class ShaderNodeImplRegistry>;
+
 /// @class ShaderNodeImpl
 /// Class handling the shader generation implementation for a node.
 /// Responsible for emitting the function definition and function call 
@@ -77,6 +83,10 @@ class ShaderNodeImpl
     /// or returns nullptr otherwise.
     virtual ShaderGraph* getGraph() const;
 
+    /// Return an estimate of the number of bytes held by this implementation,
+    /// including any graph that it owns.
+    virtual size_t getMemoryBytes() const;
+
     /// Returns true if an input is editable by users.
     /// Editable inputs are allowed to be published as shader uniforms
     /// and hence must be presentable in a user interface.
@@ -104,6 +114,50 @@ class ShaderNodeImpl
     size_t _hash;
 };
 
+/// @class ShaderNodeImplRegistry
+/// A thread-safe registry of initialized shader node implementations,
+/// which may be shared by any number of generation contexts.
+///
+/// Each shader generator owns a registry, returned by
+/// ShaderGenerator::getImplementationRegistry, and contexts attach to a
+/// registry with GenContext::setImplementationRegistry.  Implementations
+/// are keyed by their name, target and language, and by the state of the
+/// context that affects their initialization, as returned by
+/// ShaderGenerator::getImplementationKey.  Contexts sharing a registry must
+/// generate from documents whose implementation elements of the same name
+/// are identical, as is the case for documents using the same libraries.
+class ShaderNodeImplRegistry
+{
+  public:
+    /// Create a new, empty registry.
+    static ShaderNodeImplRegistryPtr create()
+    {
+        return ShaderNodeImplRegistryPtr(new ShaderNodeImplRegistry());
+    }
+
+    /// Return the implementation registered with the given key, or nullptr
+    /// if no such implementation is registered.
+    ShaderNodeImplPtr find(const string& key) const;
+
+    /// Register an initialized implementation with the given key.  If an
+    /// implementation was registered with the key by another thread in the
+    /// meantime, that implementation is kept and returned instead.
+    ShaderNodeImplPtr add(const string& key, ShaderNodeImplPtr impl);
+
+    /// Remove all implementations from the registry.
+    void clear();
+
+    /// Return the number of registered implementations.
+    size_t size() const;
+
+  protected:
+    ShaderNodeImplRegistry() { }
+
+  private:
+    mutable std::mutex _mutex;
+    std::unordered_map<string, ShaderNodeImplPtr> _impls;
+};
+
 } // namespace MaterialX
 
 #endif
@@ -6,6 +6,7 @@
 #include <MaterialXGenShader/ShaderStage.h>
 
 #include <MaterialXGenShader/GenContext.h>
+#include <MaterialXGenShader/SourceFileCache.h>
 #include <MaterialXGenShader/Syntax.h>
 #include <MaterialXGenShader/Util.h>
 
@@ -321,13 +322,39 @@ void ShaderStage::addInclude(const string& file, GenContext& context)
 
     if (!_includes.count(path))
     {
-        string content;
-        if (!readFile(path, content))
+        SourceFilePtr source = SourceFileCache::getInstance().getFile(path);
+        if (!source)
         {
             throw ExceptionShaderGenError("Could not find include file: '" + file + "'");
         }
         _includes.insert(path);
-        addBlock(content, context);
+        addSourceFile(*source, context);
+    }
+}
+
+void ShaderStage::addSourceFile(const SourceFile& file, GenContext& context)
+{
+    // Include directives are located in advance for the default syntax only.
+    if (_syntax->getIncludeStatement() != SourceFile::INCLUDE_STATEMENT ||
+        _syntax->getStringQuote() != SourceFile::STRING_QUOTE)
+    {
+        addBlock(file.getContents(), context);
+        return;
+    }
+
+    for (const SourceFile::Line& line : file.getLines())
+    {
+        if (line.isInclude)
+        {
+            if (!line.includeFile.empty())
+            {
+                addInclude(line.includeFile, context);
+            }
+        }
+        else
+        {
+            addLine(line.text, false);
+        }
     }
 }
 
@@ -44,6 +44,7 @@ namespace Stage
     extern const string PIXEL;
 }
 
+class SourceFile;
 class VariableBlock;
 /// Shared pointer to a VariableBlock
 using VariableBlockPtr = std::shared_ptr<VariableBlock>;
@@ -214,6 +215,9 @@ class ShaderStage
     /// only included once for the shader stage.
     void addInclude(const string& file, GenContext& context);
 
+    /// Add the contents of a source file as a block of code.
+    void addSourceFile(const SourceFile& file, GenContext& context);
+
     /// Add a value.
     template<typename T>
     void addValue(const T& value)
@@ -261,6 +265,7 @@ class ShaderStage
     string _code;
 
     friend class ShaderGenerator;
+    friend class DirectoryShaderCacheBackend;
 };
 
 /// Shared pointer to a ShaderStage
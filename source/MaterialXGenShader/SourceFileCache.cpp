@@ -0,0 +1,187 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXGenShader/SourceFileCache.h>
+
+#include <MaterialXGenShader/Util.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#endif
+
+namespace MaterialX
+{
+
+const string SourceFile::INCLUDE_STATEMENT = "#include";
+const string SourceFile::STRING_QUOTE = "\"";
+
+namespace {
+
+// Return the modification time of the given file at the finest resolution
+// the platform provides, along with its size, or false if the file does not
+// exist.  Sub-second resolution allows edits made within the same second
+// as the previous read to be detected.
+bool getFileStatus(const string& filename, long long& modificationTime, long long& size)
+{
+#if defined(_WIN32)
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesExA(filename.c_str(), GetFileExInfoStandard, &data))
+        return false;
+    modificationTime = ((long long) data.ftLastWriteTime.dwHighDateTime << 32) |
+                       (long long) data.ftLastWriteTime.dwLowDateTime;
+    size = ((long long) data.nFileSizeHigh << 32) | (long long) data.nFileSizeLow;
+#else
+    struct stat sb;
+    if (stat(filename.c_str(), &sb))
+        return false;
+#if defined(__APPLE__)
+    const struct timespec& mtime = sb.st_mtimespec;
+#else
+    const struct timespec& mtime = sb.st_mtim;
+#endif
+    modificationTime = (long long) mtime.tv_sec * 1000000000LL + (long long) mtime.tv_nsec;
+    size = (long long) sb.st_size;
+#endif
+    return true;
+}
+
+} // anonymous namespace
+
+//
+// SourceFile methods
+//
+
+SourceFile::SourceFile(const FilePath& path, const string& contents) :
+    _path(path),
+    _contents(contents),
+    _contentHash(0)
+{
+    StableHasher hasher;
+    hasher.add(_contents);
+    _contentHash = hasher.getValue();
+
+    // Split the contents at newlines, matching the behavior of std::getline,
+    // and locate include directives as ShaderStage::addBlock does.
+    size_t begin = 0;
+    while (begin < _contents.size())
+    {
+        size_t end = _contents.find('\n', begin);
+        if (end == string::npos)
+        {
+            end = _contents.size();
+        }
+
+        Line line;
+        line.text = _contents.substr(begin, end - begin);
+        line.isInclude = line.text.find(INCLUDE_STATEMENT) != string::npos;
+        if (line.isInclude)
+        {
+            size_t startQuote = line.text.find_first_of(STRING_QUOTE);
+            size_t endQuote = line.text.find_last_of(STRING_QUOTE);
+            if (startQuote != string::npos && endQuote != string::npos && endQuote > startQuote + 1)
+            {
+                line.includeFile = line.text.substr(startQuote + 1, endQuote - startQuote - 1);
+            }
+        }
+        _lines.push_back(std::move(line));
+
+        begin = end + 1;
+    }
+}
+
+StringVec SourceFile::getIncludes() const
+{
+    StringVec includes;
+    for (const Line& line : _lines)
+    {
+        if (!line.includeFile.empty())
+        {
+            includes.push_back(line.includeFile);
+        }
+    }
+    return includes;
+}
+
+//
+// SourceFileCache methods
+//
+
+SourceFileCache::SourceFileCache() :
+    _lookupCount(0),
+    _readCount(0)
+{
+}
+
+SourceFileCache& SourceFileCache::getInstance()
+{
+    static SourceFileCache cache;
+    return cache;
+}
+
+SourceFilePtr SourceFileCache::getFile(const FilePath& path)
+{
+    const string filename = path.asString();
+    long long modificationTime = 0;
+    long long size = 0;
+    bool exists = getFileStatus(filename, modificationTime, size);
+
+    {
+        std::lock_guard<std::mutex> guard(_mutex);
+        _lookupCount++;
+        auto it = _entries.find(filename);
+        if (it != _entries.end())
+        {
+            if (exists && it->second.modificationTime == modificationTime && it->second.size == size)
+            {
+                return it->second.file;
+            }
+            _entries.erase(it);
+        }
+    }
+    if (!exists)
+    {
+        return nullptr;
+    }
+
+    // Read the file outside of the lock, so that lookups of other files are
+    // not blocked by disk access.
+    string contents;
+    if (!readFile(filename, contents))
+    {
+        return nullptr;
+    }
+    SourceFilePtr file = SourceFile::create(path, contents);
+
+    std::lock_guard<std::mutex> guard(_mutex);
+    _readCount++;
+    Entry& entry = _entries[filename];
+    entry.file = file;
+    entry.modificationTime = modificationTime;
+    entry.size = size;
+    return file;
+}
+
+void SourceFileCache::clear()
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    _entries.clear();
+}
+
+size_t SourceFileCache::getLookupCount() const
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    return _lookupCount;
+}
+
+size_t SourceFileCache::getReadCount() const
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    return _readCount;
+}
+
+} // namespace MaterialX
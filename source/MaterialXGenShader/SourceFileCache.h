@@ -0,0 +1,144 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#ifndef MATERIALX_SOURCEFILECACHE_H
+#define MATERIALX_SOURCEFILECACHE_H
+
+/// @file
+/// Process-wide caching of shader source files
+
+#include <MaterialXGenShader/Library.h>
+
+#include <MaterialXFormat/File.h>
+
+#include <mutex>
+#include <unordered_map>
+
+namespace MaterialX
+{
+
+/// A shared pointer to a SourceFile
+using SourceFilePtr = shared_ptr<class SourceFile>;
+
+/// @class SourceFile
+/// The contents of a shader source file, split into lines, with include
+/// directives located in advance.  Source files are immutable once loaded,
+/// and may be shared between threads.
+class SourceFile
+{
+  public:
+    /// A single line of a source file.
+    struct Line
+    {
+        /// The text of the line, excluding its line ending.
+        string text;
+
+        /// True if the line is an include directive.
+        bool isInclude;
+
+        /// The filename of an include directive, which is empty if the
+        /// directive has no quoted filename.
+        string includeFile;
+    };
+
+  public:
+    /// Create a source file from the given contents.
+    static SourceFilePtr create(const FilePath& path, const string& contents)
+    {
+        return SourceFilePtr(new SourceFile(path, contents));
+    }
+
+    /// Return the path from which the file was read.
+    const FilePath& getPath() const
+    {
+        return _path;
+    }
+
+    /// Return the full contents of the file.
+    const string& getContents() const
+    {
+        return _contents;
+    }
+
+    /// Return the lines of the file.
+    const vector<Line>& getLines() const
+    {
+        return _lines;
+    }
+
+    /// Return a stable hash of the contents of the file.
+    unsigned long long getContentHash() const
+    {
+        return _contentHash;
+    }
+
+    /// Return the filenames of the include directives of the file, in the
+    /// order in which they appear.
+    StringVec getIncludes() const;
+
+    /// The include statement used to locate include directives, matching
+    /// the default of Syntax.
+    static const string INCLUDE_STATEMENT;
+
+    /// The string quote used to locate the filenames of include directives,
+    /// matching the default of Syntax.
+    static const string STRING_QUOTE;
+
+  protected:
+    SourceFile(const FilePath& path, const string& contents);
+
+  private:
+    FilePath _path;
+    string _contents;
+    vector<Line> _lines;
+    unsigned long long _contentHash;
+};
+
+/// @class SourceFileCache
+/// A thread-safe cache of shader source files, shared by all shader
+/// generators and generation contexts in a process.
+///
+/// Each file is read from disk once, and is read again only when its
+/// modification time or size changes.
+class SourceFileCache
+{
+  public:
+    /// Return the source file cache of the process.
+    static SourceFileCache& getInstance();
+
+    /// Return the source file at the given path, reading it from disk if it
+    /// is not cached or has changed since it was cached.  Returns nullptr if
+    /// the file cannot be read or is empty.
+    SourceFilePtr getFile(const FilePath& path);
+
+    /// Remove all files from the cache.
+    void clear();
+
+    /// Return the number of calls to getFile since the cache was created.
+    size_t getLookupCount() const;
+
+    /// Return the number of files read from disk since the cache was created.
+    size_t getReadCount() const;
+
+  protected:
+    SourceFileCache();
+
+  private:
+    struct Entry
+    {
+        SourceFilePtr file;
+        long long modificationTime;
+        long long size;
+    };
+
+    mutable std::mutex _mutex;
+    std::unordered_map<string, Entry> _entries;
+    size_t _lookupCount;
+    size_t _readCount;
+};
+
+} // namespace MaterialX
+
+#endif
@@ -103,27 +103,28 @@ namespace
         size_t numCandidates = 0;
         size_t numOpaque = 0;
 
-        for (GraphIterator it = output->traverseGraph().begin(); it != GraphIterator::end(); ++it)
+        GraphWalker walker;
+        for (Element* upstreamElem = walker.begin(output.get()); upstreamElem; upstreamElem = walker.next())
         {
-            ElementPtr upstreamElem = it.getUpstreamElement();
-            if (!upstreamElem)
-            {            
-                it.setPruneSubgraph(true);
+            TypedElement* typedElem = dynamic_cast<TypedElement*>(upstreamElem);
+            if (!typedElem)
+            {
+                walker.setPruneSubgraph(true);
                 continue;
             }
 
-            const string& typeName = upstreamElem->asA<TypedElement>()->getType();
+            const string& typeName = typedElem->getType();
             const TypeDesc* type = TypeDesc::get(typeName);
             bool isFourChannelOutput = type == Type::COLOR4 || type == Type::VECTOR4;
             if (type != Type::SURFACESHADER && type != Type::BSDF && !isFourChannelOutput)
             {
-                it.setPruneSubgraph(true);
+                walker.setPruneSubgraph(true);
                 continue;
             }
 
-            if (upstreamElem->isA<Node>())
+            Node* node = dynamic_cast<Node*>(upstreamElem);
+            if (node)
             {
-                NodePtr node = upstreamElem->asA<Node>();
 
                 const string& nodetype = node->getCategory();
                 if (nodetype == "surface")
@@ -579,4 +580,87 @@ ValueElementPtr findNodeDefChild(const string& path, DocumentPtr doc, const stri
     return valueElement;
 }
 
+//
+// StableHasher methods
+//
+
+namespace {
+
+unsigned long long rotateLeft(unsigned long long value, int bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+// Assemble up to eight bytes into a word in little-endian order.
+unsigned long long getWord(const unsigned char* data, size_t size)
+{
+    unsigned long long word = 0;
+    for (size_t i = 0; i < size; i++)
+    {
+        word |= (unsigned long long) data[i] << (i * 8);
+    }
+    return word;
+}
+
+} // anonymous namespace
+
+StableHasher::StableHasher() :
+    _hash(0x9e3779b97f4a7c15ULL)
+{
+}
+
+void StableHasher::add(const string& str)
+{
+    addInteger(str.size());
+    const unsigned char* data = (const unsigned char*) str.data();
+    size_t size = str.size();
+    for (; size >= 8; size -= 8, data += 8)
+    {
+        addWord(getWord(data, 8));
+    }
+    if (size)
+    {
+        addWord(getWord(data, size));
+    }
+}
+
+void StableHasher::addInteger(unsigned long long value)
+{
+    addWord(value);
+}
+
+unsigned long long StableHasher::getValue() const
+{
+    // Apply the final avalanche of MurmurHash3.
+    unsigned long long hash = _hash;
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+string StableHasher::getKey() const
+{
+    static const char* HEX_DIGITS = "0123456789abcdef";
+    unsigned long long hash = getValue();
+    string key(16, '0');
+    for (size_t i = 0; i < 16; i++)
+    {
+        key[15 - i] = HEX_DIGITS[(hash >> (i * 4)) & 0xf];
+    }
+    return key;
+}
+
+void StableHasher::addWord(unsigned long long word)
+{
+    // Combine the word using the mixing steps of 64-bit MurmurHash3.
+    word *= 0x87c37b91114253d5ULL;
+    word = rotateLeft(word, 31);
+    word *= 0x4cf5ad432745937fULL;
+    _hash ^= word;
+    _hash = rotateLeft(_hash, 27) * 5 + 0x52dce729;
+}
+
 } // namespace MaterialX
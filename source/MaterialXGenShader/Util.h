@@ -68,6 +68,34 @@ bool elementRequiresShading(const TypedElementPtr element);
 void findRenderableElements(const DocumentPtr& doc, std::vector<TypedElementPtr>& elements, 
                             bool includeReferencedGraphs = false);
 
+/// @class StableHasher
+/// A stable 64-bit hash of a sequence of strings and integers, whose values
+/// are independent of the process and platform.
+class StableHasher
+{
+  public:
+    StableHasher();
+
+    /// Add a string to the hash.
+    void add(const string& str);
+
+    /// Add an integer to the hash.
+    void addInteger(unsigned long long value);
+
+    /// Return the hash of the input added so far.
+    unsigned long long getValue() const;
+
+    /// Return the hash of the input added so far, as a string of
+    /// sixteen hexadecimal digits.
+    string getKey() const;
+
+  private:
+    void addWord(unsigned long long word);
+
+  private:
+    unsigned long long _hash;
+};
+
 /// Given a path to a element, find the corresponding element with the same name
 /// on an associated nodedef if it exists. A target string should be provided
 /// if the path is to a Node as definitions for Nodes can be target specific.
@@ -6,6 +6,8 @@
 #include <MaterialXGenShader/Util.h>
 #include <MaterialXRender/GeometryHandler.h>
 
+#include <limits>
+
 namespace MaterialX
 {
 void GeometryHandler::addLoader(GeometryLoaderPtr loader)
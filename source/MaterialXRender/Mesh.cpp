@@ -5,6 +5,8 @@
 
 #include <MaterialXRender/Mesh.h>
 
+#include <algorithm>
+#include <limits>
 #include <map>
 
 namespace MaterialX
@@ -214,37 +216,13 @@ void MeshStream::transform(const Matrix44 &matrix)
        getType() == MeshStream::TEXCOORD_ATTRIBUTE ||
        getType() == MeshStream::GEOMETRY_PROPERTY_ATTRIBUTE)
     {
-        for (size_t i=0; i<numElements; i++)
-        {
-            Vector4 vec(0.0, 0.0, 0.0, 1.0);
-            for(size_t j=0; j<stride; j++)
-            {
-                vec[j] = _data[i*stride + j];
-            }
-            vec = matrix.multiply(vec);
-            for(size_t k=0; k<stride; k++)
-            {
-                _data[i*stride + k] = vec[k];
-            }
-        }
+        matrix.transformPoints(_data.data(), numElements, std::min(stride, 4u), stride);
     }
     else if(getType() == MeshStream::NORMAL_ATTRIBUTE ||
             getType() == MeshStream::TANGENT_ATTRIBUTE ||
             getType() == MeshStream::BITANGENT_ATTRIBUTE)
     {
-        for (size_t i=0; i<numElements; i++)
-        {
-            Vector3 vec(0.0, 0.0, 0.0);
-            for(size_t j=0; j<stride; j++)
-            {
-                vec[j] = _data[i*stride + j];
-            }
-            vec = matrix.transformNormal(vec);
-            for(size_t k=0; k<stride; k++)
-            {
-                _data[i*stride + k] = vec[k];
-            }
-        }
+        matrix.transformNormals(_data.data(), numElements, std::min(stride, 3u), stride);
     }
 }
 
@@ -0,0 +1,142 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+// Standalone allocation benchmark for document loading.  This executable
+// replaces the global allocation operators to count heap allocations, so it
+// is built separately from MaterialXTest rather than as a test case.
+
+#include <MaterialXFormat/File.h>
+#include <MaterialXFormat/XmlIo.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+namespace mx = MaterialX;
+
+namespace {
+
+// The number of heap allocations made through the global allocation operators.
+std::atomic<size_t> allocationCount(0);
+
+void* countedAlloc(std::size_t size)
+{
+    allocationCount++;
+    void* ptr = std::malloc(size ? size : 1);
+    if (!ptr)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+} // anonymous namespace
+
+void* operator new(std::size_t size)
+{
+    return countedAlloc(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return countedAlloc(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    try
+    {
+        return countedAlloc(size);
+    }
+    catch (std::bad_alloc&)
+    {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    try
+    {
+        return countedAlloc(size);
+    }
+    catch (std::bad_alloc&)
+    {
+        return nullptr;
+    }
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+int main(int argc, char* argv[])
+{
+    const int ITERATIONS = 10;
+    mx::FilePath libraryPath(argc > 1 ? argv[1] : "libraries/stdlib");
+    mx::StringVec filenames =
+    {
+        "stdlib_defs.mtlx",
+        "stdlib_ng.mtlx",
+        "genglsl/stdlib_genglsl_impl.mtlx",
+        "genglsl/stdlib_genglsl_cm_impl.mtlx",
+        "genosl/stdlib_genosl_impl.mtlx",
+        "genosl/stdlib_genosl_cm_impl.mtlx"
+    };
+
+    // Read the standard library, counting heap allocations.
+    size_t startCount = allocationCount;
+    auto startTime = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; i++)
+    {
+        for (const std::string& filename : filenames)
+        {
+            mx::DocumentPtr lib = mx::createDocument();
+            try
+            {
+                mx::readFromXmlFile(lib, filename, libraryPath);
+            }
+            catch (mx::Exception& e)
+            {
+                std::cerr << e.what() << std::endl;
+                return 1;
+            }
+        }
+    }
+    std::chrono::duration<double> duration = std::chrono::steady_clock::now() - startTime;
+    size_t loadCount = allocationCount - startCount;
+
+    std::cout << "Standard library load: " << loadCount / ITERATIONS << " allocations, " <<
+                 duration.count() * 1000.0 / ITERATIONS << " ms" << std::endl;
+    return 0;
+}
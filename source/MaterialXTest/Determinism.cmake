@@ -0,0 +1,31 @@
+# Generates the test suite shaders in two separate processes, and checks
+# that the generated code is identical.  The second process generates the
+# shaders in reverse order, so that its memory layout differs from the first.
+#
+# Usage: cmake -DMATERIALX_TEST=<path to MaterialXTest> -P Determinism.cmake
+
+foreach(run 1 2)
+    set(outputPath "${CMAKE_CURRENT_BINARY_DIR}/determinism/run${run}")
+    file(REMOVE_RECURSE "${outputPath}")
+    file(MAKE_DIRECTORY "${outputPath}")
+    set(ENV{MATERIALX_GENERATED_SHADER_PATH} "${outputPath}")
+    if(run EQUAL 2)
+        set(ENV{MATERIALX_GENERATED_SHADER_REVERSE} 1)
+    endif()
+    execute_process(COMMAND "${MATERIALX_TEST}" "GenShader: Write Test Suite Shaders"
+                    RESULT_VARIABLE result
+                    OUTPUT_QUIET)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "Shader generation failed in run ${run}")
+    endif()
+endforeach()
+
+foreach(language genglsl genosl)
+    execute_process(COMMAND ${CMAKE_COMMAND} -E compare_files
+                    "${CMAKE_CURRENT_BINARY_DIR}/determinism/run1/${language}.txt"
+                    "${CMAKE_CURRENT_BINARY_DIR}/determinism/run2/${language}.txt"
+                    RESULT_VARIABLE result)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "Generated ${language} shaders differ between processes")
+    endif()
+endforeach()
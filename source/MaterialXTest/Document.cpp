@@ -6,6 +6,13 @@
 #include <MaterialXTest/Catch/catch.hpp>
 
 #include <MaterialXCore/Document.h>
+#include <MaterialXCore/Transaction.h>
+
+#include <MaterialXFormat/XmlIo.h>
+
+#include <chrono>
+#include <iostream>
+#include <thread>
 
 namespace mx = MaterialX;
 
@@ -42,6 +49,24 @@ TEST_CASE("Document", "[document]")
     REQUIRE(nodeGraph->getDescendant("node1") == constant);
     REQUIRE(nodeGraph->getDescendant("missingNode") == mx::ElementPtr());
 
+    // Test getting elements through the name path index.
+    doc->setNamePathIndexEnabled(true);
+    REQUIRE(doc->getNamePathIndexEnabled());
+    REQUIRE(doc->getDescendant("nodegraph1/node1") == constant);
+    mx::NodePtr constant2 = nodeGraph->addNode("constant");
+    REQUIRE(doc->getDescendant("nodegraph1/node2") == constant2);
+    nodeGraph->setName("renamedGraph");
+    REQUIRE(constant2->getNamePath() == "renamedGraph/node2");
+    REQUIRE(doc->getDescendant("renamedGraph/node2") == constant2);
+    REQUIRE(doc->getDescendant("nodegraph1/node2") == mx::ElementPtr());
+    nodeGraph->removeNode(constant2->getName());
+    REQUIRE(doc->getDescendant("renamedGraph/node2") == mx::ElementPtr());
+    nodeGraph->setName("nodegraph1");
+    REQUIRE(doc->getDescendant("nodegraph1/node1") == constant);
+    REQUIRE(doc->getDescendant("nodegraph1//node1") == constant);
+    doc->setNamePathIndexEnabled(false);
+    REQUIRE(!doc->getNamePathIndexEnabled());
+
     // Create a simple shader interface.
     mx::NodeDefPtr shader = doc->addNodeDef("", "surfaceshader", "simpleSrf");
     mx::InputPtr diffColor = shader->addInput("diffColor", "color3");
@@ -105,6 +130,527 @@ TEST_CASE("Document", "[document]")
     REQUIRE(importedNode->getNodeDef() == importedNodeDef);
     REQUIRE(importedImpl->getNodeDef() == importedNodeDef);
 
+    // Test implementation lookups, which are memoized by the document.
+    mx::ImplementationPtr glslImpl = doc->addImplementation("IM_simpleSrf_genglsl");
+    glslImpl->setNodeDef(shader);
+    glslImpl->setLanguage("genglsl");
+    REQUIRE(shader->getImplementation("", "genglsl") == glslImpl);
+    REQUIRE(shader->getImplementation("", "genosl") == nullptr);
+    mx::ImplementationPtr oslImpl = doc->addImplementation("IM_simpleSrf_genosl");
+    oslImpl->setNodeDef(shader);
+    oslImpl->setLanguage("genosl");
+    REQUIRE(shader->getImplementation("", "genosl") == oslImpl);
+    oslImpl->setTarget("customTarget");
+    REQUIRE(shader->getImplementation("otherTarget", "genosl") == nullptr);
+    REQUIRE(shader->getImplementation("customTarget", "genosl") == oslImpl);
+    doc->removeImplementation(oslImpl->getName());
+    REQUIRE(shader->getImplementation("customTarget", "genosl") == nullptr);
+    REQUIRE(shader->getImplementation("", "genglsl") == glslImpl);
+
     // Validate the combined document.
     REQUIRE(doc->validate());
 }
+
+TEST_CASE("Document: Validation", "[document]")
+{
+    // Create a document with errors spread across several top-level elements.
+    mx::DocumentPtr doc = mx::createDocument();
+    std::vector<mx::OutputPtr> outputs;
+    for (int i = 0; i < 8; i++)
+    {
+        mx::NodeGraphPtr nodeGraph = doc->addNodeGraph();
+        mx::NodePtr constant = nodeGraph->addNode("constant");
+        constant->setParameterValue("value", mx::Color3(0.5f));
+        mx::OutputPtr output = nodeGraph->addOutput();
+        output->setConnectedNode(constant);
+        outputs.push_back(output);
+    }
+    outputs[1]->setType("float");
+    outputs[5]->setType("vector2");
+    doc->addNodeDef("", "", "untypedNode");
+
+    // Parallel validation must match serial validation exactly.
+    std::string serialMessage, parallelMessage;
+    REQUIRE(!doc->validate(&serialMessage));
+    for (unsigned int threadCount : { 1u, 2u, 4u, 0u })
+    {
+        parallelMessage.clear();
+        REQUIRE(!doc->validateParallel(&parallelMessage, threadCount));
+        REQUIRE(parallelMessage == serialMessage);
+    }
+
+    // Incremental validation must match full validation after each edit.
+    auto checkIncremental = [&doc]()
+    {
+        std::string fullMessage, incrementalMessage;
+        bool fullResult = doc->validate(&fullMessage);
+        bool incrementalResult = doc->validateIncremental(&incrementalMessage, 2);
+        REQUIRE(fullResult == incrementalResult);
+        REQUIRE(fullMessage == incrementalMessage);
+    };
+    checkIncremental();
+    checkIncremental();
+
+    // Value edits within a single top-level element.
+    mx::NodePtr constant = doc->getNodeGraph("nodegraph3")->getNode("node1");
+    constant->setParameterValue("value", mx::Color3(1.0f));
+    checkIncremental();
+    constant->getParameter("value")->setValueString("not a color");
+    checkIncremental();
+    constant->getParameter("value")->setValueString("0.1, 0.2, 0.3");
+    checkIncremental();
+
+    // Edits that affect connections and definitions.
+    outputs[1]->setType("color3");
+    checkIncremental();
+    outputs[5]->setType("color3");
+    checkIncremental();
+    doc->getNodeGraph("nodegraph2")->getNode("node1")->setName("renamed");
+    checkIncremental();
+    outputs[1]->setNodeName("renamed");
+    checkIncremental();
+    doc->removeNodeDef("untypedNode");
+    checkIncremental();
+    REQUIRE(doc->validateIncremental());
+
+    // Structural edits.
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph();
+    nodeGraph->addOutput("out", "float");
+    nodeGraph->getOutput("out")->setNodeName("missing");
+    checkIncremental();
+    doc->removeNodeGraph(nodeGraph->getName());
+    checkIncremental();
+    doc->setChildIndex("nodegraph1", 4);
+    checkIncremental();
+    REQUIRE(doc->validateIncremental());
+}
+
+// Create a document in the given legacy version, with the given number of
+// independent groups of upgradable elements.
+static mx::DocumentPtr createLegacyDocument(const std::string& version, size_t groupCount)
+{
+    int minorVersion = std::stoi(version.substr(version.find('.') + 1));
+    mx::DocumentPtr doc = mx::createDocument();
+    doc->setVersionString(version);
+    for (size_t i = 0; i < groupCount; i++)
+    {
+        std::string suffix = std::to_string(i);
+
+        // A graph with connected nodes.
+        mx::ElementPtr graph = doc->addChildOfCategory("opgraph", "graph" + suffix);
+        mx::ElementPtr constant = graph->addChildOfCategory("constant", "constant1");
+        constant->setAttribute("type", "color3");
+        mx::ElementPtr color = constant->addChildOfCategory("parameter", minorVersion <= 25 ? "color" : "value");
+        color->setAttribute("type", "color3");
+        color->setAttribute("value", "0.5, 0.5, 0.5");
+        mx::ElementPtr multiply = graph->addChildOfCategory("multiply", "multiply1");
+        multiply->setAttribute("type", "color3");
+        mx::ElementPtr in1 = multiply->addChildOfCategory("parameter", "in1");
+        in1->setAttribute("type", "opgraphnode");
+        in1->setAttribute("value", "constant1");
+        mx::ElementPtr in2 = multiply->addChildOfCategory("parameter", "in2");
+        in2->setAttribute("type", "matrix");
+        in2->setAttribute("default", "1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1");
+        mx::ElementPtr output = graph->addChildOfCategory("output", "out");
+        output->setAttribute("type", "color3");
+        mx::ElementPtr in = output->addChildOfCategory("parameter", "in");
+        in->setAttribute("type", "opgraphnode");
+        in->setAttribute("value", "multiply1");
+
+        // Connected nodes at the document scope.
+        mx::ElementPtr vector = doc->addChildOfCategory("constant", "vector" + suffix);
+        vector->setAttribute("type", "vector");
+        mx::ElementPtr vectorValue = vector->addChildOfCategory("parameter", minorVersion <= 25 ? "color" : "value");
+        vectorValue->setAttribute("type", "vector");
+        vectorValue->setAttribute("value", "0, 0, 1");
+        mx::ElementPtr normalize = doc->addChildOfCategory("normalize", "normalize" + suffix);
+        normalize->setAttribute("type", "vector");
+        mx::ElementPtr normalizeIn = normalize->addChildOfCategory("parameter", "in");
+        normalizeIn->setAttribute("type", "opgraphnode");
+        normalizeIn->setAttribute("value", "vector" + suffix);
+
+        // A shader with public and connected inputs.
+        mx::ElementPtr shader = doc->addChildOfCategory("shader", "shader" + suffix);
+        shader->setAttribute("shadertype", "surface");
+        shader->setAttribute("shaderprogram", "program" + suffix);
+        if (minorVersion <= 23)
+        {
+            shader->setAttribute("shadername", "program" + suffix);
+        }
+        mx::ElementPtr geom = shader->addChildOfCategory("parameter", "geom");
+        geom->setAttribute("type", "geomname");
+        geom->setAttribute("publicname", "public_geom");
+        mx::ElementPtr texture = shader->addChildOfCategory("parameter", "texture");
+        texture->setAttribute("type", "filename");
+        texture->setAttribute("value", "texture" + suffix + ".%UDIM.tif");
+        mx::ElementPtr base = shader->addChildOfCategory("input", "base");
+        base->setAttribute("type", "vector3");
+        base->setAttribute(minorVersion <= 24 ? "graphname" : "opgraph", "graph" + suffix);
+        base->setAttribute("graphoutput", "out");
+
+        // A material with overrides and inheritance.
+        mx::ElementPtr material = doc->addChildOfCategory("material", "material" + suffix);
+        material->addChildOfCategory("shaderref", "shader" + suffix);
+        mx::ElementPtr overrideElem = material->addChildOfCategory("override", "public_geom");
+        overrideElem->setAttribute("value", "*");
+        if (i > 0)
+        {
+            mx::ElementPtr inherit = material->addChildOfCategory("materialinherit", "inherit");
+            inherit->setAttribute("material", "material" + std::to_string(i - 1));
+        }
+
+        // A look with material assignments and inheritance.
+        mx::ElementPtr look = doc->addChildOfCategory("look", "look" + suffix);
+        mx::ElementPtr assign = look->addChildOfCategory(minorVersion <= 23 ? "assign" : "materialassign", "material" + suffix);
+        assign->setAttribute("geom", "/geom" + suffix);
+        if (i > 0)
+        {
+            mx::ElementPtr inherit = look->addChildOfCategory("lookinherit", "inherit");
+            inherit->setAttribute("look", "look" + std::to_string(i - 1));
+        }
+    }
+    return doc;
+}
+
+TEST_CASE("Document: Version Upgrade", "[document]")
+{
+    for (const std::string& version : mx::StringVec{ "1.22", "1.26" })
+    {
+        mx::DocumentPtr doc = createLegacyDocument(version, 4);
+        doc->upgradeVersion();
+        REQUIRE(doc->getVersionString() == "1.36");
+        REQUIRE(doc->validate());
+
+        // Graphs and connections.
+        mx::NodeGraphPtr graph = doc->getNodeGraph("graph1");
+        REQUIRE(graph);
+        REQUIRE(graph->getNode("constant1")->getParameter("value"));
+        mx::InputPtr in1 = graph->getNode("multiply1")->getInput("in1");
+        REQUIRE(in1);
+        REQUIRE(in1->getNodeName() == "constant1");
+        REQUIRE(in1->getType() == "color3");
+        const std::string vectorType = (version == "1.22") ? "vector3" : "vector";
+        REQUIRE(doc->getNode("vector1")->getType() == vectorType);
+        REQUIRE(doc->getNode("vector1")->getParameter("value")->getType() == vectorType);
+        REQUIRE(doc->getNode("normalize1")->getInput("in")->getType() == vectorType);
+        mx::ParameterPtr in2 = graph->getNode("multiply1")->getParameter("in2");
+        REQUIRE(in2->getType() == "matrix44");
+        REQUIRE(in2->hasValueString());
+        REQUIRE(!in2->hasAttribute("default"));
+        REQUIRE(graph->getOutput("out")->getNodeName() == "multiply1");
+        REQUIRE(graph->getOutput("out")->getChildren().empty());
+
+        // Shaders, materials and looks.
+        mx::NodeDefPtr nodeDef = doc->getNodeDef("shader1");
+        REQUIRE(nodeDef);
+        REQUIRE(nodeDef->getType() == mx::SURFACE_SHADER_TYPE_STRING);
+        REQUIRE(nodeDef->getNodeString() == "program1");
+        REQUIRE(nodeDef->getParameter("texture")->getValueString() == "texture1.<UDIM>.tif");
+        REQUIRE(!nodeDef->getInput("base")->hasAttribute("opgraph"));
+        mx::MaterialPtr material = doc->getMaterial("material1");
+        mx::ShaderRefPtr shaderRef = material->getShaderRef("shader1");
+        REQUIRE(shaderRef->getNodeDefString() == "shader1");
+        REQUIRE(shaderRef->getBindInput("base")->getNodeGraphString() == "graph1");
+        REQUIRE(shaderRef->getBindParam("geom")->getValueString() == mx::UNIVERSAL_GEOM_NAME);
+        REQUIRE(material->getInheritString() == "material0");
+        REQUIRE(!material->getChild("public_geom"));
+        mx::LookPtr look = doc->getLook("look1");
+        REQUIRE(look->getInheritString() == "look0");
+        REQUIRE(look->getMaterialAssign("material1")->getMaterial() == "material1");
+
+        // Parallel upgrades must match serial upgrades exactly.
+        for (unsigned int threadCount : { 2u, 4u, 0u })
+        {
+            mx::DocumentPtr parallelDoc = createLegacyDocument(version, 4);
+            parallelDoc->setNamePathIndexEnabled(true);
+            parallelDoc->upgradeVersion(threadCount);
+            REQUIRE(*parallelDoc == *doc);
+            REQUIRE(parallelDoc->validateIncremental());
+            REQUIRE(parallelDoc->getDescendant("graph1/multiply1/in1") == parallelDoc->getNodeGraph("graph1")->getNode("multiply1")->getInput("in1"));
+            REQUIRE(parallelDoc->getNodeGraph("graph1")->getNode("multiply1")->getInput("in1")->getConnectedNode());
+        }
+    }
+}
+
+TEST_CASE("Document: Transactions", "[document]")
+{
+    // Create a document with a connected node graph.
+    mx::DocumentPtr doc = mx::createDocument();
+    doc->setNamePathIndexEnabled(true);
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph("graph1");
+    mx::NodePtr constant = nodeGraph->addNode("constant", "constant1", "color3");
+    constant->setParameterValue("value", mx::Color3(0.5f));
+    mx::NodePtr multiply = nodeGraph->addNode("multiply", "multiply1", "color3");
+    multiply->setConnectedNode("in1", constant);
+    multiply->setInputValue("in2", mx::Color3(0.25f));
+    mx::OutputPtr output = nodeGraph->addOutput("out", "color3");
+    output->setConnectedNode(multiply);
+    doc->addLook("look1");
+    mx::DocumentPtr original = doc->copy();
+
+    // Record edits of each kind within a transaction.
+    mx::DocumentTransaction transaction(doc);
+    REQUIRE_THROWS_AS(mx::DocumentTransaction nested(doc), mx::Exception&);
+    constant->setParameterValue("value", mx::Color3(1.0f));
+    constant->setName("constant2");
+    multiply->setConnectedNode("in1", constant);
+    mx::NodeGraphPtr nodeGraph2 = doc->addNodeGraph("graph2");
+    nodeGraph2->addNode("add", "add1", "float");
+    doc->removeLook("look1");
+    doc->setChildIndex("graph2", 0);
+    multiply->getInput("in2")->clearContent();
+    output->copyContentFrom(constant->getParameter("value"));
+    output->setConnectedNode(multiply);
+    REQUIRE(transaction.isOpen());
+    REQUIRE(!transaction.canUndo());
+    transaction.commit();
+    REQUIRE(!transaction.isOpen());
+    REQUIRE(transaction.canUndo());
+    mx::DocumentPtr edited = doc->copy();
+    REQUIRE(*edited != *original);
+
+    // Undo and redo the transaction, verifying the document and its indices.
+    for (int i = 0; i < 2; i++)
+    {
+        transaction.undo();
+        REQUIRE(*doc == *original);
+        REQUIRE(doc->validate());
+        REQUIRE(doc->getDescendant("graph1/constant1") == constant);
+        REQUIRE(!doc->getDescendant("graph2"));
+        REQUIRE(doc->getChildren()[0] == nodeGraph);
+        REQUIRE(multiply->getInput("in1")->getConnectedNode() == constant);
+        REQUIRE(output->getConnectedNode() == multiply);
+        REQUIRE(!transaction.canUndo());
+        REQUIRE_THROWS_AS(transaction.undo(), mx::Exception&);
+
+        transaction.redo();
+        REQUIRE(*doc == *edited);
+        REQUIRE(doc->getDescendant("graph1/constant2") == constant);
+        REQUIRE(doc->getDescendant("graph2/add1"));
+        REQUIRE(!doc->getLook("look1"));
+        REQUIRE(doc->getChildren()[0] == nodeGraph2);
+        REQUIRE(multiply->getInput("in1")->getConnectedNode() == constant);
+        REQUIRE(!transaction.canRedo());
+    }
+
+    // Repeated edits to a value share the journal entries of its value and
+    // type attributes.
+    mx::ParameterPtr param = constant->getParameter("value");
+    mx::DocumentTransaction drag(doc);
+    for (int i = 0; i < 100; i++)
+    {
+        param->setValue(mx::Color3((float) i / 100.0f));
+    }
+    drag.commit();
+    REQUIRE(drag.getEditCount() == 2);
+    drag.undo();
+    REQUIRE(*doc == *edited);
+}
+
+TEST_CASE("Document: Memory Statistics", "[document]")
+{
+    // Create a document with a node graph.
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph("graph1");
+    mx::NodePtr constant = nodeGraph->addNode("constant", "constant1", "color3");
+    constant->setParameterValue("value", mx::Color3(0.5f));
+    mx::NodePtr image = nodeGraph->addNode("image", "image1", "color3");
+    mx::OutputPtr output = nodeGraph->addOutput("out", "color3");
+    output->setConnectedNode(image);
+
+    // Check element counts.
+    mx::DocumentMemoryStats stats = doc->getMemoryStats();
+    REQUIRE(stats.elementCount == 6);
+    REQUIRE(stats.categoryCounts["nodegraph"] == 1);
+    REQUIRE(stats.categoryCounts["constant"] == 1);
+    REQUIRE(stats.categoryCounts["parameter"] == 1);
+    REQUIRE(stats.attributeCount > 0);
+    REQUIRE(stats.elementBytes > 0);
+    REQUIRE(stats.childMapBytes > 0);
+    REQUIRE(stats.getTotalBytes() >= stats.elementBytes + stats.attributeMapBytes);
+
+    // Check that duplicated strings are reported.
+    const std::string filename = "resources/Images/a_long_shared_texture_filename.png";
+    for (int i = 0; i < 10; i++)
+    {
+        mx::NodePtr node = nodeGraph->addNode("image", mx::EMPTY_STRING, "color3");
+        node->setParameterValue("file", filename, mx::FILENAME_TYPE_STRING);
+    }
+    mx::DocumentMemoryStats duplicateStats = doc->getMemoryStats();
+    REQUIRE(duplicateStats.elementCount == stats.elementCount + 20);
+    REQUIRE(duplicateStats.duplicateStringBytes >= stats.duplicateStringBytes + 9 * filename.size());
+
+    // Check that cached indices are reported.
+    doc->setNamePathIndexEnabled(true);
+    doc->getDescendant("graph1/image1");
+    mx::DocumentMemoryStats indexStats = doc->getMemoryStats();
+    REQUIRE(indexStats.cacheBytes > duplicateStats.cacheBytes);
+}
+
+//
+// Benchmarks
+//
+
+TEST_CASE("Document: Validation Benchmark", "[.benchmark]")
+{
+    // Create a document with the standard library definitions and a large
+    // number of top-level node graphs.
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::readFromXmlFile(doc, "stdlib_defs.mtlx", "libraries/stdlib");
+    const size_t graphCount = 200;
+    const size_t nodeCount = 50;
+    std::vector<mx::NodePtr> sources;
+    for (size_t i = 0; i < graphCount; i++)
+    {
+        mx::NodeGraphPtr graph = doc->addNodeGraph("bench_graph" + std::to_string(i));
+        mx::NodePtr source = graph->addNode("constant", "source", "color3");
+        source->setParameterValue("value", mx::Color3(0.5f));
+        mx::NodePtr prev = source;
+        for (size_t j = 0; j < nodeCount; j++)
+        {
+            mx::NodePtr node = graph->addNode("multiply", "node" + std::to_string(j), "color3");
+            node->setConnectedNode("in1", prev);
+            node->setInputValue("in2", mx::Color3(0.9f));
+            prev = node;
+        }
+        graph->addOutput("out", "color3")->setConnectedNode(prev);
+        sources.push_back(source);
+    }
+
+    const int iterations = 5;
+    auto timeValidation = [&](const std::function<bool()>& validateFunc)
+    {
+        auto startTime = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++)
+        {
+            REQUIRE(validateFunc());
+        }
+        std::chrono::duration<double> duration = std::chrono::steady_clock::now() - startTime;
+        return duration.count() * 1000.0 / iterations;
+    };
+
+    std::cout << "Validation benchmark with " << doc->getChildren().size() << " top-level elements, " <<
+                 std::thread::hardware_concurrency() << " hardware threads:" << std::endl;
+    std::cout << "    serial: " << timeValidation([&]() { return doc->validate(); }) << " ms" << std::endl;
+    for (unsigned int threadCount : { 1u, 2u, 4u, 8u })
+    {
+        double parallelTime = timeValidation([&]() { return doc->validateParallel(nullptr, threadCount); });
+        std::cout << "    parallel (" << threadCount << " threads): " << parallelTime << " ms" << std::endl;
+    }
+
+    // Re-validate after editing a single value.
+    REQUIRE(doc->validateIncremental());
+    size_t editIndex = 0;
+    double incrementalTime = timeValidation([&]()
+    {
+        sources[editIndex++ % graphCount]->setParameterValue("value", mx::Color3(0.25f));
+        return doc->validateIncremental();
+    });
+    std::cout << "    incremental after value edit: " << incrementalTime << " ms" << std::endl;
+}
+
+TEST_CASE("Document: Version Upgrade Benchmark", "[.benchmark]")
+{
+    // Upgrade a set of synthetic v1.26 documents.
+    const size_t documentCount = 50;
+    const size_t groupCount = 100;
+    auto timeUpgrade = [&](unsigned int threadCount)
+    {
+        std::vector<mx::DocumentPtr> docs;
+        for (size_t i = 0; i < documentCount; i++)
+        {
+            docs.push_back(createLegacyDocument("1.26", groupCount));
+        }
+        auto startTime = std::chrono::steady_clock::now();
+        for (mx::DocumentPtr doc : docs)
+        {
+            doc->upgradeVersion(threadCount);
+        }
+        std::chrono::duration<double> duration = std::chrono::steady_clock::now() - startTime;
+        for (mx::DocumentPtr doc : docs)
+        {
+            REQUIRE(doc->getVersionString() == "1.36");
+        }
+        return duration.count() * 1000.0 / documentCount;
+    };
+
+    std::cout << "Version upgrade benchmark with " << documentCount << " documents of " <<
+                 groupCount * 6 << " top-level elements, " <<
+                 std::thread::hardware_concurrency() << " hardware threads:" << std::endl;
+    for (unsigned int threadCount : { 1u, 2u, 4u, 8u })
+    {
+        std::cout << "    upgrade (" << threadCount << " threads): " << timeUpgrade(threadCount) << " ms per document" << std::endl;
+    }
+}
+
+TEST_CASE("Document: Transaction Benchmark", "[.benchmark]")
+{
+    // Create a document with a large number of top-level node graphs.
+    mx::DocumentPtr doc = mx::createDocument();
+    const size_t graphCount = 200;
+    const size_t nodeCount = 50;
+    for (size_t i = 0; i < graphCount; i++)
+    {
+        mx::NodeGraphPtr graph = doc->addNodeGraph("bench_graph" + std::to_string(i));
+        mx::NodePtr prev = graph->addNode("constant", "source", "color3");
+        prev->setParameterValue("value", mx::Color3(0.5f));
+        for (size_t j = 0; j < nodeCount; j++)
+        {
+            mx::NodePtr node = graph->addNode("multiply", "node" + std::to_string(j), "color3");
+            node->setConnectedNode("in1", prev);
+            node->setInputValue("in2", mx::Color3(0.9f));
+            prev = node;
+        }
+        graph->addOutput("out", "color3")->setConnectedNode(prev);
+    }
+
+    // Apply an interactive edit to the document, adjusting a value many
+    // times and adding a node.
+    const int iterations = 10;
+    const int valueEdits = 50;
+    auto applyEdit = [&](int iteration)
+    {
+        mx::NodeGraphPtr graph = doc->getNodeGraph("bench_graph" + std::to_string(iteration % graphCount));
+        mx::NodePtr source = graph->getNode("source");
+        for (int i = 0; i < valueEdits; i++)
+        {
+            source->setParameterValue("value", mx::Color3((float) i / valueEdits));
+        }
+        graph->addNode("constant", "added", "color3");
+    };
+
+    // Undo and redo with whole-document snapshots.
+    auto startTime = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+        mx::DocumentPtr before = doc->copy();
+        applyEdit(i);
+        mx::DocumentPtr after = doc->copy();
+        for (mx::DocumentPtr snapshot : { before, after, before })
+        {
+            doc->clearContent();
+            doc->copyContentFrom(snapshot);
+        }
+    }
+    std::chrono::duration<double> snapshotDuration = std::chrono::steady_clock::now() - startTime;
+
+    // Undo and redo with transactions.
+    size_t editCount = 0;
+    startTime = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+        mx::DocumentTransaction transaction(doc);
+        applyEdit(i);
+        transaction.commit();
+        transaction.undo();
+        transaction.redo();
+        transaction.undo();
+        editCount += transaction.getEditCount();
+    }
+    std::chrono::duration<double> transactionDuration = std::chrono::steady_clock::now() - startTime;
+
+    std::cout << "Transaction benchmark with " << graphCount * (nodeCount + 2) << " nodes:" << std::endl;
+    std::cout << "    snapshot edit, undo, redo, undo: " << snapshotDuration.count() * 1000.0 / iterations << " ms" << std::endl;
+    std::cout << "    transaction edit, undo, redo, undo: " << transactionDuration.count() * 1000.0 / iterations << " ms, " <<
+                 editCount / iterations << " journal entries for " << valueEdits << " value edits and one node addition" << std::endl;
+}
@@ -7,6 +7,9 @@
 
 #include <MaterialXCore/Document.h>
 
+#include <chrono>
+#include <iostream>
+
 namespace mx = MaterialX;
 
 TEST_CASE("Element", "[element]")
@@ -21,6 +24,8 @@ TEST_CASE("Element", "[element]")
     REQUIRE(elem2->getParent() == doc);
     REQUIRE(elem1->getRoot() == doc);
     REQUIRE(elem2->getRoot() == doc);
+    REQUIRE(elem1->getParentRaw() == doc.get());
+    REQUIRE(elem1->getDocumentRaw() == doc.get());
     REQUIRE(doc->getChildren()[0] == elem1);
     REQUIRE(doc->getChildren()[1] == elem2);
 
@@ -30,6 +35,34 @@ TEST_CASE("Element", "[element]")
     REQUIRE(elem1->getActiveFilePrefix() == doc->getFilePrefix());
     REQUIRE(elem2->getActiveColorSpace() == doc->getColorSpace());
 
+    // Modify hierarchical properties at nested scopes.
+    mx::ElementPtr child1 = elem1->addChildOfCategory("generic", "child1");
+    REQUIRE(child1->getActiveColorSpace() == "lin_rec709");
+    elem1->setColorSpace("gamma22");
+    REQUIRE(child1->getActiveColorSpace() == "gamma22");
+    REQUIRE(elem2->getActiveColorSpace() == "lin_rec709");
+    elem1->removeAttribute(mx::Element::COLOR_SPACE_ATTRIBUTE);
+    REQUIRE(child1->getActiveColorSpace() == "lin_rec709");
+    doc->setGeomPrefix("/asset/");
+    REQUIRE(child1->getActiveGeomPrefix() == "/asset/");
+    elem1->setSourceUri("elem1.mtlx");
+    REQUIRE(child1->getActiveSourceUri() == "elem1.mtlx");
+    REQUIRE(elem2->getActiveSourceUri().empty());
+    elem1->setSourceUri(mx::EMPTY_STRING);
+    REQUIRE(child1->getActiveSourceUri().empty());
+    REQUIRE(child1->getQualifiedName("name") == "name");
+    doc->setNamespace("outer");
+    REQUIRE(child1->getQualifiedName("name") == "outer:name");
+    elem1->setNamespace("inner");
+    REQUIRE(child1->getQualifiedName("name") == "inner:name");
+    REQUIRE(elem2->getQualifiedName("name") == "outer:name");
+    doc->removeAttribute(mx::Element::NAMESPACE_ATTRIBUTE);
+    elem1->removeAttribute(mx::Element::NAMESPACE_ATTRIBUTE);
+    REQUIRE(child1->getQualifiedName("name") == "name");
+    doc->removeAttribute(mx::Element::GEOM_PREFIX_ATTRIBUTE);
+    REQUIRE(child1->getActiveGeomPrefix().empty());
+    elem1->removeChild(child1->getName());
+
     // Set typed attributes.
     REQUIRE(elem1->getTypedAttribute<bool>("customFlag") == false);
     REQUIRE(elem1->getTypedAttribute<mx::Color3>("customColor") == mx::Color3(0.0f));
@@ -47,6 +80,13 @@ TEST_CASE("Element", "[element]")
     REQUIRE(elem2->getName() == "elem2");
     REQUIRE_THROWS_AS(elem2->setName("elem1"), mx::Exception&);
 
+    // Set attributes from temporary strings.
+    std::string longValue = "A value string too long for inline storage";
+    elem2->setAttribute(std::string("note"), std::string(longValue));
+    elem2->setAttribute(std::string("note"), longValue + "!");
+    REQUIRE(elem2->getAttribute("note") == longValue + "!");
+    REQUIRE(elem2->getAttributeNames().back() == "note");
+
     // Modify element order.
     mx::DocumentPtr doc2 = doc->copy();
     REQUIRE(*doc2 == *doc);
@@ -57,6 +97,16 @@ TEST_CASE("Element", "[element]")
     REQUIRE_THROWS_AS(doc2->setChildIndex("elem1", 100), mx::Exception&);
     REQUIRE(*doc2 == *doc);
 
+    // Removed elements retain their document.
+    mx::ElementPtr removed = doc2->getChild("elem1");
+    mx::ElementPtr removedChild = removed->addChildOfCategory("generic");
+    doc2->removeChild("elem1");
+    REQUIRE(!removed->getParentRaw());
+    REQUIRE(removed->getDocumentRaw() == doc2.get());
+    REQUIRE(removedChild->getParentRaw() == removed.get());
+    REQUIRE(removedChild->getDocumentRaw() == doc2.get());
+    REQUIRE(removedChild->getAncestorOfType<mx::Document>() == doc2);
+
     // Create and test an orphaned element.
     mx::ElementPtr orphan;
     {
@@ -65,4 +115,156 @@ TEST_CASE("Element", "[element]")
         REQUIRE(orphan);
     }
     REQUIRE_THROWS_AS(orphan->getDocument(), mx::ExceptionOrphanedElement&);    
+    REQUIRE(!orphan->getParentRaw());
+    REQUIRE(!orphan->getDocumentRaw());
+}
+
+//
+// Benchmarks
+//
+
+TEST_CASE("Element: Scope Benchmark", "[.benchmark]")
+{
+    const int GRAPH_COUNT = 100;
+    const int NODE_COUNT = 50;
+    const int INPUT_COUNT = 4;
+    const int QUERY_ROUNDS = 10;
+
+    // Create a document with nested scopes.
+    mx::DocumentPtr doc = mx::createDocument();
+    doc->setColorSpace("lin_rec709");
+    doc->setFilePrefix("textures/");
+    std::vector<mx::InputPtr> inputs;
+    for (int g = 0; g < GRAPH_COUNT; g++)
+    {
+        mx::NodeGraphPtr graph = doc->addNodeGraph();
+        if (g % 2)
+        {
+            graph->setColorSpace("gamma22");
+        }
+        for (int n = 0; n < NODE_COUNT; n++)
+        {
+            mx::NodePtr node = graph->addNode("image");
+            for (int i = 0; i < INPUT_COUNT; i++)
+            {
+                inputs.push_back(node->addInput("in" + std::to_string(i), "filename"));
+            }
+        }
+    }
+
+    size_t checksum = 0;
+    auto queryStart = std::chrono::steady_clock::now();
+    for (int r = 0; r < QUERY_ROUNDS; r++)
+    {
+        for (mx::InputPtr input : inputs)
+        {
+            checksum += input->getActiveColorSpace().size();
+            checksum += input->getActiveFilePrefix().size();
+            checksum += input->getQualifiedName(input->getName()).size();
+        }
+    }
+    auto queryEnd = std::chrono::steady_clock::now();
+    REQUIRE(checksum == (size_t) QUERY_ROUNDS * (GRAPH_COUNT / 2) * NODE_COUNT * INPUT_COUNT *
+                        (std::string("lin_rec709textures/in0").size() + std::string("gamma22textures/in0").size()));
+
+    double queryMs = std::chrono::duration<double, std::milli>(queryEnd - queryStart).count();
+    std::cout << "Scope queries: " << inputs.size() * QUERY_ROUNDS << " inputs, " <<
+                 queryMs << " ms, " << queryMs * 1000.0 / (inputs.size() * QUERY_ROUNDS) << " us per input" << std::endl;
+}
+
+TEST_CASE("Element: Back-Pointer Benchmark", "[.benchmark]")
+{
+    const int GRAPH_COUNT = 100;
+    const int NODE_COUNT = 50;
+    const int INPUT_COUNT = 4;
+    const int ROUNDS = 10;
+
+    // Create a document with a large number of inputs.
+    mx::DocumentPtr doc = mx::createDocument();
+    std::vector<mx::InputPtr> inputs;
+    for (int g = 0; g < GRAPH_COUNT; g++)
+    {
+        mx::NodeGraphPtr graph = doc->addNodeGraph();
+        for (int n = 0; n < NODE_COUNT; n++)
+        {
+            mx::NodePtr node = graph->addNode("image");
+            for (int i = 0; i < INPUT_COUNT; i++)
+            {
+                inputs.push_back(node->addInput("in" + std::to_string(i), "float"));
+            }
+        }
+    }
+    const size_t queryCount = inputs.size() * ROUNDS;
+    auto reportTime = [queryCount](const std::string& label, std::chrono::steady_clock::time_point startTime)
+    {
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+        std::cout << "    " << label << ": " << ms << " ms, " << ms * 1.0e6 / queryCount << " ns per input" << std::endl;
+    };
+    std::cout << "Back-pointer benchmark with " << inputs.size() << " inputs:" << std::endl;
+
+    // Set attributes.
+    auto startTime = std::chrono::steady_clock::now();
+    for (int r = 0; r < ROUNDS; r++)
+    {
+        for (mx::InputPtr input : inputs)
+        {
+            input->setAttribute(mx::ValueElement::VALUE_ATTRIBUTE, "0.5");
+        }
+    }
+    reportTime("setAttribute", startTime);
+
+    // Query ancestors and documents.
+    size_t checksum = 0;
+    startTime = std::chrono::steady_clock::now();
+    for (int r = 0; r < ROUNDS; r++)
+    {
+        for (mx::InputPtr input : inputs)
+        {
+            checksum += input->getAncestorOfType<mx::NodeGraph>() != nullptr;
+        }
+    }
+    reportTime("getAncestorOfType", startTime);
+    startTime = std::chrono::steady_clock::now();
+    for (int r = 0; r < ROUNDS; r++)
+    {
+        for (mx::InputPtr input : inputs)
+        {
+            checksum += input->getDocument() == doc;
+        }
+    }
+    reportTime("getDocument", startTime);
+    startTime = std::chrono::steady_clock::now();
+    for (int r = 0; r < ROUNDS; r++)
+    {
+        for (mx::InputPtr input : inputs)
+        {
+            for (mx::ElementPtr elem = input; elem; elem = elem->getParent())
+            {
+                checksum++;
+            }
+        }
+    }
+    reportTime("getParent walk", startTime);
+    startTime = std::chrono::steady_clock::now();
+    for (int r = 0; r < ROUNDS; r++)
+    {
+        for (mx::InputPtr input : inputs)
+        {
+            checksum += input->getDocumentRaw() == doc.get();
+        }
+    }
+    reportTime("getDocumentRaw", startTime);
+    startTime = std::chrono::steady_clock::now();
+    for (int r = 0; r < ROUNDS; r++)
+    {
+        for (mx::InputPtr input : inputs)
+        {
+            for (mx::Element* elem = input.get(); elem; elem = elem->getParentRaw())
+            {
+                checksum++;
+            }
+        }
+    }
+    reportTime("getParentRaw walk", startTime);
+    REQUIRE(checksum == queryCount * 11);
 }
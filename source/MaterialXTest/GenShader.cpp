@@ -13,16 +13,25 @@
 
 #include <MaterialXGenShader/HwShaderGenerator.h>
 #include <MaterialXGenShader/Nodes/SwizzleNode.h>
+#include <MaterialXGenShader/Shader.h>
+#include <MaterialXGenShader/ShaderCache.h>
+#include <MaterialXGenShader/SourceFileCache.h>
 #include <MaterialXGenShader/TypeDesc.h>
 #include <MaterialXGenShader/Util.h>
 
+#include <MaterialXGenGlsl/GlslShaderGenerator.h>
+#include <MaterialXGenOsl/OslShaderGenerator.h>
+
 #include <MaterialXTest/GenShaderUtil.h>
 
+#include <algorithm>
+#include <chrono>
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include <vector>
 #include <set>
+#include <thread>
 
 namespace mx = MaterialX;
 
@@ -196,3 +205,1326 @@ TEST_CASE("GenShader: OSL Reference Implementation Check", "[genshader]")
     // To enable once this is true
     //REQUIRE(missing == 0);
 }
+
+TEST_CASE("GenShader: Memory Statistics", "[genshader]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::FilePath searchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    GenShaderUtil::loadLibraries({ "stdlib" }, searchPath, doc);
+
+    // Create a node graph using a node with a graph implementation.
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph("memory_stats");
+    mx::NodePtr tiledImage = nodeGraph->addNode("tiledimage", "tiledimage1", "color3");
+    mx::OutputPtr output = nodeGraph->addOutput("out", "color3");
+    output->setConnectedNode(tiledImage);
+
+    mx::GenContext context(mx::OslShaderGenerator::create());
+    context.registerSourceCodeSearchPath(searchPath);
+    context.registerSourceCodeSearchPath(searchPath / mx::FilePath("stdlib/osl"));
+    mx::GenMemoryStats emptyStats = context.getMemoryStats();
+    REQUIRE(emptyStats.implementationCount == 0);
+
+    // Check that cached implementations and their graphs are reported.
+    mx::ShaderPtr shader = context.getShaderGenerator().generate("memory_stats", output, context);
+    REQUIRE(shader);
+    mx::GenMemoryStats stats = context.getMemoryStats();
+    REQUIRE(stats.implementationCount > 0);
+    REQUIRE(stats.implementationBytes > 0);
+    REQUIRE(stats.compoundGraphCount == 1);
+    REQUIRE(stats.compoundGraphNodeCount > 0);
+    REQUIRE(stats.compoundGraphBytes > 0);
+    REQUIRE(stats.getTotalBytes() > emptyStats.getTotalBytes());
+    REQUIRE(shader->getGraph().getMemoryBytes() > 0);
+
+    context.clearNodeImplementations();
+    REQUIRE(context.getMemoryStats().implementationCount == 0);
+}
+
+TEST_CASE("GenShader: Shader Cache", "[genshader]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::FilePath searchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    GenShaderUtil::loadLibraries({ "stdlib" }, searchPath, doc);
+
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph("shader_cache");
+    mx::NodePtr tiledImage = nodeGraph->addNode("tiledimage", "tiledimage1", "color3");
+    tiledImage->setParameterValue("file", std::string("resources/Images/grid.png"), mx::FILENAME_TYPE_STRING);
+    mx::NodePtr multiply = nodeGraph->addNode("multiply", "multiply1", "color3");
+    multiply->setConnectedNode("in1", tiledImage);
+    multiply->setInputValue("in2", mx::Color3(0.5f));
+    mx::OutputPtr output = nodeGraph->addOutput("out", "color3");
+    output->setConnectedNode(multiply);
+
+    mx::GenContext context(mx::OslShaderGenerator::create());
+    context.registerSourceCodeSearchPath(searchPath);
+    context.registerSourceCodeSearchPath(searchPath / mx::FilePath("stdlib/osl"));
+
+    // Create a cache with a memory backend in front of a directory backend.
+    mx::FilePath cachePath = mx::FilePath::getCurrentPath() / mx::FilePath("shadercache");
+    mx::DirectoryShaderCacheBackendPtr directory = mx::DirectoryShaderCacheBackend::create(cachePath);
+    directory->clear();
+    mx::MemoryShaderCacheBackendPtr memory = mx::MemoryShaderCacheBackend::create();
+    mx::ShaderCachePtr cache = mx::ShaderCache::create(memory);
+    cache->addBackend(directory);
+
+    // Keys are stable, and depend on the content of upstream elements and
+    // the generation options.
+    const std::string key = cache->computeKey("shader_cache", output, context);
+    REQUIRE(key == cache->computeKey("shader_cache", output, context));
+    REQUIRE(key != cache->computeKey("shader_cache2", output, context));
+    multiply->setInputValue("in2", mx::Color3(0.25f));
+    REQUIRE(key != cache->computeKey("shader_cache", output, context));
+    multiply->setInputValue("in2", mx::Color3(0.5f));
+    REQUIRE(key == cache->computeKey("shader_cache", output, context));
+    context.getOptions().fileTextureVerticalFlip = true;
+    REQUIRE(key != cache->computeKey("shader_cache", output, context));
+    context.getOptions().fileTextureVerticalFlip = false;
+    doc->getNodeDef("ND_tiledimage_color3")->setAttribute("doc", "Edited");
+    REQUIRE(key != cache->computeKey("shader_cache", output, context));
+    doc->getNodeDef("ND_tiledimage_color3")->removeAttribute("doc");
+
+    // Generate and store a shader, which is then found in the memory backend.
+    mx::ShaderPtr shader = cache->generate("shader_cache", output, context);
+    REQUIRE(shader);
+    REQUIRE(cache->generate("shader_cache", output, context) == shader);
+    REQUIRE(cache->getStats().hits == 1);
+    REQUIRE(cache->getStats().misses == 1);
+    REQUIRE(memory->size() == 1);
+    REQUIRE(directory->size() == 1);
+
+    // Load the shader from the directory in a new cache.
+    mx::ShaderCachePtr diskCache = mx::ShaderCache::create(mx::DirectoryShaderCacheBackend::create(cachePath));
+    mx::ShaderPtr diskShader = diskCache->generate("shader_cache", output, context);
+    REQUIRE(diskCache->getStats().hits == 1);
+    REQUIRE(diskShader != shader);
+    REQUIRE(diskShader->getName() == shader->getName());
+    REQUIRE(diskShader->numStages() == shader->numStages());
+    for (size_t i = 0; i < shader->numStages(); i++)
+    {
+        const mx::ShaderStage& stage = shader->getStage(i);
+        const mx::ShaderStage& diskStage = diskShader->getStage(i);
+        REQUIRE(diskStage.getName() == stage.getName());
+        REQUIRE(diskStage.getSourceCode() == stage.getSourceCode());
+        REQUIRE(diskStage.getUniformBlocks().size() == stage.getUniformBlocks().size());
+        for (const auto& it : stage.getUniformBlocks())
+        {
+            const mx::VariableBlock& block = *it.second;
+            const mx::VariableBlock& diskBlock = diskStage.getUniformBlock(it.first);
+            REQUIRE(diskBlock.size() == block.size());
+            for (size_t j = 0; j < block.size(); j++)
+            {
+                REQUIRE(diskBlock[j]->getName() == block[j]->getName());
+                REQUIRE(diskBlock[j]->getType() == block[j]->getType());
+                REQUIRE(diskBlock[j]->getPath() == block[j]->getPath());
+                REQUIRE((diskBlock[j]->getValue() ? diskBlock[j]->getValue()->getValueString() : "") ==
+                        (block[j]->getValue() ? block[j]->getValue()->getValueString() : ""));
+            }
+        }
+    }
+
+    // Changed content results in a miss, and entries beyond the capacity
+    // of a backend are evicted.
+    memory->setCapacity(1);
+    multiply->setInputValue("in2", mx::Color3(0.75f));
+    mx::ShaderPtr editedShader = cache->generate("shader_cache", output, context);
+    REQUIRE(editedShader != shader);
+    REQUIRE(cache->getStats().misses == 2);
+    REQUIRE(memory->size() == 1);
+    REQUIRE(directory->size() == 2);
+    REQUIRE(cache->getStats().evictions == 1);
+
+    // Corrupt entries are treated as misses.
+    const std::string editedKey = cache->computeKey("shader_cache", output, context);
+    std::ofstream((cachePath / mx::FilePath(editedKey + "." + mx::DirectoryShaderCacheBackend::FILE_EXTENSION)).asString()) << "corrupt";
+    mx::ShaderCachePtr corruptCache = mx::ShaderCache::create(mx::DirectoryShaderCacheBackend::create(cachePath));
+    REQUIRE(corruptCache->generate("shader_cache", output, context));
+    REQUIRE(corruptCache->getStats().misses == 1);
+
+    cache->clear();
+    REQUIRE(memory->size() == 0);
+    REQUIRE(directory->size() == 0);
+}
+
+TEST_CASE("GenShader: Source File Cache", "[genshader]")
+{
+    mx::SourceFileCache& sourceFiles = mx::SourceFileCache::getInstance();
+
+    // Files are split into lines, with include directives located.
+    mx::FilePath sourcePath = mx::FilePath::getCurrentPath() / mx::FilePath("source_file_cache.glsl");
+    std::ofstream(sourcePath.asString()) << "#include \"lib/mx_math.glsl\"\nfloat a = 1.0;\n\nfloat b = 2.0;\n";
+    mx::SourceFilePtr file = sourceFiles.getFile(sourcePath);
+    REQUIRE(file);
+    REQUIRE(file->getLines().size() == 4);
+    REQUIRE(file->getLines()[0].isInclude);
+    REQUIRE(file->getLines()[1].text == "float a = 1.0;");
+    REQUIRE(file->getLines()[2].text.empty());
+    REQUIRE(file->getIncludes() == mx::StringVec({ "lib/mx_math.glsl" }));
+
+    // Unchanged files are read once, and modified files are read again.
+    size_t readCount = sourceFiles.getReadCount();
+    REQUIRE(sourceFiles.getFile(sourcePath) == file);
+    REQUIRE(sourceFiles.getReadCount() == readCount);
+    std::ofstream(sourcePath.asString()) << "float a = 1.0;\n";
+    GenShaderUtil::setModificationTime(sourcePath, 1000000);
+    mx::SourceFilePtr modifiedFile = sourceFiles.getFile(sourcePath);
+    REQUIRE(modifiedFile != file);
+    REQUIRE(modifiedFile->getLines().size() == 1);
+    REQUIRE(sourceFiles.getReadCount() == readCount + 1);
+
+    // Edits that preserve the file size are detected through their
+    // modification times.
+    std::ofstream(sourcePath.asString()) << "float a = 2.0;\n";
+    GenShaderUtil::setModificationTime(sourcePath, 2000000);
+    mx::SourceFilePtr editedFile = sourceFiles.getFile(sourcePath);
+    REQUIRE(editedFile != modifiedFile);
+    REQUIRE(editedFile->getLines()[0].text == "float a = 2.0;");
+    std::remove(sourcePath.asString().c_str());
+    REQUIRE(!sourceFiles.getFile(sourcePath));
+
+    // Source files are shared between generation contexts.
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::FilePath searchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    GenShaderUtil::loadLibraries({ "stdlib", "pbrlib" }, searchPath, doc);
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph("source_file_cache");
+    mx::NodePtr noise = nodeGraph->addNode("noise2d", "noise1", "color3");
+    mx::OutputPtr output = nodeGraph->addOutput("out", "color3");
+    output->setConnectedNode(noise);
+    for (int i = 0; i < 2; i++)
+    {
+        mx::GenContext context(mx::GlslShaderGenerator::create());
+        context.registerSourceCodeSearchPath(searchPath);
+        context.registerSourceCodeSearchPath(searchPath / mx::FilePath("stdlib/genglsl"));
+        readCount = sourceFiles.getReadCount();
+        REQUIRE(context.getShaderGenerator().generate("source_file_cache", output, context));
+        if (i > 0)
+        {
+            REQUIRE(sourceFiles.getReadCount() == readCount);
+        }
+    }
+}
+
+TEST_CASE("GenShader: Parallel Generation", "[genshader]")
+{
+    mx::FilePath searchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    mx::DocumentPtr libraries = mx::createDocument();
+    GenShaderUtil::loadLibraries({ "stdlib", "pbrlib", "bxdf" }, searchPath, libraries);
+
+    mx::FilePath materialsPath = mx::FilePath::getCurrentPath() / mx::FilePath("resources/Materials/Examples/StandardSurface");
+    std::vector<mx::DocumentPtr> docs;
+    std::vector<mx::ElementPtr> elements;
+    for (const mx::FilePath& filename : materialsPath.getFilesInDirectory("mtlx"))
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        mx::readFromXmlFile(doc, materialsPath / filename);
+        doc->importLibrary(libraries);
+        std::vector<mx::TypedElementPtr> renderables;
+        mx::findRenderableElements(doc, renderables);
+        elements.insert(elements.end(), renderables.begin(), renderables.end());
+        docs.push_back(doc);
+    }
+    REQUIRE(!elements.empty());
+
+    // Generate the shaders serially as a reference.
+    mx::ShaderGeneratorPtr shaderGenerator = mx::GlslShaderGenerator::create();
+    std::vector<std::string> references;
+    {
+        mx::GenContext context(shaderGenerator);
+        context.registerSourceCodeSearchPath(searchPath);
+        for (mx::ElementPtr elem : elements)
+        {
+            references.push_back(shaderGenerator->generate(elem->getName(), elem, context)->getSourceCode(mx::Stage::PIXEL));
+        }
+    }
+
+    // Parallel generation returns identical shaders in element order, and
+    // shares the implementations of the calling context.
+    mx::GenContext context(shaderGenerator);
+    context.registerSourceCodeSearchPath(searchPath);
+    std::vector<mx::ShaderPtr> shaders = shaderGenerator->generateAll(elements, context, 4);
+    REQUIRE(shaders.size() == elements.size());
+    for (size_t i = 0; i < shaders.size(); i++)
+    {
+        REQUIRE(shaders[i]->getName() == elements[i]->getName());
+        REQUIRE(shaders[i]->getSourceCode(mx::Stage::PIXEL) == references[i]);
+    }
+    REQUIRE(context.getMemoryStats().implementationCount > 0);
+    mx::GenContext workerContext = context.createWorkerContext();
+    REQUIRE(workerContext.getMemoryStats().implementationCount == context.getMemoryStats().implementationCount);
+
+    // Failures are reported for the first failing element.
+    std::vector<mx::ElementPtr> invalidElements = elements;
+    invalidElements.push_back(docs[0]);
+    REQUIRE_THROWS_AS(shaderGenerator->generateAll(invalidElements, context, 4), mx::ExceptionShaderGenError&);
+
+    // Failures to create the implementations of an element are reported.
+    mx::DocumentPtr doc = docs[0];
+    mx::NodeDefPtr nodeDef = doc->addNodeDef("ND_unsourced_float", "float", "unsourced");
+    mx::ImplementationPtr impl = doc->addImplementation("IM_unsourced_float_genglsl");
+    impl->setNodeDef(nodeDef);
+    impl->setLanguage(mx::GlslShaderGenerator::LANGUAGE);
+    mx::NodePtr unsourced = doc->addNode("unsourced", "unsourced1", "float");
+    mx::OutputPtr output = doc->addOutput("unsourced_out", "float");
+    output->setConnectedNode(unsourced);
+    invalidElements = elements;
+    invalidElements.push_back(output);
+    REQUIRE_THROWS_AS(shaderGenerator->generateAll(invalidElements, context, 4), mx::ExceptionShaderGenError&);
+}
+
+TEST_CASE("GenShader: Implementation Registry", "[genshader]")
+{
+    mx::FilePath searchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    mx::DocumentPtr doc = mx::createDocument();
+    GenShaderUtil::loadLibraries({ "stdlib", "pbrlib", "bxdf" }, searchPath, doc);
+    mx::NodePtr shaderNode = doc->addNode("standard_surface", "surface1", "surfaceshader");
+    mx::OutputPtr output = doc->addOutput("out", "surfaceshader");
+    output->setConnectedNode(shaderNode);
+
+    mx::ShaderGeneratorPtr shaderGenerator = mx::GlslShaderGenerator::create();
+    mx::ShaderNodeImplRegistryPtr registry = shaderGenerator->getImplementationRegistry();
+    REQUIRE(registry);
+    registry->clear();
+
+    // Contexts attached to the registry share their implementations.
+    mx::GenContext context1(shaderGenerator);
+    context1.registerSourceCodeSearchPath(searchPath);
+    context1.setImplementationRegistry(registry);
+    REQUIRE(shaderGenerator->generate("shader1", output, context1));
+    size_t registrySize = registry->size();
+    REQUIRE(registrySize > 0);
+
+    mx::GenContext context2(shaderGenerator);
+    context2.registerSourceCodeSearchPath(searchPath);
+    context2.setImplementationRegistry(registry);
+    REQUIRE(shaderGenerator->generate("shader2", output, context2));
+    REQUIRE(registry->size() == registrySize);
+    const std::string implName = "IMPL_standard_surface_surfaceshader";
+    REQUIRE(context1.findNodeImplementation(implName));
+    REQUIRE(context1.findNodeImplementation(implName) == context2.findNodeImplementation(implName));
+
+    // Contexts that initialize implementations differently do not share them.
+    mx::GenContext context3(shaderGenerator);
+    context3.registerSourceCodeSearchPath(searchPath);
+    context3.registerSourceCodeSearchPath(searchPath / mx::FilePath("stdlib/genglsl"));
+    context3.setImplementationRegistry(registry);
+    REQUIRE(shaderGenerator->generate("shader3", output, context3));
+    REQUIRE(registry->size() == 2 * registrySize);
+    REQUIRE(context3.findNodeImplementation(implName) != context1.findNodeImplementation(implName));
+
+    // Contexts without a registry create their own implementations.
+    mx::GenContext context4(shaderGenerator);
+    context4.registerSourceCodeSearchPath(searchPath);
+    REQUIRE(shaderGenerator->generate("shader4", output, context4));
+    REQUIRE(context4.findNodeImplementation(implName) != context1.findNodeImplementation(implName));
+
+    // The active color space of the source document is part of the key.
+    mx::InterfaceElementPtr impl = doc->getNodeGraph(implName);
+    REQUIRE(impl);
+    const std::string implKey = shaderGenerator->getImplementationKey(*impl, context1);
+    doc->setColorSpace("srgb_texture");
+    REQUIRE(shaderGenerator->getImplementationKey(*impl, context1) != implKey);
+    doc->setColorSpace(mx::EMPTY_STRING);
+
+    // Light shaders bound in contexts sharing a registry use the same
+    // implementation, whose graph is prefixed once with the light struct.
+    mx::FilePath lightPath("resources/Materials/TestSuite/Utilities/Lights/lightcompoundtest.mtlx");
+    GenShaderUtil::loadLibrary(mx::FilePath::getCurrentPath() / lightPath, doc);
+    mx::ShaderGraphRegistryPtr graphRegistry = shaderGenerator->getGraphRegistry();
+    graphRegistry->clear();
+    context1.setGraphRegistry(graphRegistry);
+    context2.setGraphRegistry(graphRegistry);
+    mx::NodeDefPtr lightDef = doc->getNodeDef("ND_lightcompoundtest");
+    REQUIRE(lightDef);
+    mx::HwShaderGenerator::bindLightShader(*lightDef, 1, context1);
+    mx::HwShaderGenerator::bindLightShader(*lightDef, 1, context2);
+    mx::ShaderGraph* lightGraph = context1.findNodeImplementation("NG_lightcompoundtest")->getGraph();
+    REQUIRE(lightGraph);
+    REQUIRE(lightGraph == context2.findNodeImplementation("NG_lightcompoundtest")->getGraph());
+    REQUIRE(!lightGraph->getInputSockets().empty());
+    for (mx::ShaderGraphInputSocket* socket : lightGraph->getInputSockets())
+    {
+        REQUIRE(socket->getVariable().compare(0, 6, "light.") == 0);
+        REQUIRE(socket->getVariable().compare(6, 6, "light.") != 0);
+    }
+
+    // File textures inside shared compound implementations keep their
+    // filenames for every context generating from them.
+    const std::string filename = "resources/Images/grid.png";
+    mx::NodeDefPtr gridDef = doc->addNodeDef("ND_grid_color3", "color3", "grid");
+    mx::NodeGraphPtr gridGraph = doc->addNodeGraph("NG_grid_color3");
+    gridGraph->setNodeDef(gridDef);
+    mx::NodePtr tiledImage = gridGraph->addNode("tiledimage", "tiledimage1", "color3");
+    tiledImage->setParameterValue("file", filename, mx::FILENAME_TYPE_STRING);
+    gridGraph->addOutput("out", "color3")->setConnectedNode(tiledImage);
+    mx::OutputPtr textureOutput = doc->addOutput("grid_out", "color3");
+    textureOutput->setConnectedNode(doc->addNode("grid", "grid1", "color3"));
+    for (mx::GenContext* context : { &context1, &context2 })
+    {
+        mx::ShaderPtr shader = shaderGenerator->generate("shader", textureOutput, *context);
+        REQUIRE(shader);
+        const mx::VariableBlock& uniforms = shader->getStage(mx::Stage::PIXEL).getUniformBlock(mx::HW::PUBLIC_UNIFORMS);
+        size_t textureCount = 0;
+        for (size_t i = 0; i < uniforms.size(); i++)
+        {
+            if (uniforms[i]->getType() == mx::Type::FILENAME)
+            {
+                REQUIRE(uniforms[i]->getValue());
+                REQUIRE(uniforms[i]->getValue()->getValueString() == filename);
+                textureCount++;
+            }
+        }
+        REQUIRE(textureCount == 1);
+    }
+    REQUIRE(context1.findNodeImplementation("NG_grid_color3") == context2.findNodeImplementation("NG_grid_color3"));
+
+    graphRegistry->clear();
+    registry->clear();
+}
+
+TEST_CASE("GenShader: Constant Folding", "[genshader]")
+{
+    mx::FilePath searchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    mx::DocumentPtr doc = mx::createDocument();
+    GenShaderUtil::loadLibraries({ "stdlib" }, searchPath, doc);
+
+    // A chain of math nodes on literal values, feeding a node with a
+    // geometric input.
+    mx::NodePtr constant1 = doc->addNode("constant", "constant1", "color3");
+    constant1->setParameterValue("value", mx::Color3(0.25f, 0.5f, 1.0f));
+    mx::NodePtr multiply1 = doc->addNode("multiply", "multiply1", "color3");
+    multiply1->setConnectedNode("in1", constant1);
+    multiply1->setInputValue("in2", mx::Color3(2.0f, 2.0f, 2.0f));
+    mx::NodePtr swizzle1 = doc->addNode("swizzle", "swizzle1", "float");
+    swizzle1->setConnectedNode("in", multiply1);
+    swizzle1->setParameterValue("channels", std::string("g"));
+    mx::NodePtr combine1 = doc->addNode("combine", "combine1", "vector2");
+    combine1->setConnectedNode("in1", swizzle1);
+    combine1->setInputValue("in2", 3.0f);
+    mx::NodePtr texcoord1 = doc->addNode("texcoord", "texcoord1", "vector2");
+    mx::NodePtr add1 = doc->addNode("add", "add1", "vector2");
+    add1->setConnectedNode("in1", texcoord1);
+    add1->setConnectedNode("in2", combine1);
+    mx::OutputPtr output = doc->addOutput("out", "vector2");
+    output->setConnectedNode(add1);
+
+    mx::ShaderGeneratorPtr shaderGenerator = mx::GlslShaderGenerator::create();
+    auto generate = [&](int shaderInterfaceType, int optimizationLevel)
+    {
+        mx::GenContext context(shaderGenerator);
+        context.registerSourceCodeSearchPath(searchPath);
+        context.getOptions().shaderInterfaceType = shaderInterfaceType;
+        context.getOptions().optimizationLevel = optimizationLevel;
+        mx::ShaderPtr shader = shaderGenerator->generate("shader", output, context);
+        REQUIRE(shader);
+        return shader;
+    };
+
+    // Literal nodes are folded into the inputs of the first node that
+    // depends on a non-literal value.
+    mx::ShaderPtr shader = generate(mx::SHADER_INTERFACE_REDUCED, mx::SHADER_OPTIMIZATION_CONSTANT_FOLDING);
+    const mx::ShaderGraph& graph = shader->getGraph();
+    REQUIRE(!graph.getNode("multiply1"));
+    REQUIRE(!graph.getNode("swizzle1"));
+    REQUIRE(!graph.getNode("combine1"));
+    const mx::ShaderNode* add = graph.getNode("add1");
+    REQUIRE(add);
+    REQUIRE(!add->getInput("in2")->getConnection());
+    REQUIRE(add->getInput("in2")->getValue()->asA<mx::Vector2>() == mx::Vector2(1.0f, 3.0f));
+
+    // Nodes are not folded at the basic optimization level.
+    shader = generate(mx::SHADER_INTERFACE_REDUCED, mx::SHADER_OPTIMIZATION_BASIC);
+    REQUIRE(shader->getGraph().getNode("multiply1"));
+    REQUIRE(shader->getGraph().getNode("combine1"));
+
+    // Nodes with inputs published as uniforms are not folded.
+    shader = generate(mx::SHADER_INTERFACE_COMPLETE, mx::SHADER_OPTIMIZATION_CONSTANT_FOLDING);
+    REQUIRE(shader->getGraph().getNode("multiply1"));
+    REQUIRE(shader->getGraph().getNode("combine1"));
+
+    // Each math node of the standard library is evaluated when folded.
+    struct FoldedNode
+    {
+        std::string category;
+        mx::Vector2 in1;
+        mx::Vector2 in2;
+        mx::Vector2 result;
+    };
+    const std::vector<FoldedNode> foldedNodes =
+    {
+        { "subtract", mx::Vector2(5.0f, 5.0f), mx::Vector2(2.0f, 1.0f), mx::Vector2(3.0f, 4.0f) },
+        { "divide", mx::Vector2(6.0f, 8.0f), mx::Vector2(2.0f, 4.0f), mx::Vector2(3.0f, 2.0f) },
+        { "min", mx::Vector2(1.0f, 5.0f), mx::Vector2(3.0f, 2.0f), mx::Vector2(1.0f, 2.0f) },
+        { "max", mx::Vector2(1.0f, 5.0f), mx::Vector2(3.0f, 2.0f), mx::Vector2(3.0f, 5.0f) },
+        { "invert", mx::Vector2(0.25f, 0.5f), mx::Vector2(), mx::Vector2(0.75f, 0.5f) },
+        { "absval", mx::Vector2(-1.0f, 2.0f), mx::Vector2(), mx::Vector2(1.0f, 2.0f) },
+        { "clamp", mx::Vector2(-1.0f, 2.0f), mx::Vector2(), mx::Vector2(0.0f, 1.0f) }
+    };
+    for (const FoldedNode& foldedNode : foldedNodes)
+    {
+        mx::NodePtr node = doc->addNode(foldedNode.category, "folded1", "vector2");
+        if (node->getNodeDef()->getInput("in1"))
+        {
+            node->setInputValue("in1", foldedNode.in1);
+            node->setInputValue("in2", foldedNode.in2);
+        }
+        else
+        {
+            node->setInputValue("in", foldedNode.in1);
+        }
+        add1->setConnectedNode("in2", node);
+        shader = generate(mx::SHADER_INTERFACE_REDUCED, mx::SHADER_OPTIMIZATION_CONSTANT_FOLDING);
+        REQUIRE(!shader->getGraph().getNode("folded1"));
+        const mx::ShaderInput* in2 = shader->getGraph().getNode("add1")->getInput("in2");
+        REQUIRE(!in2->getConnection());
+        REQUIRE(in2->getValue()->asA<mx::Vector2>() == foldedNode.result);
+        doc->removeNode(node->getName());
+    }
+
+    // Nodes of custom nodedefs sharing the node string of a standard node
+    // are not folded with standard semantics, even if their implementations
+    // are named like those of the standard library.
+    mx::NodeDefPtr customDef = doc->addNodeDef("ND_custom_multiply_vector2", "vector2", "multiply");
+    customDef->addInput("in1", "vector2");
+    customDef->addInput("in2", "vector2");
+    mx::NodeGraphPtr customGraph = doc->addNodeGraph("IM_multiply_vector2_custom");
+    customGraph->setNodeDef(customDef);
+    mx::NodePtr customAdd = customGraph->addNode("add", "add1", "vector2");
+    customAdd->addInput("in1", "vector2")->setInterfaceName("in1");
+    customAdd->addInput("in2", "vector2")->setInterfaceName("in2");
+    customGraph->addOutput("out", "vector2")->setConnectedNode(customAdd);
+    mx::NodePtr customMultiply = doc->addNode("multiply", "customMultiply1", "vector2");
+    customMultiply->setNodeDefString(customDef->getName());
+    customMultiply->setInputValue("in1", mx::Vector2(2.0f, 2.0f));
+    customMultiply->setInputValue("in2", mx::Vector2(3.0f, 3.0f));
+    add1->setConnectedNode("in2", customMultiply);
+    shader = generate(mx::SHADER_INTERFACE_REDUCED, mx::SHADER_OPTIMIZATION_CONSTANT_FOLDING);
+    REQUIRE(shader->getGraph().getNode("customMultiply1"));
+    REQUIRE(shader->getGraph().getNode("add1")->getInput("in2")->getConnection());
+}
+
+TEST_CASE("GenShader: Common Subexpression Elimination", "[genshader]")
+{
+    mx::FilePath searchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    mx::DocumentPtr doc = mx::createDocument();
+    GenShaderUtil::loadLibraries({ "stdlib" }, searchPath, doc);
+
+    // Two identical chains of nodes, combined by a final node.
+    std::vector<mx::NodePtr> chains;
+    for (const std::string& suffix : mx::StringVec{ "a", "b" })
+    {
+        mx::NodePtr texcoord = doc->addNode("texcoord", "texcoord_" + suffix, "vector2");
+        mx::NodePtr multiply = doc->addNode("multiply", "multiply_" + suffix, "vector2");
+        multiply->setConnectedNode("in1", texcoord);
+        multiply->setInputValue("in2", mx::Vector2(2.0f, 3.0f));
+        mx::NodePtr swizzle = doc->addNode("swizzle", "swizzle_" + suffix, "vector2");
+        swizzle->setConnectedNode("in", multiply);
+        swizzle->setParameterValue("channels", std::string("yx"));
+        chains.push_back(swizzle);
+    }
+    mx::NodePtr add1 = doc->addNode("add", "add1", "vector2");
+    add1->setConnectedNode("in1", chains[0]);
+    add1->setConnectedNode("in2", chains[1]);
+    mx::OutputPtr output = doc->addOutput("out", "vector2");
+    output->setConnectedNode(add1);
+
+    mx::ShaderGeneratorPtr shaderGenerator = mx::GlslShaderGenerator::create();
+    auto generate = [&](int shaderInterfaceType, int optimizationLevel)
+    {
+        mx::GenContext context(shaderGenerator);
+        context.registerSourceCodeSearchPath(searchPath);
+        context.getOptions().shaderInterfaceType = shaderInterfaceType;
+        context.getOptions().optimizationLevel = optimizationLevel;
+        mx::ShaderPtr shader = shaderGenerator->generate("shader", output, context);
+        REQUIRE(shader);
+        return shader;
+    };
+
+    // Each duplicate node is merged into the first identical node.
+    mx::ShaderPtr shader = generate(mx::SHADER_INTERFACE_REDUCED, mx::SHADER_OPTIMIZATION_COMMON_SUBEXPRESSIONS);
+    const mx::ShaderGraph& graph = shader->getGraph();
+    REQUIRE(graph.getNodes().size() == 4);
+    REQUIRE(!graph.getNode("texcoord_b"));
+    REQUIRE(!graph.getNode("multiply_b"));
+    REQUIRE(!graph.getNode("swizzle_b"));
+    const mx::ShaderNode* add = graph.getNode("add1");
+    REQUIRE(add);
+    REQUIRE(add->getInput("in1")->getConnection() == graph.getNode("swizzle_a")->getOutput());
+    REQUIRE(add->getInput("in2")->getConnection() == graph.getNode("swizzle_a")->getOutput());
+
+    // Nodes are not merged at lower optimization levels.
+    shader = generate(mx::SHADER_INTERFACE_REDUCED, mx::SHADER_OPTIMIZATION_CONSTANT_FOLDING);
+    REQUIRE(shader->getGraph().getNodes().size() == 7);
+
+    // Nodes with inputs published as uniforms are not merged.
+    shader = generate(mx::SHADER_INTERFACE_COMPLETE, mx::SHADER_OPTIMIZATION_COMMON_SUBEXPRESSIONS);
+    REQUIRE(shader->getGraph().getNode("multiply_b"));
+    REQUIRE(shader->getGraph().getNode("swizzle_b"));
+}
+
+TEST_CASE("GenShader: Shader Instancing", "[genshader]")
+{
+    mx::FilePath searchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    mx::DocumentPtr doc = mx::createDocument();
+    GenShaderUtil::loadLibraries({ "stdlib", "pbrlib", "bxdf" }, searchPath, doc);
+
+    // Two materials that differ only in values, and a third with a
+    // connected input.
+    std::vector<mx::ElementPtr> elements;
+    for (const std::string& name : mx::StringVec{ "M1", "M2", "M3" })
+    {
+        mx::MaterialPtr material = doc->addMaterial(name);
+        elements.push_back(material->addShaderRef("SR_" + name, "standard_surface"));
+    }
+    mx::ShaderRefPtr shaderRef1 = elements[0]->asA<mx::ShaderRef>();
+    mx::ShaderRefPtr shaderRef2 = elements[1]->asA<mx::ShaderRef>();
+    mx::ShaderRefPtr shaderRef3 = elements[2]->asA<mx::ShaderRef>();
+    shaderRef1->addBindInput("base", "float")->setValue(0.5f);
+    shaderRef2->addBindInput("base", "float")->setValue(0.9f);
+    shaderRef2->addBindInput("base_color", "color3")->setValue(mx::Color3(0.2f, 0.3f, 0.4f));
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph("NG_position");
+    mx::NodePtr position = nodeGraph->addNode("position", "position1", "vector3");
+    mx::NodePtr convert = nodeGraph->addNode("convert", "convert1", "color3");
+    convert->setConnectedNode("in", position);
+    mx::OutputPtr output = nodeGraph->addOutput("out", "color3");
+    output->setConnectedNode(convert);
+    shaderRef3->addBindInput("base_color", "color3")->setConnectedOutput(output);
+
+    mx::ShaderGeneratorPtr shaderGenerator = mx::GlslShaderGenerator::create();
+    mx::GenContext context(shaderGenerator);
+    context.registerSourceCodeSearchPath(searchPath);
+    std::vector<mx::ShaderInstance> instances = shaderGenerator->generateInstanced(elements, context, 1);
+    REQUIRE(instances.size() == 3);
+
+    // Materials that differ only in values share a shader, with their own
+    // uniform values.
+    REQUIRE(instances[0].signature == instances[1].signature);
+    REQUIRE(instances[0].shader == instances[1].shader);
+    REQUIRE(instances[0].shader->getName() == "SR_M1");
+    REQUIRE(instances[0].uniformValues.at("base")->asA<float>() == 0.5f);
+    REQUIRE(instances[1].uniformValues.at("base")->asA<float>() == 0.9f);
+    REQUIRE(instances[1].uniformValues.at("base_color")->asA<mx::Color3>() == mx::Color3(0.2f, 0.3f, 0.4f));
+    const mx::VariableBlock& publicUniforms = instances[1].shader->getStage(mx::Stage::PIXEL).getUniformBlock(mx::HW::PUBLIC_UNIFORMS);
+    REQUIRE(publicUniforms["base"]);
+
+    // Materials with different topology do not.
+    REQUIRE(instances[2].signature != instances[0].signature);
+    REQUIRE(instances[2].shader != instances[0].shader);
+
+    // The signature is independent of the uniform values.
+    mx::ShaderPtr shader = shaderGenerator->generate("shader", elements[1], context);
+    REQUIRE(shaderGenerator->getTopologySignature(*shader) == instances[0].signature);
+}
+
+TEST_CASE("GenShader: Uniform Specialization", "[genshader]")
+{
+    mx::FilePath searchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    mx::DocumentPtr doc = mx::createDocument();
+    GenShaderUtil::loadLibraries({ "stdlib", "pbrlib", "bxdf" }, searchPath, doc);
+
+    // A conditional node whose selector is computed from literal values.
+    mx::NodePtr multiply1 = doc->addNode("multiply", "multiply1", "float");
+    multiply1->setInputValue("in1", 0.5f);
+    multiply1->setInputValue("in2", 2.0f);
+    mx::NodePtr position1 = doc->addNode("position", "position1", "vector3");
+    mx::NodePtr convert1 = doc->addNode("convert", "convert1", "color3");
+    convert1->setConnectedNode("in", position1);
+    mx::NodePtr normal1 = doc->addNode("normal", "normal1", "vector3");
+    mx::NodePtr convert2 = doc->addNode("convert", "convert2", "color3");
+    convert2->setConnectedNode("in", normal1);
+    mx::NodePtr compare1 = doc->addNode("compare", "compare1", "color3");
+    compare1->setConnectedNode("intest", multiply1);
+    compare1->setParameterValue("cutoff", 0.5f);
+    compare1->setConnectedNode("in1", convert1);
+    compare1->setConnectedNode("in2", convert2);
+    mx::OutputPtr output = doc->addOutput("out", "color3");
+    output->setConnectedNode(compare1);
+
+    mx::ShaderRefPtr shaderRef = doc->addMaterial("M1")->addShaderRef("SR_M1", "standard_surface");
+    shaderRef->addBindInput("base", "float")->setValue(0.5f);
+
+    mx::ShaderGeneratorPtr shaderGenerator = mx::GlslShaderGenerator::create();
+    auto generate = [&](mx::ElementPtr element, int shaderInterfaceType, bool specializeUniforms, const mx::StringSet& dynamicUniforms)
+    {
+        mx::GenContext context(shaderGenerator);
+        context.registerSourceCodeSearchPath(searchPath);
+        context.getOptions().shaderInterfaceType = shaderInterfaceType;
+        context.getOptions().optimizationLevel = mx::SHADER_OPTIMIZATION_CONSTANT_FOLDING;
+        context.getOptions().specializeUniforms = specializeUniforms;
+        context.getOptions().dynamicUniforms = dynamicUniforms;
+        mx::ShaderPtr shader = shaderGenerator->generate("shader", element, context);
+        REQUIRE(shader);
+        return shader;
+    };
+    auto hasUniform = [](mx::ShaderPtr shader, const std::string& name)
+    {
+        return shader->getStage(mx::Stage::PIXEL).getUniformBlock(mx::HW::PUBLIC_UNIFORMS).find(name) != nullptr;
+    };
+
+    // Without specialization, node inputs are published and nothing is folded.
+    mx::ShaderPtr shader = generate(output, mx::SHADER_INTERFACE_COMPLETE, false, {});
+    REQUIRE(hasUniform(shader, "multiply1_in1"));
+    REQUIRE(shader->getGraph().getNode("multiply1"));
+    REQUIRE(shader->getGraph().getNode("compare1"));
+
+    // Specialized values are folded, and the conditional they select is
+    // bypassed along with its dead branch.
+    shader = generate(output, mx::SHADER_INTERFACE_COMPLETE, true, {});
+    REQUIRE(!hasUniform(shader, "multiply1_in1"));
+    REQUIRE(!hasUniform(shader, "multiply1_in2"));
+    REQUIRE(!shader->getGraph().getNode("multiply1"));
+    REQUIRE(!shader->getGraph().getNode("compare1"));
+    REQUIRE(!shader->getGraph().getNode("convert1"));
+    REQUIRE(shader->getGraph().getNode("convert2"));
+
+    // Uniforms in the allow-list remain published.
+    shader = generate(output, mx::SHADER_INTERFACE_COMPLETE, true, { "multiply1_in2" });
+    REQUIRE(!hasUniform(shader, "multiply1_in1"));
+    REQUIRE(hasUniform(shader, "multiply1_in2"));
+    REQUIRE(shader->getGraph().getNode("multiply1"));
+    REQUIRE(shader->getGraph().getNode("compare1"));
+
+    // Material bindings are specialized with a reduced interface.
+    shader = generate(shaderRef, mx::SHADER_INTERFACE_REDUCED, false, {});
+    REQUIRE(hasUniform(shader, "base"));
+    shader = generate(shaderRef, mx::SHADER_INTERFACE_REDUCED, true, {});
+    REQUIRE(!hasUniform(shader, "base"));
+    REQUIRE(!hasUniform(shader, "base_color"));
+    shader = generate(shaderRef, mx::SHADER_INTERFACE_REDUCED, true, { "base" });
+    REQUIRE(hasUniform(shader, "base"));
+    REQUIRE(!hasUniform(shader, "base_color"));
+
+    // Options are restored when the graph of a compound node fails to build.
+    mx::NodeDefPtr brokenDef = doc->addNodeDef("ND_broken_compound", "color3", "broken_compound");
+    mx::NodeGraphPtr brokenGraph = doc->addNodeGraph("NG_broken_compound");
+    brokenGraph->setNodeDef(brokenDef);
+    mx::NodePtr unknown = brokenGraph->addNode("unknown_node", "unknown1", "color3");
+    brokenGraph->addOutput("out", "color3")->setConnectedNode(unknown);
+    mx::NodePtr broken1 = doc->addNode("broken_compound", "broken1", "color3");
+    mx::OutputPtr brokenOutput = doc->addOutput("brokenOut", "color3");
+    brokenOutput->setConnectedNode(broken1);
+    mx::GenContext context(shaderGenerator);
+    context.registerSourceCodeSearchPath(searchPath);
+    context.getOptions().shaderInterfaceType = mx::SHADER_INTERFACE_COMPLETE;
+    context.getOptions().specializeUniforms = true;
+    REQUIRE_THROWS(shaderGenerator->generate("shader", brokenOutput, context));
+    REQUIRE(context.getOptions().shaderInterfaceType == mx::SHADER_INTERFACE_COMPLETE);
+    REQUIRE(context.getOptions().specializeUniforms);
+}
+
+TEST_CASE("GenShader: Compound Graph Registry", "[genshader]")
+{
+    mx::FilePath searchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+
+    // Two documents with node graph implementations of the same name and
+    // interface, but different content.
+    std::vector<mx::DocumentPtr> docs;
+    std::vector<mx::OutputPtr> outputs;
+    for (float scale : { 2.0f, 3.0f })
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        docs.push_back(doc);
+        GenShaderUtil::loadLibraries({ "stdlib" }, searchPath, doc);
+        mx::NodeDefPtr nodeDef = doc->addNodeDef("ND_scale_float", "float", "scale");
+        nodeDef->addInput("in", "float");
+        mx::NodeGraphPtr nodeGraph = doc->addNodeGraph("NG_scale_float");
+        nodeGraph->setNodeDef(nodeDef);
+        mx::NodePtr multiply = nodeGraph->addNode("multiply", "multiply1", "float");
+        multiply->addInput("in1", "float")->setInterfaceName("in");
+        multiply->setInputValue("in2", scale);
+        nodeGraph->addOutput("out", "float")->setConnectedNode(multiply);
+        mx::NodePtr scaleNode = doc->addNode("scale", "scale1", "float");
+        scaleNode->setInputValue("in", 0.5f);
+        mx::OutputPtr output = doc->addOutput("out", "float");
+        output->setConnectedNode(scaleNode);
+        outputs.push_back(output);
+    }
+
+    mx::ShaderGeneratorPtr shaderGenerator = mx::GlslShaderGenerator::create();
+    mx::ShaderGraphRegistryPtr registry = shaderGenerator->getGraphRegistry();
+    REQUIRE(registry);
+    registry->clear();
+
+    // Contexts attached to the registry share the graphs of compound
+    // implementations, while their implementations remain their own.
+    const std::string implName = "NG_scale_float";
+    mx::GenContext context1(shaderGenerator);
+    context1.registerSourceCodeSearchPath(searchPath);
+    context1.setGraphRegistry(registry);
+    mx::ShaderPtr shader1 = shaderGenerator->generate("shader", outputs[0], context1);
+    REQUIRE(shader1);
+    REQUIRE(registry->size() == 1);
+    mx::GenContext context2(shaderGenerator);
+    context2.registerSourceCodeSearchPath(searchPath);
+    context2.setGraphRegistry(registry);
+    mx::ShaderPtr shader2 = shaderGenerator->generate("shader", outputs[0], context2);
+    REQUIRE(shader2);
+    REQUIRE(registry->size() == 1);
+    mx::ShaderNodeImplPtr impl1 = context1.findNodeImplementation(implName);
+    mx::ShaderNodeImplPtr impl2 = context2.findNodeImplementation(implName);
+    REQUIRE(impl1 != impl2);
+    REQUIRE(impl1->getGraph() == impl2->getGraph());
+    REQUIRE(impl1->getHash() == impl2->getHash());
+    REQUIRE(shader1->getSourceCode(mx::Stage::PIXEL) == shader2->getSourceCode(mx::Stage::PIXEL));
+
+    // Node graphs of the same name with different content are not shared.
+    mx::GenContext context3(shaderGenerator);
+    context3.registerSourceCodeSearchPath(searchPath);
+    context3.setGraphRegistry(registry);
+    mx::ShaderPtr shader3 = shaderGenerator->generate("shader", outputs[1], context3);
+    REQUIRE(shader3);
+    REQUIRE(registry->size() == 2);
+    REQUIRE(context3.findNodeImplementation(implName)->getGraph() != impl1->getGraph());
+    REQUIRE(shader3->getSourceCode(mx::Stage::PIXEL) != shader1->getSourceCode(mx::Stage::PIXEL));
+
+    // Contexts without a registry build their own graphs.
+    mx::GenContext context4(shaderGenerator);
+    context4.registerSourceCodeSearchPath(searchPath);
+    REQUIRE(shaderGenerator->generate("shader", outputs[0], context4));
+    REQUIRE(registry->size() == 2);
+    REQUIRE(context4.findNodeImplementation(implName)->getGraph() != impl1->getGraph());
+
+    // File textures inside shared graphs keep their filenames, so every
+    // shader generated from them has the same texture uniforms.
+    const std::string filename = "resources/Images/grid.png";
+    mx::DocumentPtr textureDoc = mx::createDocument();
+    docs.push_back(textureDoc);
+    GenShaderUtil::loadLibraries({ "stdlib" }, searchPath, textureDoc);
+    mx::NodeDefPtr gridDef = textureDoc->addNodeDef("ND_grid_color3", "color3", "grid");
+    mx::NodeGraphPtr gridGraph = textureDoc->addNodeGraph("NG_grid_color3");
+    gridGraph->setNodeDef(gridDef);
+    mx::NodePtr tiledImage = gridGraph->addNode("tiledimage", "tiledimage1", "color3");
+    tiledImage->setParameterValue("file", filename, mx::FILENAME_TYPE_STRING);
+    gridGraph->addOutput("out", "color3")->setConnectedNode(tiledImage);
+    mx::OutputPtr textureOutput = textureDoc->addOutput("out", "color3");
+    textureOutput->setConnectedNode(textureDoc->addNode("grid", "grid1", "color3"));
+    auto getFilenameUniforms = [](mx::ShaderPtr shader)
+    {
+        std::vector<std::string> values;
+        const mx::VariableBlock& uniforms = shader->getStage(mx::Stage::PIXEL).getUniformBlock(mx::HW::PUBLIC_UNIFORMS);
+        for (size_t i = 0; i < uniforms.size(); i++)
+        {
+            if (uniforms[i]->getType() == mx::Type::FILENAME)
+            {
+                values.push_back(uniforms[i]->getValue() ? uniforms[i]->getValue()->getValueString() : mx::EMPTY_STRING);
+            }
+        }
+        return values;
+    };
+    std::vector<std::string> textureUniforms;
+    for (int i = 0; i < 2; i++)
+    {
+        mx::GenContext context(shaderGenerator);
+        context.registerSourceCodeSearchPath(searchPath);
+        context.setGraphRegistry(registry);
+        mx::ShaderPtr shader = shaderGenerator->generate("shader", textureOutput, context);
+        REQUIRE(shader);
+        if (i == 0)
+        {
+            textureUniforms = getFilenameUniforms(shader);
+        }
+        else
+        {
+            REQUIRE(getFilenameUniforms(shader) == textureUniforms);
+        }
+    }
+    REQUIRE(textureUniforms == std::vector<std::string>{ filename });
+
+    // Graphs depending on an edited source file are not shared.
+    mx::FilePath sourcePath = mx::FilePath::getCurrentPath() / mx::FilePath("compound_graph_registry.glsl");
+    std::ofstream(sourcePath.asString()) << "void mx_offset_float(float in, out float result) { result = in + 1.0; }\n";
+    GenShaderUtil::setModificationTime(sourcePath, 1000000);
+    mx::DocumentPtr doc = docs[0];
+    mx::NodeDefPtr offsetDef = doc->addNodeDef("ND_offset_float", "float", "offset");
+    offsetDef->addInput("in", "float");
+    mx::ImplementationPtr offsetImpl = doc->addImplementation("IM_offset_float_genglsl");
+    offsetImpl->setNodeDef(offsetDef);
+    offsetImpl->setFile(sourcePath.asString());
+    offsetImpl->setFunction("mx_offset_float");
+    offsetImpl->setLanguage(mx::GlslShaderGenerator::LANGUAGE);
+    mx::NodeGraphPtr nodeGraph = doc->getNodeGraph(implName);
+    mx::NodePtr offset = nodeGraph->addNode("offset", "offset1", "float");
+    offset->setConnectedNode("in", nodeGraph->getNode("multiply1"));
+    nodeGraph->getOutput("out")->setConnectedNode(offset);
+    auto generateWithRegistry = [&]()
+    {
+        mx::GenContext context(shaderGenerator);
+        context.registerSourceCodeSearchPath(searchPath);
+        context.setGraphRegistry(registry);
+        REQUIRE(shaderGenerator->generate("shader", outputs[0], context));
+        return context.findNodeImplementation(implName)->getGraph();
+    };
+    registry->clear();
+    mx::ShaderGraph* graph1 = generateWithRegistry();
+    REQUIRE(generateWithRegistry() == graph1);
+    std::ofstream(sourcePath.asString()) << "void mx_offset_float(float in, out float result) { result = in + 2.0; }\n";
+    GenShaderUtil::setModificationTime(sourcePath, 2000000);
+    REQUIRE(generateWithRegistry() != graph1);
+    REQUIRE(registry->size() == 2);
+    std::remove(sourcePath.asString().c_str());
+
+    // Clearing the shared implementations of a context clears its registries.
+    context1.clearSharedImplementations();
+    REQUIRE(registry->size() == 0);
+    REQUIRE(!context1.findNodeImplementation(implName));
+}
+
+// Writes the shaders generated for the test suite to files, for comparison
+// between separate processes by the MaterialXTestDeterminism test.  The
+// output directory is given by the MATERIALX_GENERATED_SHADER_PATH
+// environment variable.  If MATERIALX_GENERATED_SHADER_REVERSE is set, the
+// shaders are generated in reverse order, so that the memory layout of the
+// process differs between runs.
+TEST_CASE("GenShader: Write Test Suite Shaders", "[.determinism]")
+{
+    const char* outputPath = std::getenv("MATERIALX_GENERATED_SHADER_PATH");
+    REQUIRE(outputPath);
+    const bool reverse = std::getenv("MATERIALX_GENERATED_SHADER_REVERSE") != nullptr;
+
+    mx::FilePath searchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    mx::DocumentPtr libraries = mx::createDocument();
+    GenShaderUtil::loadLibraries({ "stdlib", "pbrlib", "bxdf" }, searchPath, libraries);
+
+    mx::FilePath testSuitePath = mx::FilePath::getCurrentPath() / mx::FilePath("resources/Materials/TestSuite");
+    std::vector<mx::TypedElementPtr> elements;
+    std::vector<mx::DocumentPtr> docs = GenShaderUtil::loadRenderableElements(testSuitePath, libraries, elements);
+    REQUIRE(!elements.empty());
+
+    for (mx::ShaderGeneratorPtr shaderGenerator : { mx::GlslShaderGenerator::create(), mx::OslShaderGenerator::create() })
+    {
+        mx::GenContext context(shaderGenerator);
+        context.registerSourceCodeSearchPath(searchPath);
+        std::vector<std::string> results(elements.size());
+        for (size_t n = 0; n < elements.size(); n++)
+        {
+            size_t index = reverse ? elements.size() - n - 1 : n;
+            mx::TypedElementPtr elem = elements[index];
+            std::string& result = results[index];
+            result = "// " + elem->getNamePath() + "\n";
+            try
+            {
+                mx::ShaderPtr shader = shaderGenerator->generate(elem->getName(), elem, context);
+                for (size_t i = 0; i < shader->numStages(); i++)
+                {
+                    result += shader->getStage(i).getSourceCode() + "\n";
+                }
+            }
+            catch (mx::Exception& e)
+            {
+                result += std::string(e.what()) + "\n";
+            }
+        }
+
+        mx::FilePath filePath = mx::FilePath(outputPath) / mx::FilePath(shaderGenerator->getLanguage() + ".txt");
+        std::ofstream file(filePath.asString());
+        REQUIRE(file);
+        for (const std::string& result : results)
+        {
+            file << result;
+        }
+    }
+}
+
+//
+// Benchmarks
+//
+
+TEST_CASE("GenShader: Implementation Lookup Benchmark", "[.benchmark]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+
+    mx::FilePath searchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    GenShaderUtil::loadLibraries({ "stdlib" }, searchPath, doc);
+
+    const std::vector<std::pair<std::string, std::string>> targetsAndLanguages =
+    {
+        { mx::GlslShaderGenerator::TARGET, mx::GlslShaderGenerator::LANGUAGE },
+        { mx::OslShaderGenerator::TARGET, mx::OslShaderGenerator::LANGUAGE }
+    };
+    const std::vector<mx::NodeDefPtr> nodeDefs = doc->getNodeDefs();
+    const size_t passCount = 20;
+
+    for (const auto& targetAndLanguage : targetsAndLanguages)
+    {
+        const std::string& target = targetAndLanguage.first;
+        const std::string& language = targetAndLanguage.second;
+
+        // The first pass populates the document's lookup table.
+        std::vector<mx::InterfaceElementPtr> firstResults;
+        auto startTime = std::chrono::steady_clock::now();
+        for (mx::NodeDefPtr nodeDef : nodeDefs)
+        {
+            firstResults.push_back(nodeDef->getImplementation(target, language));
+        }
+        std::chrono::duration<double> coldTime = std::chrono::steady_clock::now() - startTime;
+
+        // Subsequent passes are answered from the lookup table.
+        startTime = std::chrono::steady_clock::now();
+        for (size_t pass = 0; pass < passCount; pass++)
+        {
+            for (size_t i = 0; i < nodeDefs.size(); i++)
+            {
+                REQUIRE(nodeDefs[i]->getImplementation(target, language) == firstResults[i]);
+            }
+        }
+        std::chrono::duration<double> warmTime = (std::chrono::steady_clock::now() - startTime) / (double) passCount;
+
+        std::cout << "Implementation lookups for " << nodeDefs.size() << " nodedefs (" << language << "): " <<
+            "cold " << coldTime.count() * 1000.0 << " ms, warm " << warmTime.count() * 1000.0 << " ms" << std::endl;
+    }
+}
+
+TEST_CASE("GenShader: Shader Cache Benchmark", "[.benchmark]")
+{
+    mx::FilePath searchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    mx::DocumentPtr libraries = mx::createDocument();
+    GenShaderUtil::loadLibraries({ "stdlib", "pbrlib", "bxdf" }, searchPath, libraries);
+
+    // Gather the renderable elements of the standard_surface examples.
+    mx::FilePath materialsPath = mx::FilePath::getCurrentPath() / mx::FilePath("resources/Materials/Examples/StandardSurface");
+    std::vector<mx::TypedElementPtr> elements;
+    std::vector<mx::DocumentPtr> docs = GenShaderUtil::loadRenderableElements(materialsPath, libraries, elements);
+
+    mx::GenContext context(mx::GlslShaderGenerator::create());
+    context.registerSourceCodeSearchPath(searchPath);
+    mx::FilePath cachePath = mx::FilePath::getCurrentPath() / mx::FilePath("shadercache_benchmark");
+    mx::DirectoryShaderCacheBackendPtr directory = mx::DirectoryShaderCacheBackend::create(cachePath);
+    directory->clear();
+    mx::ShaderCachePtr memoryCache = mx::ShaderCache::create(mx::MemoryShaderCacheBackend::create());
+    mx::ShaderCachePtr directoryCache = mx::ShaderCache::create(directory);
+
+    auto generateAll = [&](mx::ShaderCachePtr cache)
+    {
+        auto startTime = std::chrono::steady_clock::now();
+        for (mx::TypedElementPtr elem : elements)
+        {
+            mx::ShaderPtr shader = cache ? cache->generate(elem->getName(), elem, context) :
+                                           context.getShaderGenerator().generate(elem->getName(), elem, context);
+            REQUIRE(shader);
+        }
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    };
+
+    double uncachedMs = generateAll(nullptr);
+    double memoryMissMs = generateAll(memoryCache);
+    double memoryHitMs = generateAll(memoryCache);
+    double directoryMissMs = generateAll(directoryCache);
+    double directoryHitMs = generateAll(directoryCache);
+    for (mx::ShaderCachePtr cache : { memoryCache, directoryCache })
+    {
+        mx::ShaderCacheStats stats = cache->getStats();
+        REQUIRE(stats.hits + stats.misses == 2 * elements.size());
+        REQUIRE(stats.hits >= elements.size());
+    }
+    directory->clear();
+
+    std::cout << "Shader cache with " << elements.size() << " shaders:" << std::endl;
+    std::cout << "    uncached generation: " << uncachedMs << " ms" << std::endl;
+    std::cout << "    memory backend: " << memoryMissMs << " ms on miss, " << memoryHitMs << " ms on hit" << std::endl;
+    std::cout << "    directory backend: " << directoryMissMs << " ms on miss, " << directoryHitMs << " ms on hit" << std::endl;
+}
+
+TEST_CASE("GenShader: Parallel Generation Benchmark", "[.benchmark]")
+{
+    mx::FilePath searchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    mx::DocumentPtr libraries = mx::createDocument();
+    GenShaderUtil::loadLibraries({ "stdlib", "pbrlib", "bxdf" }, searchPath, libraries);
+
+    // Gather the renderable elements of the test suite.
+    mx::FilePath testSuitePath = mx::FilePath::getCurrentPath() / mx::FilePath("resources/Materials/TestSuite");
+    std::vector<mx::TypedElementPtr> renderables;
+    std::vector<mx::DocumentPtr> docs = GenShaderUtil::loadRenderableElements(testSuitePath, libraries, renderables);
+    mx::ShaderGeneratorPtr shaderGenerator = mx::GlslShaderGenerator::create();
+    std::vector<mx::ElementPtr> elements;
+    {
+        // Skip elements that cannot be generated serially.
+        mx::GenContext context(shaderGenerator);
+        context.registerSourceCodeSearchPath(searchPath);
+        for (mx::TypedElementPtr elem : renderables)
+        {
+            try
+            {
+                shaderGenerator->generate(elem->getName(), elem, context);
+                elements.push_back(elem);
+            }
+            catch (mx::Exception&)
+            {
+            }
+        }
+    }
+    REQUIRE(!elements.empty());
+
+    std::cout << "Parallel generation of " << elements.size() << " test suite shaders, with " <<
+                 std::thread::hardware_concurrency() << " hardware threads:" << std::endl;
+    for (unsigned int threadCount : { 1, 2, 4, 8, 16, 32 })
+    {
+        mx::GenContext context(shaderGenerator);
+        context.registerSourceCodeSearchPath(searchPath);
+        auto startTime = std::chrono::steady_clock::now();
+        std::vector<mx::ShaderPtr> shaders = shaderGenerator->generateAll(elements, context, threadCount);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+        REQUIRE(shaders.size() == elements.size());
+        std::cout << "    " << threadCount << " threads: " << ms << " ms" << std::endl;
+    }
+}
+
+TEST_CASE("GenShader: Implementation Registry Benchmark", "[.benchmark]")
+{
+    mx::FilePath searchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    mx::DocumentPtr libraries = mx::createDocument();
+    GenShaderUtil::loadLibraries({ "stdlib", "pbrlib", "bxdf" }, searchPath, libraries);
+
+    // Gather the renderable elements of the standard_surface examples.
+    mx::FilePath materialsPath = mx::FilePath::getCurrentPath() / mx::FilePath("resources/Materials/Examples/StandardSurface");
+    std::vector<mx::TypedElementPtr> elements;
+    std::vector<mx::DocumentPtr> docs = GenShaderUtil::loadRenderableElements(materialsPath, libraries, elements);
+    REQUIRE(!elements.empty());
+
+    // Each request generates one shader with a new context.
+    mx::ShaderGeneratorPtr shaderGenerator = mx::GlslShaderGenerator::create();
+    mx::ShaderNodeImplRegistryPtr registry = shaderGenerator->getImplementationRegistry();
+    auto generateRequest = [&](mx::TypedElementPtr elem, bool useRegistry)
+    {
+        auto startTime = std::chrono::steady_clock::now();
+        mx::GenContext context(shaderGenerator);
+        context.registerSourceCodeSearchPath(searchPath);
+        if (useRegistry)
+        {
+            context.setImplementationRegistry(registry);
+        }
+        REQUIRE(shaderGenerator->generate(elem->getName(), elem, context));
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    };
+
+    for (bool useRegistry : { false, true })
+    {
+        registry->clear();
+        double firstMs = generateRequest(elements[0], useRegistry);
+        double steadyMs = 0.0;
+        for (mx::TypedElementPtr elem : elements)
+        {
+            steadyMs += generateRequest(elem, useRegistry);
+        }
+        std::cout << (useRegistry ? "With" : "Without") << " implementation registry:" << std::endl;
+        std::cout << "    first request: " << firstMs << " ms" << std::endl;
+        std::cout << "    steady state: " << steadyMs / elements.size() << " ms per request" << std::endl;
+    }
+    registry->clear();
+}
+
+TEST_CASE("GenShader: Graph Optimization Benchmark", "[.benchmark]")
+{
+    mx::FilePath searchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    mx::DocumentPtr libraries = mx::createDocument();
+    GenShaderUtil::loadLibraries({ "stdlib", "pbrlib", "bxdf" }, searchPath, libraries);
+
+    // Gather the renderable elements of the test suite.
+    mx::FilePath testSuitePath = mx::FilePath::getCurrentPath() / mx::FilePath("resources/Materials/TestSuite");
+    std::vector<mx::TypedElementPtr> elements;
+    std::vector<mx::DocumentPtr> docs = GenShaderUtil::loadRenderableElements(testSuitePath, libraries, elements);
+    REQUIRE(!elements.empty());
+
+    // Warm the source file cache before timing generation.
+    mx::ShaderGeneratorPtr shaderGenerator = mx::GlslShaderGenerator::create();
+    {
+        mx::GenContext context(shaderGenerator);
+        context.registerSourceCodeSearchPath(searchPath);
+        for (mx::TypedElementPtr elem : elements)
+        {
+            try
+            {
+                shaderGenerator->generate(elem->getName(), elem, context);
+            }
+            catch (mx::Exception&)
+            {
+            }
+        }
+    }
+
+    // Count the nodes and the pixel stage source lines of the shaders
+    // generated with a reduced interface, at each optimization level.
+    const std::vector<std::pair<int, std::string>> levels =
+    {
+        { mx::SHADER_OPTIMIZATION_BASIC, "Basic" },
+        { mx::SHADER_OPTIMIZATION_CONSTANT_FOLDING, "Constant folding" },
+        { mx::SHADER_OPTIMIZATION_COMMON_SUBEXPRESSIONS, "Common subexpression" }
+    };
+    std::vector<size_t> basicNodeCounts(elements.size(), 0);
+    for (const auto& level : levels)
+    {
+        mx::GenContext context(shaderGenerator);
+        context.registerSourceCodeSearchPath(searchPath);
+        context.getOptions().shaderInterfaceType = mx::SHADER_INTERFACE_REDUCED;
+        context.getOptions().optimizationLevel = level.first;
+        size_t shaderCount = 0;
+        size_t nodeCount = 0;
+        size_t lineCount = 0;
+        std::vector<std::string> reducedShaders;
+        auto startTime = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < elements.size(); i++)
+        {
+            mx::TypedElementPtr elem = elements[i];
+            try
+            {
+                mx::ShaderPtr shader = shaderGenerator->generate(elem->getName(), elem, context);
+                const std::string& source = shader->getSourceCode(mx::Stage::PIXEL);
+                size_t shaderNodeCount = shader->getGraph().getNodes().size();
+                if (level.first == mx::SHADER_OPTIMIZATION_BASIC)
+                {
+                    basicNodeCounts[i] = shaderNodeCount;
+                }
+                else if (shaderNodeCount < basicNodeCounts[i])
+                {
+                    reducedShaders.push_back(elem->getNamePath() + ": " +
+                                             std::to_string(basicNodeCounts[i] - shaderNodeCount) + " nodes removed");
+                }
+                shaderCount++;
+                nodeCount += shaderNodeCount;
+                lineCount += std::count(source.begin(), source.end(), '\n');
+            }
+            catch (mx::Exception&)
+            {
+            }
+        }
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+        std::cout << level.second << " optimization of " << shaderCount << " test suite shaders:" << std::endl;
+        std::cout << "    graph nodes: " << nodeCount << std::endl;
+        std::cout << "    pixel stage lines: " << lineCount << std::endl;
+        std::cout << "    generation time: " << ms << " ms" << std::endl;
+        for (const std::string& reducedShader : reducedShaders)
+        {
+            std::cout << "    " << reducedShader << std::endl;
+        }
+    }
+}
+
+TEST_CASE("GenShader: Shader Instancing Benchmark", "[.benchmark]")
+{
+    mx::FilePath searchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    mx::DocumentPtr libraries = mx::createDocument();
+    GenShaderUtil::loadLibraries({ "stdlib", "pbrlib", "bxdf" }, searchPath, libraries);
+
+    for (const std::string& materialsDir : mx::StringVec{ "resources/Materials/TestSuite", "resources/Materials/Examples" })
+    {
+        // Gather the renderable elements that can be generated.
+        mx::FilePath materialsPath = mx::FilePath::getCurrentPath() / mx::FilePath(materialsDir);
+        std::vector<mx::TypedElementPtr> renderables;
+        std::vector<mx::DocumentPtr> docs = GenShaderUtil::loadRenderableElements(materialsPath, libraries, renderables);
+        for (mx::ShaderGeneratorPtr shaderGenerator : { mx::GlslShaderGenerator::create(), mx::OslShaderGenerator::create() })
+        {
+            mx::GenContext context(shaderGenerator);
+            context.registerSourceCodeSearchPath(searchPath);
+            std::vector<mx::ElementPtr> elements;
+            for (mx::TypedElementPtr elem : renderables)
+            {
+                try
+                {
+                    shaderGenerator->generate(elem->getName(), elem, context);
+                    elements.push_back(elem);
+                }
+                catch (mx::Exception&)
+                {
+                }
+            }
+            REQUIRE(!elements.empty());
+
+            auto startTime = std::chrono::steady_clock::now();
+            std::vector<mx::ShaderInstance> instances = shaderGenerator->generateInstanced(elements, context);
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+            std::set<mx::ShaderPtr> sharedShaders;
+            for (const mx::ShaderInstance& instance : instances)
+            {
+                sharedShaders.insert(instance.shader);
+            }
+            std::cout << "Instanced " << shaderGenerator->getLanguage() << " generation of " << materialsDir << ":" << std::endl;
+            std::cout << "    elements: " << instances.size() << std::endl;
+            std::cout << "    shared shaders: " << sharedShaders.size() << std::endl;
+            std::cout << "    generation time: " << ms << " ms" << std::endl;
+        }
+    }
+}
+
+TEST_CASE("GenShader: Uniform Specialization Benchmark", "[.benchmark]")
+{
+    mx::FilePath searchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    mx::DocumentPtr libraries = mx::createDocument();
+    GenShaderUtil::loadLibraries({ "stdlib", "pbrlib", "bxdf" }, searchPath, libraries);
+
+    // Gather the renderable elements of the test suite.
+    mx::FilePath testSuitePath = mx::FilePath::getCurrentPath() / mx::FilePath("resources/Materials/TestSuite");
+    std::vector<mx::TypedElementPtr> elements;
+    std::vector<mx::DocumentPtr> docs = GenShaderUtil::loadRenderableElements(testSuitePath, libraries, elements);
+    REQUIRE(!elements.empty());
+
+    // Count the public uniforms, nodes and pixel stage source lines of the
+    // shaders generated with a complete interface and constant folding,
+    // with and without uniform specialization.
+    mx::ShaderGeneratorPtr shaderGenerator = mx::GlslShaderGenerator::create();
+    for (bool specializeUniforms : { false, true })
+    {
+        mx::GenContext context(shaderGenerator);
+        context.registerSourceCodeSearchPath(searchPath);
+        context.getOptions().optimizationLevel = mx::SHADER_OPTIMIZATION_CONSTANT_FOLDING;
+        context.getOptions().specializeUniforms = specializeUniforms;
+        size_t shaderCount = 0;
+        size_t uniformCount = 0;
+        size_t nodeCount = 0;
+        size_t lineCount = 0;
+        auto startTime = std::chrono::steady_clock::now();
+        for (mx::TypedElementPtr elem : elements)
+        {
+            try
+            {
+                mx::ShaderPtr shader = shaderGenerator->generate(elem->getName(), elem, context);
+                const std::string& source = shader->getSourceCode(mx::Stage::PIXEL);
+                shaderCount++;
+                uniformCount += shader->getStage(mx::Stage::PIXEL).getUniformBlock(mx::HW::PUBLIC_UNIFORMS).size();
+                nodeCount += shader->getGraph().getNodes().size();
+                lineCount += std::count(source.begin(), source.end(), '\n');
+            }
+            catch (mx::Exception&)
+            {
+            }
+        }
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+        std::cout << (specializeUniforms ? "Specialized" : "Dynamic") << " uniforms in " << shaderCount << " test suite shaders:" << std::endl;
+        std::cout << "    public uniforms: " << uniformCount << std::endl;
+        std::cout << "    graph nodes: " << nodeCount << std::endl;
+        std::cout << "    pixel stage lines: " << lineCount << std::endl;
+        std::cout << "    generation time: " << ms << " ms" << std::endl;
+    }
+}
+
+TEST_CASE("GenShader: Compound Graph Registry Benchmark", "[.benchmark]")
+{
+    mx::FilePath searchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    mx::DocumentPtr doc = mx::createDocument();
+    GenShaderUtil::loadLibraries({ "stdlib", "pbrlib", "bxdf" }, searchPath, doc);
+    mx::NodePtr shaderNode = doc->addNode("standard_surface", "surface1", "surfaceshader");
+    mx::OutputPtr output = doc->addOutput("out", "surfaceshader");
+    output->setConnectedNode(shaderNode);
+
+    // Generate a shader in a series of new contexts, with the graphs of
+    // compound implementations rebuilt for each context or shared.
+    const size_t contextCount = 50;
+    mx::ShaderGeneratorPtr shaderGenerator = mx::GlslShaderGenerator::create();
+    mx::ShaderGraphRegistryPtr registry = shaderGenerator->getGraphRegistry();
+    for (bool shareGraphs : { false, true })
+    {
+        registry->clear();
+        auto startTime = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < contextCount; i++)
+        {
+            mx::GenContext context(shaderGenerator);
+            context.registerSourceCodeSearchPath(searchPath);
+            if (shareGraphs)
+            {
+                context.setGraphRegistry(registry);
+            }
+            REQUIRE(shaderGenerator->generate("shader", output, context));
+        }
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+        std::cout << (shareGraphs ? "Shared" : "Rebuilt") << " compound graphs in " << contextCount << " contexts:" << std::endl;
+        std::cout << "    registered graphs: " << registry->size() << std::endl;
+        std::cout << "    generation time: " << ms << " ms" << std::endl;
+    }
+    registry->clear();
+}
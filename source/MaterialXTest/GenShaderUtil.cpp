@@ -12,6 +12,13 @@
 
 #include <MaterialXFormat/File.h>
 
+#if defined(_WIN32)
+#include <sys/types.h>
+#include <sys/utime.h>
+#else
+#include <utime.h>
+#endif
+
 namespace mx = MaterialX;
 
 namespace GenShaderUtil
@@ -47,6 +54,48 @@ void loadLibraries(const mx::StringVec& libraryNames,
     }
 }
 
+void setModificationTime(const mx::FilePath& file, time_t time)
+{
+#if defined(_WIN32)
+    struct _utimbuf times;
+    times.actime = time;
+    times.modtime = time;
+    REQUIRE(_utime(file.asString().c_str(), &times) == 0);
+#else
+    struct utimbuf times;
+    times.actime = time;
+    times.modtime = time;
+    REQUIRE(utime(file.asString().c_str(), &times) == 0);
+#endif
+}
+
+std::vector<mx::DocumentPtr> loadRenderableElements(const mx::FilePath& path,
+                                                    mx::DocumentPtr libraries,
+                                                    std::vector<mx::TypedElementPtr>& elements)
+{
+    std::vector<mx::DocumentPtr> docs;
+    mx::StringVec docPaths, errors;
+    mx::loadDocuments(path, mx::StringSet(), mx::StringSet(), docs, docPaths, errors);
+
+    mx::XmlReadOptions importOptions;
+    importOptions.skipDuplicateElements = true;
+    for (mx::DocumentPtr doc : docs)
+    {
+        doc->importLibrary(libraries, &importOptions);
+        std::vector<mx::TypedElementPtr> renderables;
+        try
+        {
+            mx::findRenderableElements(doc, renderables);
+        }
+        catch (mx::Exception&)
+        {
+            continue;
+        }
+        elements.insert(elements.end(), renderables.begin(), renderables.end());
+    }
+    return docs;
+}
+
 bool getShaderSource(mx::GenContext& context,
                     const mx::ImplementationPtr implementation,
                     mx::FilePath& sourcePath,
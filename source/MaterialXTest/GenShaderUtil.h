@@ -17,6 +17,7 @@
 #include <MaterialXGenShader/Util.h>
 
 #include <cstdlib>
+#include <ctime>
 #include <fstream>
 #include <iostream>
 
@@ -36,6 +37,22 @@ void loadLibraries(const mx::StringVec& libraryNames,
                     const mx::FilePath& searchPath,
                     mx::DocumentPtr doc,
                     const mx::StringSet* excludeFiles = nullptr);
+
+//
+// Set the modification time of a file, in seconds since the epoch, so that
+// tests may change it without waiting for the file system clock
+//
+void setModificationTime(const mx::FilePath& file, time_t time);
+
+//
+// Load the documents below a given path, import the given libraries into
+// them, and append their renderable elements.  Documents whose renderable
+// elements cannot be found are skipped.  Returns the loaded documents,
+// which own the elements.
+//
+std::vector<mx::DocumentPtr> loadRenderableElements(const mx::FilePath& path,
+                                                    mx::DocumentPtr libraries,
+                                                    std::vector<mx::TypedElementPtr>& elements);
     
 //
 // Get source content, source path and resolved paths for
@@ -7,6 +7,9 @@
 
 #include <MaterialXCore/Document.h>
 
+#include <chrono>
+#include <iostream>
+
 namespace mx = MaterialX;
 
 TEST_CASE("Geom strings", "[geom]")
@@ -53,6 +56,28 @@ TEST_CASE("Geom elements", "[geom]")
     REQUIRE(fileParam->getResolvedValue(resolver1)->asA<std::string>() == "folder/robot01_diffuse_1001.tif");
     REQUIRE(fileParam->getResolvedValue(resolver2)->asA<std::string>() == "folder/robot02_diffuse_1002.tif");
 
+    // Test shared string resolvers, which are cached by the document.
+    mx::ConstStringResolverPtr shared1 = image->getStringResolver("/robot1");
+    REQUIRE(image->getStringResolver("/robot1") == shared1);
+    REQUIRE(image->getStringResolver("/robot2") != shared1);
+    REQUIRE(shared1->getFilenameSubstitutions() == image->createStringResolver("/robot1")->getFilenameSubstitutions());
+    REQUIRE(shared1->resolve(fileParam->getValueString(), mx::FILENAME_TYPE_STRING) == "folder/robot01_diffuse_<UDIM>.tif");
+    REQUIRE(fileParam->getResolvedValueString() == "folder/<asset><id>_diffuse_<UDIM>.tif");
+    geominfo2->setTokenValue("id", std::string("03"));
+    REQUIRE(image->getStringResolver("/robot1") != shared1);
+    REQUIRE(image->getStringResolver("/robot1")->resolve("<id>", mx::FILENAME_TYPE_STRING) == "folder/03");
+    nodeGraph->setFilePrefix("other/");
+    REQUIRE(fileParam->getResolvedValueString() == "other/<asset><id>_diffuse_<UDIM>.tif");
+    nodeGraph->setFilePrefix("folder/");
+
+    // Geometry tokens from later geominfos take precedence.
+    geominfo1->setTokenValue("id", std::string("00"));
+    REQUIRE(image->getStringResolver("/robot1")->resolve("<id>", mx::FILENAME_TYPE_STRING) == "folder/03");
+    doc->setChildIndex(geominfo1->getName(), doc->getChildIndex(geominfo2->getName()));
+    REQUIRE(image->getStringResolver("/robot1")->resolve("<id>", mx::FILENAME_TYPE_STRING) == "folder/00");
+    doc->setChildIndex(geominfo1->getName(), 0);
+    geominfo1->removeToken("id");
+
     // Create a geominfo with an attribute.
     mx::GeomInfoPtr geominfo4 = doc->addGeomInfo("geominfo4", "/robot1");
     mx::StringVec udimSet = {"1001", "1002", "1003", "1004"};
@@ -103,3 +128,101 @@ TEST_CASE("GeomPropDef", "[geom]")
     REQUIRE(input->getDefaultGeomProp() == worldNormal);
     REQUIRE(doc->validate());
 }
+
+//
+// Benchmarks
+//
+
+TEST_CASE("String Resolver Benchmark", "[.benchmark]")
+{
+    // Create a document with per-asset geometry tokens.
+    const size_t geomInfoCount = 5000;
+    mx::DocumentPtr doc = mx::createDocument();
+    for (size_t i = 0; i < geomInfoCount; i++)
+    {
+        mx::GeomInfoPtr geomInfo = doc->addGeomInfo("", "/scene/asset" + std::to_string(i));
+        geomInfo->setTokenValue("asset", "asset" + std::to_string(i));
+        geomInfo->setTokenValue("variant", std::string("v" + std::to_string(i % 4)));
+    }
+
+    // Create a node graph with UDIM texture lookups.
+    const size_t imageCount = 8;
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph();
+    nodeGraph->setFilePrefix("textures/");
+    std::vector<mx::ParameterPtr> fileParams;
+    for (size_t i = 0; i < imageCount; i++)
+    {
+        mx::NodePtr image = nodeGraph->addNode("image");
+        std::string filename = "<asset>/<variant>/layer" + std::to_string(i) + "_<UDIM>.tif";
+        image->setParameterValue("file", filename, mx::FILENAME_TYPE_STRING);
+        fileParams.push_back(image->getParameter("file"));
+    }
+
+    // Resolve each filename for a subset of assets, as when binding images.
+    const size_t assetCount = 200;
+    auto resolveAll = [&](bool shared)
+    {
+        size_t totalLength = 0;
+        for (size_t a = 0; a < assetCount; a++)
+        {
+            std::string geom = "/scene/asset" + std::to_string(a * (geomInfoCount / assetCount));
+            for (mx::ParameterPtr fileParam : fileParams)
+            {
+                mx::ElementPtr scope = fileParam->getParent();
+                if (shared)
+                {
+                    mx::ConstStringResolverPtr resolver = scope->getStringResolver(geom);
+                    totalLength += resolver->resolve(fileParam->getValueString(), fileParam->getType()).size();
+                }
+                else
+                {
+                    totalLength += fileParam->getResolvedValueString(scope->createStringResolver(geom)).size();
+                }
+            }
+        }
+        return totalLength;
+    };
+    auto timeResolveAll = [&](bool shared, bool edit)
+    {
+        if (edit)
+        {
+            nodeGraph->setFilePrefix("textures/");
+        }
+        auto startTime = std::chrono::steady_clock::now();
+        REQUIRE(resolveAll(shared) > 0);
+        std::chrono::duration<double> duration = std::chrono::steady_clock::now() - startTime;
+        return duration.count() * 1.0e6 / (double) (assetCount * imageCount);
+    };
+
+    std::cout << "String resolver benchmark with " << geomInfoCount << " geominfos:" << std::endl;
+    std::cout << "    new resolver after edit: " << timeResolveAll(false, true) << " us per filename" << std::endl;
+    std::cout << "    new resolver: " << timeResolveAll(false, false) << " us per filename" << std::endl;
+    std::cout << "    shared resolver after edit: " << timeResolveAll(true, true) << " us per filename" << std::endl;
+    std::cout << "    shared resolver: " << timeResolveAll(true, false) << " us per filename" << std::endl;
+
+    // Compare single-pass substitution with sequential substring replacement.
+    mx::StringResolverPtr resolver = std::make_shared<mx::StringResolver>();
+    for (int i = 0; i < 20; i++)
+    {
+        resolver->setFilenameSubstitution("<token" + std::to_string(i) + ">", "value" + std::to_string(i));
+    }
+    resolver->setUdimString("1001");
+    const std::string filename = "<token3>/<token7>/<token12>_diffuse_<UDIM>.tif";
+    const size_t replaceCount = 100000;
+    auto startTime = std::chrono::steady_clock::now();
+    size_t totalLength = 0;
+    for (size_t i = 0; i < replaceCount; i++)
+    {
+        totalLength += mx::replaceSubstrings(filename, resolver->getFilenameSubstitutions()).size();
+    }
+    std::chrono::duration<double> sequentialTime = std::chrono::steady_clock::now() - startTime;
+    startTime = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < replaceCount; i++)
+    {
+        totalLength -= resolver->resolve(filename, mx::FILENAME_TYPE_STRING).size();
+    }
+    std::chrono::duration<double> singlePassTime = std::chrono::steady_clock::now() - startTime;
+    REQUIRE(totalLength == 0);
+    std::cout << "    sequential replacement of 21 tokens: " << sequentialTime.count() * 1.0e6 / replaceCount << " us per filename" << std::endl;
+    std::cout << "    single-pass replacement of 21 tokens: " << singlePassTime.count() * 1.0e6 / replaceCount << " us per filename" << std::endl;
+}
@@ -7,6 +7,9 @@
 
 #include <MaterialXCore/Document.h>
 
+#include <chrono>
+#include <iostream>
+
 namespace mx = MaterialX;
 
 TEST_CASE("Look", "[look]")
@@ -89,3 +92,189 @@ TEST_CASE("Look", "[look]")
     REQUIRE(look2->getActivePropertySetAssigns().empty());
     REQUIRE(look2->getActiveVisibilities().empty());
 }
+
+TEST_CASE("LookResolver", "[look]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+
+    // Create materials and collections.
+    std::vector<mx::MaterialPtr> materials;
+    for (int i = 0; i < 3; i++)
+    {
+        materials.push_back(doc->addMaterial());
+        materials.back()->addShaderRef();
+    }
+    mx::CollectionPtr coll0 = doc->addCollection("coll0");
+    coll0->setIncludeGeom("/a");
+    coll0->setExcludeGeom("/a/b");
+    mx::CollectionPtr coll1 = doc->addCollection("coll1");
+    coll1->setIncludeGeom("/c, /d/e");
+    coll1->setIncludeCollection(coll0);
+    mx::CollectionPtr coll2 = doc->addCollection("coll2");
+    coll2->setExcludeGeom("/c/f");
+    coll2->setIncludeCollection(coll1);
+    mx::CollectionPtr coll3 = doc->addCollection("coll3");
+    coll3->setIncludeGeom("/");
+    coll3->setExcludeGeom("/d");
+
+    // Create looks with geometry and collection bindings.
+    mx::LookPtr look1 = doc->addLook("look1");
+    look1->addMaterialAssign("assign1", materials[0]->getName())->setGeom("/a/b/c");
+    look1->addMaterialAssign("assign2", materials[1]->getName())->setCollection(coll2);
+    look1->addMaterialAssign("assign3", materials[2]->getName())->setGeom("/d, /x/y");
+    mx::LookPtr look2 = doc->addLook("look2");
+    look2->addMaterialAssign("assign4", materials[2]->getName())->setCollection(coll3);
+    mx::MaterialAssignPtr assign5 = look2->addMaterialAssign("assign5", materials[0]->getName());
+    assign5->setGeom("/");
+    assign5->setCollection(coll0);
+    look2->addMaterialAssign("assign6", materials[1]->getName())->setGeom("/a/b");
+    look2->setInheritsFrom(look1);
+
+    // Create geometry info elements.
+    mx::GeomInfoPtr geomInfo1 = doc->addGeomInfo("geomInfo1", "/a");
+    geomInfo1->setGeomAttrValue("id", 1);
+    mx::GeomInfoPtr geomInfo2 = doc->addGeomInfo("geomInfo2", "/b/c");
+    geomInfo2->setGeomPrefix("/a");
+    geomInfo2->setGeomAttrValue("id", 2);
+    REQUIRE(doc->validate());
+
+    // Compare all resolved bindings with direct queries of the document.
+    mx::LookResolver resolver(doc);
+    mx::StringVec geoms = { "/", "/a", "/a/b", "/a/b/c/d", "/a/q", "/c", "/c/f/g", "/d", "/d/e/f",
+                            "/x", "/x/y/z", "/z", "", "a/b", "/a, /c", "/a/b, /q", "/d/e, /c/f" };
+    for (const std::string& geom : geoms)
+    {
+        std::vector<mx::MaterialAssignPtr> resolved = resolver.getMaterialAssigns(geom);
+        for (mx::MaterialPtr material : materials)
+        {
+            std::vector<mx::MaterialAssignPtr> filtered;
+            for (mx::MaterialAssignPtr assign : resolved)
+            {
+                if (assign->getReferencedMaterial() == material)
+                {
+                    filtered.push_back(assign);
+                }
+            }
+            REQUIRE(filtered == material->getGeometryBindings(geom));
+        }
+        for (mx::LookPtr look : doc->getLooks())
+        {
+            std::vector<mx::MaterialAssignPtr> expected;
+            for (mx::MaterialAssignPtr assign : look->getActiveMaterialAssigns())
+            {
+                mx::CollectionPtr collection = assign->getCollection();
+                if (mx::geomStringsMatch(geom, assign->getActiveGeom()) ||
+                    (collection && collection->matchesGeomString(geom)))
+                {
+                    expected.push_back(assign);
+                }
+            }
+            REQUIRE(resolver.getMaterialAssigns(geom, look) == expected);
+        }
+        for (mx::CollectionPtr collection : doc->getCollections())
+        {
+            REQUIRE(resolver.matchesCollection(collection, geom) == collection->matchesGeomString(geom));
+        }
+        mx::ValuePtr expectedValue = doc->getGeomAttrValue("id", geom);
+        mx::ValuePtr resolvedValue = resolver.getGeomAttrValue("id", geom);
+        REQUIRE((expectedValue ? expectedValue->getValueString() : "") ==
+                (resolvedValue ? resolvedValue->getValueString() : ""));
+    }
+    REQUIRE(resolver.getMaterialAssigns("/a/b/c", look1).size() == 1);
+    REQUIRE(resolver.getBoundMaterials("/x/y, /a/q", look1) == std::vector<mx::MaterialPtr>({ materials[1], materials[2] }));
+    REQUIRE(resolver.getGeomInfos("/a/b/c/d") == std::vector<mx::GeomInfoPtr>({ geomInfo1, geomInfo2 }));
+
+    // Batch resolution must match individual queries.
+    std::vector<std::vector<mx::MaterialAssignPtr>> batch = resolver.getMaterialAssigns(geoms, look2, 4);
+    REQUIRE(batch.size() == geoms.size());
+    for (size_t i = 0; i < geoms.size(); i++)
+    {
+        REQUIRE(batch[i] == resolver.getMaterialAssigns(geoms[i], look2));
+    }
+
+    // Create and detect a cycle in a collection include chain.
+    coll0->setIncludeCollection(coll2);
+    REQUIRE_THROWS_AS(mx::LookResolver{ doc }, mx::ExceptionFoundCycle&);
+    coll0->setIncludeCollection(nullptr);
+    REQUIRE_NOTHROW(mx::LookResolver{ doc });
+}
+
+//
+// Benchmarks
+//
+
+TEST_CASE("LookResolver Benchmark", "[.benchmark]")
+{
+    // Create a scene description with per-asset material assignments and a
+    // set of collection-based overrides.
+    const size_t groupCount = 20;
+    const size_t assetCount = 50;
+    const size_t meshCount = 20;
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::MaterialPtr material = doc->addMaterial();
+    material->addShaderRef();
+    mx::LookPtr look = doc->addLook();
+    for (size_t g = 0; g < groupCount; g++)
+    {
+        std::string groupPath = "/scene/group" + std::to_string(g);
+        mx::CollectionPtr collection = doc->addCollection();
+        collection->setIncludeGeom(groupPath);
+        collection->setExcludeGeom(groupPath + "/asset0/mesh0");
+        if (g % 2)
+        {
+            collection->setIncludeCollection(doc->getCollection("collection" + std::to_string(g)));
+        }
+        look->addMaterialAssign("", material->getName())->setCollection(collection);
+        for (size_t a = 0; a < assetCount; a++)
+        {
+            look->addMaterialAssign("", material->getName())->setGeom(groupPath + "/asset" + std::to_string(a));
+        }
+    }
+
+    // Create the geometry paths to be resolved.
+    mx::StringVec geoms;
+    for (size_t g = 0; g < groupCount; g++)
+    {
+        for (size_t a = 0; a < assetCount; a++)
+        {
+            for (size_t m = 0; m < meshCount; m++)
+            {
+                geoms.push_back("/scene/group" + std::to_string(g) + "/asset" + std::to_string(a) + "/mesh" + std::to_string(m));
+            }
+        }
+    }
+
+    // Resolve a subset of paths with direct queries of the document.
+    const size_t directCount = 500;
+    auto startTime = std::chrono::steady_clock::now();
+    size_t directMatches = 0;
+    for (size_t i = 0; i < directCount; i++)
+    {
+        directMatches += material->getGeometryBindings(geoms[i * geoms.size() / directCount]).size();
+    }
+    std::chrono::duration<double> directTime = std::chrono::steady_clock::now() - startTime;
+
+    // Resolve all paths with a resolver.
+    startTime = std::chrono::steady_clock::now();
+    mx::LookResolver resolver(doc);
+    std::chrono::duration<double> buildTime = std::chrono::steady_clock::now() - startTime;
+    startTime = std::chrono::steady_clock::now();
+    size_t resolvedMatches = 0;
+    for (const std::string& geom : geoms)
+    {
+        resolvedMatches += resolver.getMaterialAssigns(geom).size();
+    }
+    std::chrono::duration<double> resolveTime = std::chrono::steady_clock::now() - startTime;
+    startTime = std::chrono::steady_clock::now();
+    std::vector<std::vector<mx::MaterialAssignPtr>> batch = resolver.getMaterialAssigns(geoms);
+    std::chrono::duration<double> batchTime = std::chrono::steady_clock::now() - startTime;
+    REQUIRE(batch.size() == geoms.size());
+    REQUIRE(resolvedMatches > 0);
+    REQUIRE(directMatches > 0);
+
+    std::cout << "Look resolution benchmark with " << look->getMaterialAssigns().size() << " assignments:" << std::endl;
+    std::cout << "    direct query: " << directTime.count() * 1.0e6 / directCount << " us per path" << std::endl;
+    std::cout << "    resolver build: " << buildTime.count() * 1000.0 << " ms" << std::endl;
+    std::cout << "    resolver query: " << resolveTime.count() * 1.0e6 / geoms.size() << " us per path" << std::endl;
+    std::cout << "    resolver batch of " << geoms.size() << " paths: " << batchTime.count() * 1000.0 << " ms" << std::endl;
+}
@@ -11,6 +11,9 @@
 #include <MaterialXFormat/File.h>
 #include <MaterialXFormat/XmlIo.h>
 
+#include <chrono>
+#include <iostream>
+
 namespace mx = MaterialX;
 
 bool isTopologicalOrder(const std::vector<mx::ElementPtr>& elems)
@@ -65,6 +68,24 @@ TEST_CASE("Node", "[node]")
     REQUIRE(constant->getDownstreamPorts()[0] == output1);
     REQUIRE(image->getDownstreamPorts()[0] == output2);
 
+    // Connections are resolved by name within the scope of a graph.
+    std::string imageName = image->getName();
+    image->setName("renamedImage");
+    REQUIRE(output2->getUpstreamElement() == nullptr);
+    REQUIRE(image->getDownstreamPorts().empty());
+    image->setName(imageName);
+    REQUIRE(image->getDownstreamPorts()[0] == output2);
+    mx::NodeGraphPtr nestedGraph = doc->addNodeGraph();
+    mx::OutputPtr nestedOutput = nestedGraph->addOutput();
+    nestedOutput->setNodeName(constant->getName());
+    REQUIRE(nestedOutput->getUpstreamElement() == nullptr);
+    REQUIRE(constant->getDownstreamPorts().size() == 1);
+    nestedGraph->addNode("constant", constant->getName());
+    REQUIRE(nestedOutput->getUpstreamElement() != nullptr);
+    REQUIRE(nestedGraph->getNode(constant->getName())->getDownstreamPorts()[0] == nestedOutput);
+    doc->removeNodeGraph(nestedGraph->getName());
+    REQUIRE(constant->getDownstreamPorts().size() == 1);
+
     // Create a custom nodedef.
     mx::NodeDefPtr customNodeDef = doc->addNodeDef("ND_turbulence3d", "float", "turbulence3d");
     customNodeDef->setNodeGroup(mx::PROCEDURAL_NODE_GROUP);
@@ -467,3 +488,93 @@ TEST_CASE("Prune nodes", "[nodegraph]")
     REQUIRE(elemOrder.size() == nodeGraph2->getChildren().size());
     REQUIRE(isTopologicalOrder(elemOrder));
 }
+
+//
+// Benchmarks
+//
+
+TEST_CASE("Node: Graph Connection Benchmark", "[.benchmark]")
+{
+    // Create a document with the standard library definitions.
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::DocumentPtr libDoc = mx::createDocument();
+    mx::readFromXmlFile(libDoc, "stdlib_defs.mtlx", "libraries/stdlib");
+    doc->importLibrary(libDoc);
+
+    // Create a graph-based definition with two internal nodes.
+    mx::NodeDefPtr nodeDef = doc->addNodeDef("ND_bench_compound", "float", "bench_compound");
+    nodeDef->addInput("in", "float");
+    mx::NodeGraphPtr implGraph = doc->addNodeGraph("NG_bench_compound");
+    implGraph->setNodeDef(nodeDef);
+    mx::NodePtr implAdd = implGraph->addNode("add", "add1", "float");
+    implAdd->addInput("in1", "float")->setInterfaceName("in");
+    implAdd->setInputValue("in2", 1.0f);
+    mx::NodePtr implMultiply = implGraph->addNode("multiply", "multiply1", "float");
+    implMultiply->setConnectedNode("in1", implAdd);
+    implMultiply->setInputValue("in2", 0.5f);
+    implGraph->addOutput("out", "float")->setConnectedNode(implMultiply);
+
+    // Create a large graph, where each node reads from the node that precedes
+    // it and from a shared source node, and every other node feeds a compound node.
+    const size_t nodeCount = 2000;
+    mx::NodeGraphPtr graph = doc->addNodeGraph("bench_graph");
+    mx::NodePtr source = graph->addNode("constant", "source", "float");
+    std::vector<mx::NodePtr> nodes;
+    for (size_t i = 0; i < nodeCount; i++)
+    {
+        mx::NodePtr node = graph->addNode("add", "node" + std::to_string(i), "float");
+        node->setConnectedNode("in1", i > 0 ? nodes[i - 1] : source);
+        node->setConnectedNode("in2", source);
+        nodes.push_back(node);
+    }
+    for (size_t i = 0; i < nodeCount; i += 2)
+    {
+        mx::NodePtr compound = graph->addNodeInstance(nodeDef, "compound" + std::to_string(i));
+        compound->setConnectedNode("in", nodes[i]);
+    }
+    mx::OutputPtr output = graph->addOutput("out", "float");
+    output->setConnectedNode(nodes.back());
+    REQUIRE(doc->validate());
+
+    // Query downstream ports, interleaved with edits to graph connections.
+    auto startTime = std::chrono::steady_clock::now();
+    size_t portCount = 0;
+    for (size_t i = 0; i + 1 < nodeCount; i += 10)
+    {
+        nodes[i + 1]->setConnectedNode("in2", nodes[i]);
+        portCount += nodes[i]->getDownstreamPorts().size();
+        nodes[i + 1]->setConnectedNode("in2", source);
+    }
+    std::chrono::duration<double> editQueryTime = std::chrono::steady_clock::now() - startTime;
+    REQUIRE(portCount > 0);
+
+    // Traverse the graph upstream from its output.
+    startTime = std::chrono::steady_clock::now();
+    size_t edgeCount = 0;
+    for (mx::Edge edge : output->traverseGraph())
+    {
+        if (edge.getUpstreamElement())
+        {
+            edgeCount++;
+        }
+    }
+    std::chrono::duration<double> traverseTime = std::chrono::steady_clock::now() - startTime;
+
+    // Sort the graph in topological order.
+    startTime = std::chrono::steady_clock::now();
+    std::vector<mx::ElementPtr> elemOrder = graph->topologicalSort();
+    std::chrono::duration<double> sortTime = std::chrono::steady_clock::now() - startTime;
+    REQUIRE(elemOrder.size() == graph->getChildren().size());
+
+    // Flatten the graph-based nodes.
+    startTime = std::chrono::steady_clock::now();
+    graph->flattenSubgraphs();
+    std::chrono::duration<double> flattenTime = std::chrono::steady_clock::now() - startTime;
+    REQUIRE(graph->getNodes().size() == nodeCount * 2 + 1);
+
+    std::cout << "Graph connection benchmark with " << nodeCount << " nodes:" << std::endl;
+    std::cout << "    edit and query downstream ports: " << editQueryTime.count() * 1000.0 << " ms" << std::endl;
+    std::cout << "    traverse " << edgeCount << " edges: " << traverseTime.count() * 1000.0 << " ms" << std::endl;
+    std::cout << "    topological sort: " << sortTime.count() * 1000.0 << " ms" << std::endl;
+    std::cout << "    flatten subgraphs: " << flattenTime.count() * 1000.0 << " ms" << std::endl;
+}
@@ -6,6 +6,7 @@
 #include <MaterialXTest/Catch/catch.hpp>
 
 #include <MaterialXCore/Observer.h>
+#include <MaterialXCore/Transaction.h>
 #include <MaterialXFormat/XmlIo.h>
 
 namespace mx = MaterialX;
@@ -31,12 +32,12 @@ TEST_CASE("Observer", "[observer]")
 
         void onBeginUpdate() override { _beginUpdateCount++; }
         void onEndUpdate() override { _endUpdateCount++; }
-        void onAddElement(mx::ElementPtr parent, mx::ElementPtr elem) override { _addElementCount++; }
-        void onRemoveElement(mx::ElementPtr parent, mx::ElementPtr elem) override { _removeElementCount++; }
-        void onSetAttribute(mx::ElementPtr elem, const std::string&, const std::string&) override { _setAttributeCount++; }
-        void onRemoveAttribute(mx::ElementPtr elem, const std::string&) override { _removeAttributeCount++; }
-        void onCopyContent(mx::ElementPtr elem) override { _copyContentCount++; }
-        void onClearContent(mx::ElementPtr elem) override { _clearContentCount++; }
+        void onAddElement(mx::ElementPtr, mx::ElementPtr) override { _addElementCount++; }
+        void onRemoveElement(mx::ElementPtr, mx::ElementPtr) override { _removeElementCount++; }
+        void onSetAttribute(mx::ElementPtr, const std::string&, const std::string&) override { _setAttributeCount++; }
+        void onRemoveAttribute(mx::ElementPtr, const std::string&) override { _removeAttributeCount++; }
+        void onCopyContent(mx::ElementPtr) override { _copyContentCount++; }
+        void onClearContent(mx::ElementPtr) override { _clearContentCount++; }
         void onRead() override { _readCount++; }
         void onWrite() override { _writeCount++; }
 
@@ -96,6 +97,17 @@ TEST_CASE("Observer", "[observer]")
             REQUIRE(_writeCount == 0);
         }
 
+        void verifyCountsTransaction(unsigned int updateCount, unsigned int addElementCount, unsigned int removeElementCount,
+                                     unsigned int setAttributeCount, unsigned int removeAttributeCount)
+        {
+            REQUIRE(_beginUpdateCount == updateCount);
+            REQUIRE(_endUpdateCount == updateCount);
+            REQUIRE(_addElementCount == addElementCount);
+            REQUIRE(_removeElementCount == removeElementCount);
+            REQUIRE(_setAttributeCount == setAttributeCount);
+            REQUIRE(_removeAttributeCount == removeAttributeCount);
+        }
+
       protected:
         // Set of counts for verification.
         unsigned int _beginUpdateCount;
@@ -153,4 +165,32 @@ TEST_CASE("Observer", "[observer]")
     doc->initialize();
     mx::readFromXmlString(doc, xmlString);
     testObserver->verifyCountsDisabled();
+
+    // Check that the edits of a transaction are delivered as a single
+    // coalesced update.
+    testObserver->clear();
+    doc->enableCallbacks();
+    mx::NodeDefPtr nodeDef = doc->getNodeDef("ND_simpleSrf");
+    {
+        mx::DocumentTransaction transaction(doc);
+        mx::NodeGraphPtr transactionGraph = doc->addNodeGraph("transactionGraph");
+        transactionGraph->addNode("constant");
+        nodeDef->setAttribute("doc", "First description");
+        nodeDef->setAttribute("doc", "Second description");
+        testObserver->verifyCountsTransaction(0, 0, 0, 0, 0);
+    }
+    testObserver->verifyCountsTransaction(1, 1, 0, 1, 0);
+
+    // Check that undoing a transaction is delivered as a single update.
+    mx::DocumentTransaction removal(doc);
+    doc->removeNodeGraph("transactionGraph");
+    nodeDef->removeAttribute("doc");
+    testObserver->clear();
+    removal.commit();
+    testObserver->verifyCountsTransaction(1, 0, 1, 0, 1);
+    testObserver->clear();
+    removal.undo();
+    REQUIRE(doc->getNodeGraph("transactionGraph"));
+    REQUIRE(nodeDef->getAttribute("doc") == "Second description");
+    testObserver->verifyCountsTransaction(1, 1, 0, 1, 0);
 }
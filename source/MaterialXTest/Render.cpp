@@ -13,6 +13,9 @@
 #include <MaterialXGenShader/Util.h>
 #include <MaterialXGenShader/HwShaderGenerator.h>
 #include <MaterialXGenShader/DefaultColorManagementSystem.h>
+#include <MaterialXGenShader/Shader.h>
+
+#include <MaterialXGenGlsl/GlslShaderGenerator.h>
 
 #include <MaterialXRender/Util.h>
 #include <MaterialXRender/ExceptionShaderValidationError.h>
@@ -31,6 +34,7 @@
 #include <iostream>
 #include <unordered_set>
 #include <chrono>
+#include <cmath>
 #include <ctime>
 
 namespace mx = MaterialX;
@@ -212,3 +216,148 @@ TEST_CASE("Render: Image Handler Load", "[rendercore]")
     CHECK(imagesLoaded);
     imageHandlerLog.close();
 }
+
+//
+// Benchmarks
+//
+
+TEST_CASE("Render: UI Property Benchmark", "[.benchmark]")
+{
+    const int ROUNDS = 100;
+
+    mx::FilePath searchPath = mx::FilePath::getCurrentPath() / mx::FilePath("libraries");
+    mx::DocumentPtr libraries = mx::createDocument();
+    GenShaderUtil::loadLibraries({ "stdlib", "pbrlib", "bxdf" }, searchPath, libraries);
+
+    mx::GenContext context(mx::GlslShaderGenerator::create());
+    context.registerSourceCodeSearchPath(searchPath);
+
+    // Populate property groups for each standard_surface example material, as
+    // the viewer's property editor does, with and without a name path index.
+    mx::FilePath materialsPath = mx::FilePath::getCurrentPath() / mx::FilePath("resources/Materials/Examples/StandardSurface");
+    double groupMs[2] = { 0.0, 0.0 };
+    double lookupMs[2] = { 0.0, 0.0 };
+    size_t itemCounts[2] = { 0, 0 };
+    size_t foundCounts[2] = { 0, 0 };
+    size_t lookupCount = 0;
+    for (const mx::FilePath& filename : materialsPath.getFilesInDirectory("mtlx"))
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        mx::readFromXmlFile(doc, materialsPath / filename);
+        doc->importLibrary(libraries);
+
+        std::vector<mx::TypedElementPtr> elements;
+        mx::findRenderableElements(doc, elements);
+        for (mx::TypedElementPtr elem : elements)
+        {
+            mx::ShaderPtr shader = mx::createShader(elem->getName(), context, elem);
+            REQUIRE(shader);
+            const mx::VariableBlock& uniforms = shader->getStage(mx::Stage::PIXEL).getUniformBlock(mx::HW::PUBLIC_UNIFORMS);
+            for (int indexed = 0; indexed < 2; indexed++)
+            {
+                doc->setNamePathIndexEnabled(indexed != 0);
+
+                auto groupStart = std::chrono::steady_clock::now();
+                for (int r = 0; r < ROUNDS; r++)
+                {
+                    mx::UIPropertyGroup groups;
+                    mx::UIPropertyGroup unnamedGroups;
+                    mx::createUIPropertyGroups(uniforms, doc, elem, ":", groups, unnamedGroups);
+                    itemCounts[indexed] += groups.size() + unnamedGroups.size();
+                }
+                auto groupEnd = std::chrono::steady_clock::now();
+                groupMs[indexed] += std::chrono::duration<double, std::milli>(groupEnd - groupStart).count();
+
+                auto lookupStart = std::chrono::steady_clock::now();
+                for (int r = 0; r < ROUNDS; r++)
+                {
+                    for (mx::ShaderPort* uniform : uniforms.getVariableOrder())
+                    {
+                        if (!uniform->getPath().empty())
+                        {
+                            foundCounts[indexed] += doc->getDescendant(uniform->getPath()) ? 1 : 0;
+                            if (indexed)
+                            {
+                                lookupCount++;
+                            }
+                        }
+                    }
+                }
+                auto lookupEnd = std::chrono::steady_clock::now();
+                lookupMs[indexed] += std::chrono::duration<double, std::milli>(lookupEnd - lookupStart).count();
+            }
+        }
+    }
+    REQUIRE(itemCounts[0] == itemCounts[1]);
+    REQUIRE(foundCounts[0] == foundCounts[1]);
+
+    std::cout << "UI property groups: " << itemCounts[0] / ROUNDS << " items" << std::endl;
+    std::cout << "    path splitting: " << groupMs[0] / ROUNDS << " ms per population" << std::endl;
+    std::cout << "    name path index: " << groupMs[1] / ROUNDS << " ms per population" << std::endl;
+    std::cout << "Uniform path lookups: " << lookupCount << ", " << foundCounts[1] << " found" << std::endl;
+    std::cout << "    path splitting: " << lookupMs[0] * 1000.0 / lookupCount << " us per lookup" << std::endl;
+    std::cout << "    name path index: " << lookupMs[1] * 1000.0 / lookupCount << " us per lookup" << std::endl;
+}
+
+TEST_CASE("Render: Mesh Transform Benchmark", "[.benchmark]")
+{
+    const size_t VERTEX_COUNT = 10000000;
+    const mx::Matrix44 matrix = mx::Matrix44::createScale(mx::Vector3(2.0f)) *
+                                mx::Matrix44::createRotationY(0.5f) *
+                                mx::Matrix44::createTranslation(mx::Vector3(1.0f, 2.0f, 3.0f));
+
+    for (const std::string& type : { mx::MeshStream::POSITION_ATTRIBUTE, mx::MeshStream::NORMAL_ATTRIBUTE })
+    {
+        mx::MeshStreamPtr stream = mx::MeshStream::create("i_" + type, type, 0);
+        stream->setStride(3);
+        stream->resize((unsigned int) VERTEX_COUNT);
+        mx::MeshFloatBuffer& data = stream->getData();
+        for (size_t i = 0; i < data.size(); i++)
+        {
+            data[i] = (float) (i % 1000) * 0.001f;
+        }
+        mx::MeshFloatBuffer reference = data;
+        bool isPosition = (type == mx::MeshStream::POSITION_ATTRIBUTE);
+
+        // Transform each vertex individually, as MeshStream::transform
+        // previously did.
+        auto startTime = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < VERTEX_COUNT; i++)
+        {
+            float* vertex = &reference[i * 3];
+            if (isPosition)
+            {
+                mx::Vector4 vec(vertex[0], vertex[1], vertex[2], 1.0f);
+                vec = matrix.multiply(vec);
+                vertex[0] = vec[0]; vertex[1] = vec[1]; vertex[2] = vec[2];
+            }
+            else
+            {
+                mx::Vector3 vec(vertex[0], vertex[1], vertex[2]);
+                vec = matrix.transformNormal(vec);
+                vertex[0] = vec[0]; vertex[1] = vec[1]; vertex[2] = vec[2];
+            }
+        }
+        std::chrono::duration<double> vertexTime = std::chrono::steady_clock::now() - startTime;
+
+        // Transform the stream as a batch.
+        startTime = std::chrono::steady_clock::now();
+        stream->transform(matrix);
+        std::chrono::duration<double> batchTime = std::chrono::steady_clock::now() - startTime;
+
+        for (size_t i = 0; i < data.size(); i += 9973)
+        {
+            REQUIRE(std::abs(data[i] - reference[i]) < 1e-4f);
+        }
+        std::cout << "Mesh transform of " << VERTEX_COUNT << " vertices (" << type << "): " <<
+            "per vertex " << vertexTime.count() * 1000.0 << " ms, batch " << batchTime.count() * 1000.0 << " ms" << std::endl;
+    }
+
+    // Transform positions stored as separate coordinate arrays.
+    std::vector<float> x(VERTEX_COUNT, 0.25f), y(VERTEX_COUNT, 0.5f), z(VERTEX_COUNT, 0.75f);
+    auto startTime = std::chrono::steady_clock::now();
+    matrix.transformPoints(x.data(), y.data(), z.data(), VERTEX_COUNT);
+    std::chrono::duration<double> soaTime = std::chrono::steady_clock::now() - startTime;
+    std::cout << "Mesh transform of " << VERTEX_COUNT << " vertices (separate coordinate arrays): " <<
+        soaTime.count() * 1000.0 << " ms" << std::endl;
+}
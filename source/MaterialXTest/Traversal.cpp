@@ -7,6 +7,11 @@
 
 #include <MaterialXCore/Document.h>
 
+#include <MaterialXFormat/XmlIo.h>
+
+#include <chrono>
+#include <iostream>
+
 namespace mx = MaterialX;
 
 TEST_CASE("Traversal", "[traversal]")
@@ -97,6 +102,59 @@ TEST_CASE("Traversal", "[traversal]")
     }
     REQUIRE(nodeCount == 0);
 
+    // Traverse the document tree (remove the parent of the current element).
+    mx::DocumentPtr editDoc = mx::createDocument();
+    mx::NodeGraphPtr editGraph = editDoc->addNodeGraph("graph1");
+    editGraph->addNode("constant", "constant1");
+    editGraph->addNode("constant", "constant2");
+    editGraph = nullptr;
+    std::vector<std::string> visitedNames;
+    for (mx::TreeIterator it = editDoc->traverseTree().begin(); it != mx::TreeIterator::end(); ++it)
+    {
+        visitedNames.push_back(it.getElement()->getName());
+        if (it.getElement()->getName() == "constant1")
+        {
+            editDoc->removeNodeGraph("graph1");
+        }
+    }
+    REQUIRE((visitedNames == std::vector<std::string>{ "", "graph1", "constant1", "constant2" }));
+
+    // Iterators are equal only at the same position in the same traversal.
+    mx::TreeIterator treeIt1 = doc->traverseTree();
+    mx::TreeIterator treeIt2 = doc->traverseTree();
+    REQUIRE(treeIt1 == treeIt2);
+    ++treeIt1;
+    REQUIRE(treeIt1 != treeIt2);
+    ++treeIt2;
+    REQUIRE(treeIt1 == treeIt2);
+
+    // Traverse the document tree (walker).
+    std::vector<mx::ElementPtr> treeElems;
+    for (mx::ElementPtr elem : doc->traverseTree())
+    {
+        treeElems.push_back(elem);
+    }
+    mx::TreeWalker treeWalker;
+    size_t elemIndex = 0;
+    for (mx::Element* elem = treeWalker.begin(doc.get()); elem; elem = treeWalker.next())
+    {
+        REQUIRE(elem == treeElems[elemIndex++].get());
+    }
+    REQUIRE(elemIndex == treeElems.size());
+    nodeCount = 0;
+    for (mx::Element* elem = treeWalker.begin(doc.get()); elem; elem = treeWalker.next())
+    {
+        if (elem->isA<mx::Node>())
+        {
+            nodeCount++;
+        }
+        if (elem->isA<mx::NodeGraph>())
+        {
+            treeWalker.setPruneSubtree(true);
+        }
+    }
+    REQUIRE(nodeCount == 0);
+
     // Traverse upstream from the graph output (implicit iterator).
     nodeCount = 0;
     for (mx::Edge edge : output->traverseGraph())
@@ -139,6 +197,23 @@ TEST_CASE("Traversal", "[traversal]")
     REQUIRE(maxElementDepth == 3);
     REQUIRE(maxNodeDepth == 3);
 
+    // Traverse upstream from the graph output (walker).
+    std::vector<mx::Edge> graphEdges;
+    for (mx::Edge edge : output->traverseGraph())
+    {
+        graphEdges.push_back(edge);
+    }
+    mx::GraphWalker graphWalker;
+    size_t edgeIndex = 0;
+    for (mx::Element* elem = graphWalker.begin(output.get()); elem; elem = graphWalker.next())
+    {
+        const mx::Edge& edge = graphEdges[edgeIndex++];
+        REQUIRE(elem == edge.getUpstreamElement().get());
+        REQUIRE(graphWalker.getConnectingElement() == edge.getConnectingElement().get());
+        REQUIRE(graphWalker.getDownstreamElement() == edge.getDownstreamElement().get());
+    }
+    REQUIRE(edgeIndex == graphEdges.size());
+
     // Traverse upstream from the graph output (prune subgraph).
     nodeCount = 0;
     for (mx::GraphIterator it = output->traverseGraph().begin(); it != mx::GraphIterator::end(); ++it)
@@ -155,10 +230,62 @@ TEST_CASE("Traversal", "[traversal]")
     }
     REQUIRE(nodeCount == 5);
 
+    // Create a dense snapshot of the node graph.
+    mx::GraphSnapshot snapshot(nodeGraph);
+    REQUIRE(snapshot.getElementCount() == 8);
+    REQUIRE(snapshot.getEdgeCount() == 7);
+    REQUIRE(!snapshot.hasCycle());
+    size_t mixId = snapshot.getElementId(mix);
+    size_t outputId = snapshot.getElementId(output);
+    REQUIRE(snapshot.getElement(mixId) == mix);
+    REQUIRE(snapshot.getElementId(doc) == mx::GraphSnapshot::INVALID_ID);
+    REQUIRE(snapshot.getUpstreamIds(mixId).size() == 3);
+    REQUIRE(snapshot.getElement(snapshot.getUpstreamIds(mixId)[0]) == multiply);
+    REQUIRE(snapshot.getConnectingElement(mixId, 0) == mix->getInput("fg"));
+    REQUIRE(snapshot.getDownstreamIds(mixId).size() == 1);
+    REQUIRE(snapshot.getDownstreamIds(mixId)[0] == outputId);
+    REQUIRE(snapshot.isUpstream(snapshot.getElementId(image1), outputId));
+    REQUIRE(!snapshot.isUpstream(snapshot.getElementId(image1), snapshot.getElementId(contrast)));
+    REQUIRE(snapshot.getUpstreamClosure(outputId).size() == 7);
+    REQUIRE(snapshot.getUpstreamClosure(snapshot.getElementId(contrast)).size() == 1);
+
+    // Verify the topological order of the snapshot.
+    std::vector<size_t> orderIndex(snapshot.getElementCount());
+    const std::vector<size_t>& topologicalOrder = snapshot.getTopologicalOrder();
+    REQUIRE(topologicalOrder.size() == snapshot.getElementCount());
+    for (size_t i = 0; i < topologicalOrder.size(); i++)
+    {
+        orderIndex[topologicalOrder[i]] = i;
+    }
+    for (size_t id = 0; id < snapshot.getElementCount(); id++)
+    {
+        for (size_t upstreamId : snapshot.getUpstreamIds(id))
+        {
+            REQUIRE(orderIndex[upstreamId] < orderIndex[id]);
+        }
+    }
+
+    // Create snapshots of upstream dependencies.
+    mx::GraphSnapshot contrastSnapshot({ contrast });
+    REQUIRE(contrastSnapshot.getElementCount() == 2);
+    REQUIRE(contrastSnapshot.getElementId(image2) == 1);
+    mx::MaterialPtr material = doc->addMaterial();
+    mx::ShaderRefPtr shaderRef = material->addShaderRef();
+    shaderRef->addBindInput("base_color", "color3")->setConnectedOutput(output);
+    mx::GraphSnapshot materialSnapshot(material);
+    REQUIRE(materialSnapshot.getElementCount() == 9);
+    REQUIRE(materialSnapshot.getTopologicalOrder().back() == materialSnapshot.getElementId(shaderRef));
+    doc->removeMaterial(material->getName());
+
     // Create and detect a cycle.
     multiply->setConnectedNode("in2", mix);
     REQUIRE(output->hasUpstreamCycle());
     REQUIRE(!doc->validate());
+    REQUIRE_THROWS_AS(for (mx::Element* elem = graphWalker.begin(output.get()); elem; elem = graphWalker.next()) { },
+                      mx::ExceptionFoundCycle&);
+    mx::GraphSnapshot cycleSnapshot(nodeGraph);
+    REQUIRE(cycleSnapshot.hasCycle());
+    REQUIRE(cycleSnapshot.isUpstream(cycleSnapshot.getElementId(mix), cycleSnapshot.getElementId(multiply)));
     multiply->setConnectedNode("in2", constant);
     REQUIRE(!output->hasUpstreamCycle());
     REQUIRE(doc->validate());
@@ -171,3 +298,142 @@ TEST_CASE("Traversal", "[traversal]")
     REQUIRE(!output->hasUpstreamCycle());
     REQUIRE(doc->validate());
 }
+
+//
+// Benchmarks
+//
+
+TEST_CASE("Traversal: Graph Snapshot Benchmark", "[.benchmark]")
+{
+    // Create a large graph, where each node reads from the node that precedes
+    // it and from a shared source node.
+    const size_t nodeCount = 20000;
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph();
+    mx::NodePtr source = nodeGraph->addNode("constant", "source", "float");
+    mx::NodePtr prevNode = source;
+    for (size_t i = 0; i < nodeCount; i++)
+    {
+        mx::NodePtr node = nodeGraph->addNode("add", "node" + std::to_string(i), "float");
+        node->setConnectedNode("in1", prevNode);
+        node->setConnectedNode("in2", source);
+        prevNode = node;
+    }
+    mx::OutputPtr output = nodeGraph->addOutput("out", "float");
+    output->setConnectedNode(prevNode);
+
+    // Sort and traverse the graph through its elements.
+    auto startTime = std::chrono::steady_clock::now();
+    std::vector<mx::ElementPtr> elemOrder = nodeGraph->topologicalSort();
+    std::chrono::duration<double> sortTime = std::chrono::steady_clock::now() - startTime;
+    startTime = std::chrono::steady_clock::now();
+    size_t edgeCount = 0;
+    for (mx::Edge edge : output->traverseGraph())
+    {
+        if (edge.getUpstreamElement())
+        {
+            edgeCount++;
+        }
+    }
+    std::chrono::duration<double> traverseTime = std::chrono::steady_clock::now() - startTime;
+
+    // Create a snapshot, and sort and traverse the graph through it.
+    startTime = std::chrono::steady_clock::now();
+    mx::GraphSnapshot snapshot(nodeGraph);
+    std::chrono::duration<double> snapshotTime = std::chrono::steady_clock::now() - startTime;
+    REQUIRE(snapshot.getTopologicalOrder().size() == elemOrder.size());
+    startTime = std::chrono::steady_clock::now();
+    std::vector<size_t> closure = snapshot.getUpstreamClosure(snapshot.getElementId(output));
+    std::chrono::duration<double> closureTime = std::chrono::steady_clock::now() - startTime;
+    REQUIRE(closure.size() == nodeCount + 1);
+    startTime = std::chrono::steady_clock::now();
+    const size_t queryCount = 100;
+    size_t outputId = snapshot.getElementId(output);
+    size_t lastNodeId = snapshot.getElementId(prevNode);
+    for (size_t i = 0; i < queryCount; i++)
+    {
+        REQUIRE(!snapshot.isUpstream(outputId, lastNodeId));
+    }
+    std::chrono::duration<double> queryTime = std::chrono::steady_clock::now() - startTime;
+
+    std::cout << "Graph snapshot benchmark with " << nodeCount << " nodes:" << std::endl;
+    std::cout << "    element topological sort: " << sortTime.count() * 1000.0 << " ms" << std::endl;
+    std::cout << "    element traversal of " << edgeCount << " edges: " << traverseTime.count() * 1000.0 << " ms" << std::endl;
+    std::cout << "    snapshot creation and topological sort: " << snapshotTime.count() * 1000.0 << " ms" << std::endl;
+    std::cout << "    snapshot upstream closure: " << closureTime.count() * 1000.0 << " ms" << std::endl;
+    std::cout << "    snapshot reachability (" << queryCount << " queries): " << queryTime.count() * 1000.0 << " ms" << std::endl;
+}
+
+TEST_CASE("Traversal: Iterator Benchmark", "[.benchmark]")
+{
+    // Load the standard library into a document.
+    mx::DocumentPtr doc = mx::createDocument();
+    for (const std::string& filename : mx::StringVec{ "stdlib_defs.mtlx", "stdlib_ng.mtlx", "genglsl/stdlib_genglsl_impl.mtlx", "genosl/stdlib_genosl_impl.mtlx" })
+    {
+        mx::DocumentPtr libDoc = mx::createDocument();
+        mx::readFromXmlFile(libDoc, filename, "libraries/stdlib");
+        doc->importLibrary(libDoc);
+    }
+
+    // Traverse the library tree.
+    const size_t passCount = 20;
+    size_t iteratorCount = 0;
+    auto startTime = std::chrono::steady_clock::now();
+    for (size_t pass = 0; pass < passCount; pass++)
+    {
+        for (mx::ElementPtr elem : doc->traverseTree())
+        {
+            iteratorCount++;
+        }
+    }
+    std::chrono::duration<double> treeIteratorTime = (std::chrono::steady_clock::now() - startTime) / (double) passCount;
+    size_t walkerCount = 0;
+    startTime = std::chrono::steady_clock::now();
+    mx::TreeWalker treeWalker;
+    for (size_t pass = 0; pass < passCount; pass++)
+    {
+        for (mx::Element* elem = treeWalker.begin(doc.get()); elem; elem = treeWalker.next())
+        {
+            walkerCount++;
+        }
+    }
+    std::chrono::duration<double> treeWalkerTime = (std::chrono::steady_clock::now() - startTime) / (double) passCount;
+    REQUIRE(iteratorCount == walkerCount);
+    size_t elementCount = walkerCount / passCount;
+
+    // Create a deep graph, where each node reads from the node that precedes it.
+    const size_t nodeCount = 5000;
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph();
+    mx::NodePtr prevNode = nodeGraph->addNode("constant", "source", "float");
+    for (size_t i = 0; i < nodeCount; i++)
+    {
+        mx::NodePtr node = nodeGraph->addNode("add", "node" + std::to_string(i), "float");
+        node->setConnectedNode("in1", prevNode);
+        prevNode = node;
+    }
+    mx::OutputPtr output = nodeGraph->addOutput("out", "float");
+    output->setConnectedNode(prevNode);
+
+    // Traverse the graph upstream from its output.
+    iteratorCount = 0;
+    startTime = std::chrono::steady_clock::now();
+    for (mx::Edge edge : output->traverseGraph())
+    {
+        iteratorCount++;
+    }
+    std::chrono::duration<double> graphIteratorTime = std::chrono::steady_clock::now() - startTime;
+    walkerCount = 0;
+    startTime = std::chrono::steady_clock::now();
+    mx::GraphWalker graphWalker;
+    for (mx::Element* elem = graphWalker.begin(output.get()); elem; elem = graphWalker.next())
+    {
+        walkerCount++;
+    }
+    std::chrono::duration<double> graphWalkerTime = std::chrono::steady_clock::now() - startTime;
+    REQUIRE(iteratorCount == walkerCount);
+
+    std::cout << "Tree traversal of " << elementCount << " library elements: " <<
+        "iterator " << treeIteratorTime.count() * 1000.0 << " ms, walker " << treeWalkerTime.count() * 1000.0 << " ms" << std::endl;
+    std::cout << "Graph traversal of " << walkerCount << " edges: " <<
+        "iterator " << graphIteratorTime.count() * 1000.0 << " ms, walker " << graphWalkerTime.count() * 1000.0 << " ms" << std::endl;
+}
@@ -8,7 +8,9 @@
 #include <MaterialXCore/Types.h>
 #include <MaterialXCore/Value.h>
 
+#include <algorithm>
 #include <cmath>
+#include <vector>
 
 namespace mx = MaterialX;
 
@@ -123,3 +125,84 @@ TEST_CASE("Matrices", "[types]")
     REQUIRE((rotX * rotZ).isEquivalent(mx::Matrix44::createScale({-1, 1, -1}), EPSILON));
     REQUIRE((rotY * rotZ).isEquivalent(mx::Matrix44::createScale({1, -1, -1}), EPSILON));
 }
+
+TEST_CASE("Batch Transformations", "[types]")
+{
+    mx::Matrix44 matrix = mx::Matrix44::createScale(mx::Vector3(2, 3, 4)) *
+                          mx::Matrix44::createRotationY(PI / 3) *
+                          mx::Matrix44::createTranslation(mx::Vector3(1, 2, 3));
+    matrix[0][3] = 0.5f;
+
+    // Strided points and vectors with each supported component count.
+    const size_t count = 7;
+    for (size_t components = 1; components <= 4; components++)
+    {
+        const size_t stride = components + 1;
+        std::vector<float> points(count * stride);
+        for (size_t i = 0; i < points.size(); i++)
+        {
+            points[i] = (float) i * 0.25f - 1.0f;
+        }
+        std::vector<float> vectors = points;
+        std::vector<float> normals = points;
+        matrix.transformPoints(points.data(), count, components, stride);
+        matrix.transformVectors(vectors.data(), count, components, stride);
+        matrix.transformNormals(normals.data(), count, std::min(components, (size_t) 3), stride);
+
+        mx::Matrix44 normalMatrix = matrix.getInverse().getTranspose();
+        for (size_t i = 0; i < count; i++)
+        {
+            mx::Vector4 point(0, 0, 0, 1);
+            mx::Vector4 vector(0, 0, 0, 0);
+            for (size_t j = 0; j < components; j++)
+            {
+                point[j] = vector[j] = (float) (i * stride + j) * 0.25f - 1.0f;
+            }
+            mx::Vector4 normal = vector;
+            normal[3] = 0;
+            point = matrix.multiply(point);
+            vector = matrix.multiply(vector);
+            normal = normalMatrix.multiply(normal);
+            for (size_t j = 0; j < components; j++)
+            {
+                REQUIRE(std::abs(points[i * stride + j] - point[j]) < EPSILON);
+                REQUIRE(std::abs(vectors[i * stride + j] - vector[j]) < EPSILON);
+                if (j < 3)
+                {
+                    REQUIRE(std::abs(normals[i * stride + j] - normal[j]) < EPSILON);
+                }
+            }
+
+            // Padding between elements is left unmodified.
+            REQUIRE(points[i * stride + components] == (float) (i * stride + components) * 0.25f - 1.0f);
+        }
+    }
+    std::vector<float> data(8);
+    REQUIRE_THROWS_AS(matrix.transformPoints(data.data(), 1, 5), mx::Exception&);
+    REQUIRE_THROWS_AS(matrix.transformPoints(data.data(), 1, 3, 2), mx::Exception&);
+
+    // Points stored as separate coordinate arrays.
+    std::vector<float> x = { 1, 2, 3, 4, 5, 6 };
+    std::vector<float> y = { -1, 0, 1, 2, 3, 4 };
+    std::vector<float> z = { 0.5f, 1, 1.5f, 2, 2.5f, 3 };
+    std::vector<float> x0 = x, y0 = y, z0 = z;
+    matrix.transformPoints(x.data(), y.data(), z.data(), x.size());
+    for (size_t i = 0; i < x.size(); i++)
+    {
+        mx::Vector3 point = matrix.transformPoint(mx::Vector3(x0[i], y0[i], z0[i]));
+        REQUIRE((mx::Vector3(x[i], y[i], z[i]) - point).getMagnitude() < EPSILON);
+    }
+
+    // Matrix products, including products written in place.
+    std::vector<mx::Matrix44> lhs = { matrix, mx::Matrix44::IDENTITY, matrix.getInverse() };
+    std::vector<mx::Matrix44> rhs = { mx::Matrix44::createRotationX(PI / 5), matrix, matrix };
+    std::vector<mx::Matrix44> products(lhs.size());
+    mx::Matrix44::multiplyMatrices(lhs.data(), rhs.data(), products.data(), lhs.size());
+    for (size_t i = 0; i < lhs.size(); i++)
+    {
+        REQUIRE(products[i].isEquivalent(lhs[i] * rhs[i], EPSILON));
+    }
+    REQUIRE(products[2].isEquivalent(mx::Matrix44::IDENTITY, EPSILON));
+    mx::Matrix44::multiplyMatrices(lhs.data(), rhs.data(), lhs.data(), lhs.size());
+    REQUIRE(lhs == products);
+}
@@ -28,6 +28,20 @@ TEST_CASE("String utilities", "[util]")
 
     REQUIRE(mx::splitString("robot1, robot2", ", ") == (std::vector<std::string>{"robot1", "robot2"}));
     REQUIRE(mx::splitString("[one...two...three]", "[.]") == (std::vector<std::string>{"one", "two", "three"}));
+
+    mx::SubstringReplacer replacer;
+    REQUIRE(replacer.replace("<id>_<UDIM>.tif") == "<id>_<UDIM>.tif");
+    replacer.setSubstitution("<id>", "01");
+    replacer.setSubstitution("<UDIM>", "1001");
+    replacer.setSubstitution("<UDIM", "unused");
+    replacer.setSubstitution("", "ignored");
+    REQUIRE(replacer.replace("<id>_<UDIM>.tif") == "01_1001.tif");
+    REQUIRE(replacer.replace("<id><id>_<UDIM") == "0101_unused");
+    replacer.setSubstitution("<id>", "<UDIM>");
+    REQUIRE(replacer.replace("<id>_<UDIM>.tif") == "<UDIM>_1001.tif");
+    replacer.clear();
+    REQUIRE(replacer.empty());
+    REQUIRE(replacer.replace("<id>") == "<id>");
 }
 
 TEST_CASE("Print utilities", "[util]")
@@ -333,6 +333,9 @@ void Viewer::initializeDocument(mx::DocumentPtr libraries)
     copyOptions.skipDuplicateElements = true;
     _doc->importLibrary(libraries, &copyOptions);
 
+    // Index name paths, which are resolved per uniform by the property editor.
+    _doc->setNamePathIndexEnabled(true);
+
     // Add color management to generator
     mx::DefaultColorManagementSystemPtr cms = mx::DefaultColorManagementSystem::create(_genContext.getShaderGenerator().getLanguage());
     cms->loadLibrary(_doc);
@@ -446,9 +449,9 @@ void Viewer::createLoadMaterialsInterface(Widget* parent, const std::string labe
             {
                 updateMaterialSelections();
 
-                // Clear cached implementations in case libraries on the file
-				// system have changed.
-                _genContext.clearNodeImplementations();
+                // Clear cached implementations and any registries shared by
+                // the context, in case libraries on the file system have changed.
+                _genContext.clearSharedImplementations();
 
                 mx::MeshPtr mesh = _geometryHandler->getMeshes()[0];
                 for (size_t matIndex = 0; matIndex < _materials.size(); matIndex++)
@@ -78,7 +78,8 @@ void bindPyDocument(py::module& mod)
         .def("getImplementation", &mx::Document::getImplementation)
         .def("getImplementations", &mx::Document::getImplementations)
         .def("removeImplementation", &mx::Document::removeImplementation)
-        .def("upgradeVersion", &mx::Document::upgradeVersion)
+        .def("upgradeVersion", &mx::Document::upgradeVersion,
+            py::arg("threadCount") = 1)
         .def("setColorManagementSystem", &mx::Document::setColorManagementSystem)
         .def("hasColorManagementSystem", &mx::Document::hasColorManagementSystem)
         .def("getColorManagementSystem", &mx::Document::getColorManagementSystem)
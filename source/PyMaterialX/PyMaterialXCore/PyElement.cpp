@@ -77,7 +77,7 @@ void bindPyElement(py::module& mod)
         .def("setChildIndex", &mx::Element::setChildIndex)
         .def("getChildIndex", &mx::Element::getChildIndex)
         .def("removeChild", &mx::Element::removeChild)
-        .def("setAttribute", &mx::Element::setAttribute)
+        .def("setAttribute", static_cast<void (mx::Element::*)(const std::string&, const std::string&)>(&mx::Element::setAttribute))
         .def("hasAttribute", &mx::Element::hasAttribute)
         .def("getAttribute", &mx::Element::getAttribute)
         .def("getAttributeNames", &mx::Element::getAttributeNames)
@@ -15,7 +15,7 @@ void bindPyGenContext(py::module& mod)
 {
     py::class_<mx::GenContext, mx::GenContextPtr>(mod, "GenContext")
         .def(py::init<mx::ShaderGeneratorPtr>())
-        .def("getShaderGenerator", &mx::GenContext::getShaderGenerator)
+        .def("getShaderGenerator", static_cast<mx::ShaderGenerator& (mx::GenContext::*)()>(&mx::GenContext::getShaderGenerator), py::return_value_policy::reference)
         .def("getOptions", static_cast<mx::GenOptions& (mx::GenContext::*)()>(&mx::GenContext::getOptions), py::return_value_policy::reference)
         .def("registerSourceCodeSearchPath", static_cast<void (mx::GenContext::*)(const std::string&)>(&mx::GenContext::registerSourceCodeSearchPath))
         .def("registerSourceCodeSearchPath", static_cast<void (mx::GenContext::*)(const mx::FilePath&)>(&mx::GenContext::registerSourceCodeSearchPath))
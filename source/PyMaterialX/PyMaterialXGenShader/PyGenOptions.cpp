@@ -17,6 +17,12 @@ void bindPyGenOptions(py::module& mod)
         .value("SHADER_INTERFACE_REDUCED", mx::ShaderInterfaceType::SHADER_INTERFACE_REDUCED)
         .export_values();
 
+    py::enum_<mx::ShaderOptimizationLevel>(mod, "ShaderOptimizationLevel")
+        .value("SHADER_OPTIMIZATION_BASIC", mx::ShaderOptimizationLevel::SHADER_OPTIMIZATION_BASIC)
+        .value("SHADER_OPTIMIZATION_CONSTANT_FOLDING", mx::ShaderOptimizationLevel::SHADER_OPTIMIZATION_CONSTANT_FOLDING)
+        .value("SHADER_OPTIMIZATION_COMMON_SUBEXPRESSIONS", mx::ShaderOptimizationLevel::SHADER_OPTIMIZATION_COMMON_SUBEXPRESSIONS)
+        .export_values();
+
     py::enum_<mx::HwSpecularEnvironmentMethod>(mod, "HwSpecularEnvironmentMethod")
         .value("SPECULAR_ENVIRONMENT_PREFILTER", mx::HwSpecularEnvironmentMethod::SPECULAR_ENVIRONMENT_PREFILTER)
         .value("SPECULAR_ENVIRONMENT_FIS", mx::HwSpecularEnvironmentMethod::SPECULAR_ENVIRONMENT_FIS)
@@ -24,6 +30,9 @@ void bindPyGenOptions(py::module& mod)
 
     py::class_<mx::GenOptions>(mod, "GenOptions")
         .def_readwrite("shaderInterfaceType", &mx::GenOptions::shaderInterfaceType)
+        .def_readwrite("optimizationLevel", &mx::GenOptions::optimizationLevel)
+        .def_readwrite("specializeUniforms", &mx::GenOptions::specializeUniforms)
+        .def_readwrite("dynamicUniforms", &mx::GenOptions::dynamicUniforms)
         .def_readwrite("fileTextureVerticalFlip", &mx::GenOptions::fileTextureVerticalFlip)
         .def_readwrite("targetColorSpaceOverride", &mx::GenOptions::targetColorSpaceOverride)
         .def_readwrite("hwTransparency", &mx::GenOptions::hwTransparency)
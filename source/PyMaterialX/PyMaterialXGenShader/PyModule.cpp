@@ -9,6 +9,7 @@ namespace py = pybind11;
 
 void bindPyColorManagement(py::module& mod);
 void bindPyShaderPort(py::module& mod);
+void bindPySourceFileCache(py::module& mod);
 void bindPyShader(py::module& mod);
 void bindPyShaderGenerator(py::module& mod);
 void bindPyGenContext(py::module& mod);
@@ -23,6 +24,7 @@ PYBIND11_MODULE(PyMaterialXGenShader, mod)
 
     bindPyColorManagement(mod);
     bindPyShaderPort(mod);
+    bindPySourceFileCache(mod);
     bindPyShader(mod);
     bindPyShaderGenerator(mod);
     bindPyGenContext(mod);
@@ -8,6 +8,7 @@
 #include <MaterialXGenShader/Shader.h>
 #include <MaterialXGenShader/ShaderGenerator.h>
 #include <MaterialXGenShader/GenContext.h>
+#include <MaterialXGenShader/SourceFileCache.h>
 
 #include <string>
 
@@ -164,6 +165,18 @@ class PyShaderGenerator : public mx::ShaderGenerator
         );
     }
 
+    void emitSourceFile(const mx::SourceFile& file, mx::GenContext& context, mx::ShaderStage& stage) const override
+    {
+        PYBIND11_OVERLOAD(
+            void,
+            mx::ShaderGenerator,
+            emitSourceFile,
+            file,
+            context,
+            stage
+        );
+    }
+
     void emitFunctionDefinition(const mx::ShaderNode& node, mx::GenContext& context, mx::ShaderStage& stage) const override
     {
         PYBIND11_OVERLOAD(
@@ -0,0 +1,27 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <PyMaterialX/PyMaterialX.h>
+
+#include <MaterialXGenShader/SourceFileCache.h>
+
+namespace py = pybind11;
+namespace mx = MaterialX;
+
+void bindPySourceFileCache(py::module& mod)
+{
+    py::class_<mx::SourceFile, mx::SourceFilePtr>(mod, "SourceFile")
+        .def_static("create", &mx::SourceFile::create)
+        .def("getPath", &mx::SourceFile::getPath)
+        .def("getContents", &mx::SourceFile::getContents)
+        .def("getIncludes", &mx::SourceFile::getIncludes);
+
+    py::class_<mx::SourceFileCache>(mod, "SourceFileCache")
+        .def_static("getInstance", &mx::SourceFileCache::getInstance, py::return_value_policy::reference)
+        .def("getFile", &mx::SourceFileCache::getFile)
+        .def("clear", &mx::SourceFileCache::clear)
+        .def("getLookupCount", &mx::SourceFileCache::getLookupCount)
+        .def("getReadCount", &mx::SourceFileCache::getReadCount);
+}